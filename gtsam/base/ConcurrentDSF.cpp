@@ -0,0 +1,74 @@
+/* ----------------------------------------------------------------------------
+
+ * GTSAM Copyright 2010, Georgia Tech Research Corporation,
+ * Atlanta, Georgia 30332-0415
+ * All Rights Reserved
+ * Authors: Frank Dellaert, et al. (see THANKS for the full author list)
+
+ * See LICENSE for the license information
+
+ * -------------------------------------------------------------------------- */
+
+/**
+ * @file ConcurrentDSF.cpp
+ * @date October 2026
+ * @brief Lock-free disjoint set forest over dense size_t keys.
+ */
+
+#include <gtsam/base/ConcurrentDSF.h>
+
+#include <utility>
+
+namespace gtsam {
+
+/* ************************************************************************* */
+ConcurrentDSF::ConcurrentDSF(size_t numNodes) : v_(new V(numNodes)) {
+  for (size_t i = 0; i < numNodes; i++)
+    (*v_)[i].store(i, std::memory_order_relaxed);
+}
+
+/* ************************************************************************* */
+size_t ConcurrentDSF::find(size_t key) const {
+  V& v = *v_;
+  size_t parent = v[key].load(std::memory_order_acquire);
+  while (parent != key) {
+    // Path halving: point key to its grandparent. Losing the race is fine,
+    // another thread then already shortened the path.
+    const size_t grandParent = v[parent].load(std::memory_order_acquire);
+    if (grandParent != parent)
+      v[key].compare_exchange_weak(parent, grandParent,
+                                   std::memory_order_acq_rel);
+    key = parent;
+    parent = v[key].load(std::memory_order_acquire);
+  }
+  return key;
+}
+
+/* ************************************************************************* */
+void ConcurrentDSF::merge(size_t i1, size_t i2) {
+  V& v = *v_;
+  while (true) {
+    i1 = find(i1);
+    i2 = find(i2);
+    if (i1 == i2) return;
+    // Link the larger root below the smaller one.
+    if (i1 < i2) std::swap(i1, i2);
+    size_t expected = i1;
+    if (v[i1].compare_exchange_strong(expected, i2, std::memory_order_acq_rel))
+      return;
+    // i1 was linked by another thread in the meantime, try again.
+  }
+}
+
+/* ************************************************************************* */
+bool ConcurrentDSF::sameSet(size_t i1, size_t i2) const {
+  while (true) {
+    i1 = find(i1);
+    i2 = find(i2);
+    if (i1 == i2) return true;
+    // i1 is still a root, so the sets really are distinct right now.
+    if ((*v_)[i1].load(std::memory_order_acquire) == i1) return false;
+  }
+}
+
+}  // namespace gtsam
@@ -0,0 +1,64 @@
+/* ----------------------------------------------------------------------------
+
+ * GTSAM Copyright 2010, Georgia Tech Research Corporation,
+ * Atlanta, Georgia 30332-0415
+ * All Rights Reserved
+ * Authors: Frank Dellaert, et al. (see THANKS for the full author list)
+
+ * See LICENSE for the license information
+
+ * -------------------------------------------------------------------------- */
+
+/**
+ * @file ConcurrentDSF.h
+ * @date October 2026
+ * @brief Lock-free disjoint set forest over dense size_t keys.
+ */
+
+#pragma once
+
+#include <gtsam/dllexport.h>
+#include <gtsam/global_includes.h>
+
+#include <atomic>
+#include <memory>
+#include <vector>
+
+namespace gtsam {
+
+/**
+ * A disjoint set forest over keys 0...numNodes-1 that can be merged and
+ * queried from many threads at once without locks.
+ *
+ * Parent pointers are atomics updated with compare-and-swap. Merging always
+ * links the larger root below the smaller one, so once all merges are done
+ * the label of every set is its smallest key, independent of the order in
+ * which merges were performed. find() does path halving.
+ * @ingroup base
+ */
+class GTSAM_EXPORT ConcurrentDSF {
+ public:
+  typedef std::vector<std::atomic<size_t>> V;  ///< Vector of atomic parents
+
+ private:
+  std::unique_ptr<V> v_;  ///< Parent pointers, representative iff v[i]==i
+
+ public:
+  /// Constructor that allocates new memory, allows for keys 0...numNodes-1.
+  explicit ConcurrentDSF(size_t numNodes);
+
+  /// Number of keys in the forest.
+  size_t size() const { return v_->size(); }
+
+  /// Find the label of the set in which {key} lives. Safe to call
+  /// concurrently with merge().
+  size_t find(size_t key) const;
+
+  /// Merge the sets containing i1 and i2. Safe to call concurrently.
+  void merge(size_t i1, size_t i2);
+
+  /// Return true if i1 and i2 are currently in the same set.
+  bool sameSet(size_t i1, size_t i2) const;
+};
+
+}  // namespace gtsam
@@ -19,13 +19,18 @@
 
 #pragma once
 
-#include <gtsam/base/DSFMap.h>
 #include <gtsam/base/FastMap.h>
 #include <gtsam/base/types.h>
-#include <gtsam/inference/VariableIndex.h>
+#include <gtsam/inference/FactorGraph.h>
+
+#ifdef GTSAM_USE_TBB
+#include <tbb/blocked_range.h>
+#include <tbb/parallel_for.h>
+#endif
 
 #include <algorithm>
 #include <numeric>
+#include <stdexcept>
 #include <vector>
 
 namespace gtsam::utils {
@@ -50,6 +55,117 @@ inline std::vector<size_t> sortedIndices(const std::vector<double> &weights) {
   return indices;
 }
 
+namespace internal {
+
+/// A binary factor seen as an edge between two dense vertex ids.
+struct KruskalEdge {
+  double weight;
+  size_t index;  ///< index of the factor in the graph
+  size_t u, v;
+
+  /// Order by weight, ties broken by factor index as a stable sort would.
+  bool operator<(const KruskalEdge &other) const {
+    return weight < other.weight ||
+           (weight == other.weight && index < other.index);
+  }
+};
+
+/**
+ * Union-find forest with union by rank. find() does not compress paths, so it
+ * is read-only and can be called concurrently while filtering edges; the rank
+ * heuristic alone keeps the trees logarithmically shallow.
+ */
+class KruskalForest {
+  std::vector<size_t> parent_;
+  std::vector<unsigned char> rank_;
+
+ public:
+  explicit KruskalForest(size_t n) : parent_(n), rank_(n, 0) {
+    std::iota(parent_.begin(), parent_.end(), 0);
+  }
+
+  size_t find(size_t i) const {
+    while (parent_[i] != i) i = parent_[i];
+    return i;
+  }
+
+  /// Merge the sets containing i and j, return false if they were the same.
+  bool merge(size_t i, size_t j) {
+    i = find(i);
+    j = find(j);
+    if (i == j) return false;
+    if (rank_[i] < rank_[j]) std::swap(i, j);
+    parent_[j] = i;
+    if (rank_[i] == rank_[j]) ++rank_[i];
+    return true;
+  }
+};
+
+/// Below this many edges, sort and scan as in textbook Kruskal.
+static constexpr size_t kKruskalBaseCase = 1024;
+
+/// Filter edges in parallel only above this many, to amortize task overhead.
+static constexpr size_t kKruskalParallelFilter = 8192;
+
+/// Move the edges that still connect two components to the front of the
+/// range, and return the end of those.
+inline std::vector<KruskalEdge>::iterator filterEdges(
+    std::vector<KruskalEdge>::iterator begin,
+    std::vector<KruskalEdge>::iterator end, const KruskalForest &forest) {
+  const auto connects = [&forest](const KruskalEdge &e) {
+    return forest.find(e.u) != forest.find(e.v);
+  };
+#ifdef GTSAM_USE_TBB
+  const size_t m = end - begin;
+  if (m >= kKruskalParallelFilter) {
+    std::vector<unsigned char> keep(m);
+    tbb::parallel_for(tbb::blocked_range<size_t>(0, m, 1024),
+                      [&](const tbb::blocked_range<size_t> &range) {
+                        for (size_t i = range.begin(); i != range.end(); ++i)
+                          keep[i] = connects(begin[i]);
+                      });
+    auto out = begin;
+    for (size_t i = 0; i < m; ++i)
+      if (keep[i]) *out++ = begin[i];
+    return out;
+  }
+#endif
+  return std::partition(begin, end, connects);
+}
+
+/**
+ * Filter-Kruskal (Osipov, Sanders and Singler, 2009): split the edges around
+ * the median, recurse on the lighter half, then drop the heavier edges that
+ * already lie within one component before recursing on those. Edges are
+ * accepted in exactly the order plain Kruskal would accept them.
+ */
+inline void filterKruskal(std::vector<KruskalEdge>::iterator begin,
+                          std::vector<KruskalEdge>::iterator end,
+                          KruskalForest *forest, size_t numTreeEdges,
+                          std::vector<size_t> *treeIndices) {
+  if (begin == end || treeIndices->size() == numTreeEdges) return;
+
+  if (static_cast<size_t>(end - begin) <= kKruskalBaseCase) {
+    std::sort(begin, end);
+    for (auto it = begin; it != end; ++it) {
+      if (forest->merge(it->u, it->v)) {
+        treeIndices->push_back(it->index);
+        if (treeIndices->size() == numTreeEdges) return;
+      }
+    }
+    return;
+  }
+
+  const auto middle = begin + (end - begin) / 2;
+  std::nth_element(begin, middle, end);
+  filterKruskal(begin, middle, forest, numTreeEdges, treeIndices);
+  if (treeIndices->size() == numTreeEdges) return;
+  const auto heavyEnd = filterEdges(middle, end, *forest);
+  filterKruskal(middle, heavyEnd, forest, numTreeEdges, treeIndices);
+}
+
+}  // namespace internal
+
 /****************************************************************/
 template <class FACTOR>
 std::vector<size_t> kruskal(const FactorGraph<FACTOR> &fg,
@@ -60,46 +176,30 @@ std::vector<size_t> kruskal(const FactorGraph<FACTOR> &fg,
         "assigned a weight");
   }
 
-  // Create an index from variables to factor indices.
-  const VariableIndex variableIndex(fg);
-
-  // Get indices in sort-order of the weights.
-  const std::vector<size_t> sortedIndices =
-      gtsam::utils::sortedIndices(weights);
+  // Collect the binary factors as edges between dense vertex ids.
+  FastMap<Key, size_t> vertices;
+  const auto vertex = [&vertices](Key key) {
+    return vertices.emplace(key, vertices.size()).first->second;
+  };
+  std::vector<internal::KruskalEdge> edges;
+  edges.reserve(fg.size());
+  for (size_t index = 0; index < fg.size(); ++index) {
+    const auto &factor = fg[index];
+    // Ignore non-binary edges.
+    if (!factor || factor->size() != 2) continue;
+    const size_t u = vertex(factor->front()), v = vertex(factor->back());
+    edges.push_back({weights[index], index, u, v});
+  }
 
-  // Create a vector to hold MST indices.
-  const size_t n = variableIndex.size();
+  // A spanning tree has one edge less than there are vertices.
+  const size_t n = vertices.size();
   std::vector<size_t> treeIndices;
+  if (n == 0) return treeIndices;
   treeIndices.reserve(n - 1);
 
-  // Initialize disjoint-set forest to keep track of merged Keys.
-  DSFMap<Key> dsf;
-
-  // Loop over all edges in order of increasing weight.
-  size_t count = 0;
-  for (const size_t index : sortedIndices) {
-    const auto factor = fg[index];
-
-    // Ignore non-binary edges.
-    if (factor->size() != 2) continue;
-
-    // Find the representatives of the sets for both the Keys in the binary
-    // factor.
-    const auto u = dsf.find(factor->front()), v = dsf.find(factor->back());
-
-    // Check if there is a potential loop.
-    const bool loop = (u == v);
-    if (!loop) {
-      // Merge the sets.
-      dsf.merge(u, v);
-
-      // Add the current index to the tree.
-      treeIndices.push_back(index);
-
-      // Break if all the Keys have been added to the tree.
-      if (++count == n - 1) break;
-    }
-  }
+  internal::KruskalForest forest(n);
+  internal::filterKruskal(edges.begin(), edges.end(), &forest, n - 1,
+                          &treeIndices);
   return treeIndices;
 }
 
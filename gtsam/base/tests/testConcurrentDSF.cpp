@@ -0,0 +1,68 @@
+/* ----------------------------------------------------------------------------
+
+ * GTSAM Copyright 2010, Georgia Tech Research Corporation,
+ * Atlanta, Georgia 30332-0415
+ * All Rights Reserved
+ * Authors: Frank Dellaert, et al. (see THANKS for the full author list)
+
+ * See LICENSE for the license information
+
+ * -------------------------------------------------------------------------- */
+
+/**
+ * @file testConcurrentDSF.cpp
+ * @date October 2026
+ * @brief unit tests for the lock-free DSF
+ */
+
+#include <gtsam/base/ConcurrentDSF.h>
+
+#include <CppUnitLite/TestHarness.h>
+
+#include <thread>
+#include <vector>
+
+using namespace gtsam;
+
+/* ************************************************************************* */
+TEST(ConcurrentDSF, find) {
+  ConcurrentDSF dsf(3);
+  EXPECT(dsf.find(0) != dsf.find(2));
+  EXPECT(!dsf.sameSet(0, 2));
+}
+
+/* ************************************************************************* */
+TEST(ConcurrentDSF, merge) {
+  ConcurrentDSF dsf(4);
+  dsf.merge(3, 1);
+  dsf.merge(2, 3);
+  EXPECT(dsf.sameSet(1, 2));
+  EXPECT(!dsf.sameSet(0, 2));
+  // Sets are labeled with their smallest key
+  LONGS_EQUAL(1, dsf.find(3));
+  LONGS_EQUAL(1, dsf.find(2));
+  LONGS_EQUAL(0, dsf.find(0));
+}
+
+/* ************************************************************************* */
+TEST(ConcurrentDSF, threads) {
+  // Merge odd and even keys into two sets from several threads.
+  const size_t n = 10000, numThreads = 4;
+  ConcurrentDSF dsf(n);
+  std::vector<std::thread> threads;
+  for (size_t t = 0; t < numThreads; t++) {
+    threads.emplace_back([&dsf, t, n, numThreads]() {
+      for (size_t i = t; i + 2 < n; i += numThreads) dsf.merge(i + 2, i);
+    });
+  }
+  for (auto& thread : threads) thread.join();
+
+  for (size_t i = 0; i < n; i++) LONGS_EQUAL(i % 2, dsf.find(i));
+}
+
+/* ************************************************************************* */
+int main() {
+  TestResult tr;
+  return TestRegistry::runAllTests(tr);
+}
+/* ************************************************************************* */
@@ -16,6 +16,7 @@
  */
 
 #include <CppUnitLite/TestHarness.h>
+#include <gtsam/base/DSFMap.h>
 #include <gtsam/base/TestableAssertions.h>
 #include <gtsam/base/kruskal.h>
 #include <gtsam/geometry/Rot3.h>
@@ -97,6 +98,46 @@ TEST(kruskal, NonlinearFactorGraph) {
   EXPECT(mstEdgeIndices[2] == 2);
 }
 
+/* ************************************************************************* */
+TEST(kruskal, LargeGraph) {
+  using namespace gtsam;
+  using namespace symbol_shorthand;
+
+  // A 70x70 grid with diagonals, large enough to split and filter edges, with
+  // few distinct weights so that ties have to be broken by factor index.
+  const size_t N = 70;
+  GaussianFactorGraph g;
+  std::vector<double> weights;
+  const Vector1 b(0);
+  const auto add = [&](size_t i, size_t j) {
+    g.emplace_shared<JacobianFactor>(X(i), I_1x1, X(j), I_1x1, b);
+    weights.push_back(static_cast<double>((7 * i + 13 * j) % 5));
+  };
+  for (size_t r = 0; r < N; ++r) {
+    for (size_t c = 0; c < N; ++c) {
+      const size_t i = r * N + c;
+      if (c + 1 < N) add(i, i + 1);
+      if (r + 1 < N) add(i, i + N);
+      if (r + 1 < N && c + 1 < N) add(i, i + N + 1);
+    }
+  }
+
+  // Textbook Kruskal as reference.
+  std::vector<size_t> expected;
+  DSFMap<Key> dsf;
+  for (const size_t index : utils::sortedIndices(weights)) {
+    const Key u = dsf.find(g[index]->front()), v = dsf.find(g[index]->back());
+    if (u != v) {
+      dsf.merge(u, v);
+      expected.push_back(index);
+    }
+  }
+
+  const auto actual = utils::kruskal(g, weights);
+  EXPECT_LONGS_EQUAL(N * N - 1, actual.size());
+  EXPECT(expected == actual);
+}
+
 /* ************************************************************************* */
 int main() {
   TestResult tr;
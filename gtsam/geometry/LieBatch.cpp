@@ -0,0 +1,215 @@
+/* ----------------------------------------------------------------------------
+
+ * GTSAM Copyright 2010, Georgia Tech Research Corporation,
+ * Atlanta, Georgia 30332-0415
+ * All Rights Reserved
+ * Authors: Frank Dellaert, et al. (see THANKS for the full author list)
+
+ * See LICENSE for the license information
+
+ * -------------------------------------------------------------------------- */
+
+/**
+ * @file    LieBatch.cpp
+ * @brief   SO(3) and SE(3) operations on many rotations and poses at once
+ * @date    October 2026
+ */
+
+#include <gtsam/geometry/LieBatch.h>
+#include <gtsam/geometry/SO3.h>
+
+namespace gtsam {
+namespace batch {
+
+namespace {
+
+typedef Eigen::ArrayXd Array;
+
+// Below this squared angle the closed forms lose precision, and truncated
+// Taylor series are accurate to machine precision instead
+constexpr double kSmallAngle2 = 1e-4;
+
+// Coefficients of the Rodrigues formula R = I + A W + B W^2 and of the left
+// Jacobian I + B W + D W^2, where W = omega^ and theta = |omega|
+struct ExpmapCoefficients {
+  Array A;  // sin(theta) / theta
+  Array B;  // (1 - cos(theta)) / theta^2
+  Array D;  // (theta - sin(theta)) / theta^3
+
+  explicit ExpmapCoefficients(const Array& theta2) {
+    const auto small = theta2 < kSmallAngle2;
+    const Array theta = small.select(1.0, theta2).sqrt();
+    const Array sinTheta = theta.sin();
+    const Array sinHalf = (0.5 * theta).sin();
+    // numerically better than [1 - cos(theta)]
+    const Array oneMinusCos = 2.0 * sinHalf.square();
+    A = small.select(1.0 - theta2 / 6.0 * (1.0 - theta2 / 20.0),
+                     sinTheta / theta);
+    B = small.select(0.5 - theta2 / 24.0 * (1.0 - theta2 / 30.0),
+                     oneMinusCos / theta.square());
+    D = small.select(1.0 / 6.0 - theta2 / 120.0 * (1.0 - theta2 / 42.0),
+                     (theta - sinTheta) / theta.cube());
+  }
+};
+
+// Coefficient E of the inverse Jacobians I -+ W / 2 + E W^2, which is
+// 1 / theta^2 - (1 + cos(theta)) / (2 theta sin(theta))
+Array LogmapCoefficient(const Array& theta2) {
+  const auto small = theta2 < kSmallAngle2;
+  const Array theta = small.select(1.0, theta2).sqrt();
+  const Array sinHalf = (0.5 * theta).sin();
+  // (1 + cos) / sin = sin / (1 - cos) stays finite up to theta = pi
+  return small.select(
+      1.0 / 12.0 + theta2 * (1.0 / 720.0 + theta2 / 30240.0),
+      1.0 / theta.square() -
+          theta.sin() / (4.0 * theta * sinHalf.square()));
+}
+
+// Set M = I + a W + b W^2, using W^2 = omega omega' - theta^2 I
+void SetPolynomial(const Array& wx, const Array& wy, const Array& wz,
+                   const Array& theta2, const Array& a, const Array& b,
+                   Matrices3* M) {
+  M->resize(wx.size(), 9);
+  auto m = [M](int r, int c) { return M->col(r + 3 * c).array(); };
+  const Array diagonal = 1.0 - b * theta2;
+  m(0, 0) = diagonal + b * wx * wx;
+  m(1, 1) = diagonal + b * wy * wy;
+  m(2, 2) = diagonal + b * wz * wz;
+  const Array bxy = b * wx * wy, bxz = b * wx * wz, byz = b * wy * wz;
+  m(0, 1) = bxy - a * wz;
+  m(1, 0) = bxy + a * wz;
+  m(0, 2) = bxz + a * wy;
+  m(2, 0) = bxz - a * wy;
+  m(1, 2) = byz - a * wx;
+  m(2, 1) = byz + a * wx;
+}
+
+// Set the rows of v to R * v
+void Rotate(const Matrices3& R, const Array& vx, const Array& vy,
+            const Array& vz, Vectors3* v) {
+  v->resize(vx.size(), 3);
+  for (int r = 0; r < 3; ++r)
+    v->col(r).array() = R.col(r).array() * vx + R.col(r + 3).array() * vy +
+                        R.col(r + 6).array() * vz;
+}
+
+}  // namespace
+
+/* ************************************************************************* */
+void ExpmapSO3(const Vectors3& omega, Matrices3* R, Matrices3* H) {
+  const Array wx = omega.col(0), wy = omega.col(1), wz = omega.col(2);
+  const Array theta2 = wx.square() + wy.square() + wz.square();
+  const ExpmapCoefficients c(theta2);
+  SetPolynomial(wx, wy, wz, theta2, c.A, c.B, R);
+  if (H) SetPolynomial(wx, wy, wz, theta2, -c.B, c.D, H);
+}
+
+/* ************************************************************************* */
+void LogmapSO3(const Matrices3& R, Vectors3* omega, Matrices3* H) {
+  const Eigen::Index n = R.rows();
+  auto r = [&R](int i, int j) { return R.col(i + 3 * j).array(); };
+
+  // Same branches as SO3::Logmap, see there
+  const Array trace = r(0, 0) + r(1, 1) + r(2, 2);
+  const Array trace_3 = trace - 3.0;
+  const auto nearZero = trace_3 >= -1e-6;
+  const Array theta = nearZero.select(
+      1.0, (0.5 * (trace - 1.0)).max(-1.0).min(1.0).acos());
+  const Array magnitude =
+      nearZero.select(0.5 - trace_3 / 12.0 + trace_3.square() / 60.0,
+                      theta / (2.0 * theta.sin()));
+  omega->resize(n, 3);
+  omega->col(0).array() = magnitude * (r(2, 1) - r(1, 2));
+  omega->col(1).array() = magnitude * (r(0, 2) - r(2, 0));
+  omega->col(2).array() = magnitude * (r(1, 0) - r(0, 1));
+
+  // Rotations by nearly pi are rare and need the careful scalar treatment
+  for (Eigen::Index i = 0; i < n; ++i)
+    if (trace(i) + 1.0 < 1e-3)
+      omega->row(i) = SO3::Logmap(SO3(GetMatrix3(R, i))).transpose();
+
+  if (H) {
+    const Array wx = omega->col(0), wy = omega->col(1), wz = omega->col(2);
+    const Array theta2 = wx.square() + wy.square() + wz.square();
+    SetPolynomial(wx, wy, wz, theta2, Array::Constant(n, 0.5),
+                  LogmapCoefficient(theta2), H);
+  }
+}
+
+/* ************************************************************************* */
+void ComposeSO3(const Matrices3& R1, const Matrices3& R2, Matrices3* R) {
+  R->resize(R1.rows(), 9);
+  for (int c = 0; c < 3; ++c)
+    for (int r = 0; r < 3; ++r)
+      R->col(r + 3 * c).array() =
+          R1.col(r).array() * R2.col(3 * c).array() +
+          R1.col(r + 3).array() * R2.col(3 * c + 1).array() +
+          R1.col(r + 6).array() * R2.col(3 * c + 2).array();
+}
+
+/* ************************************************************************* */
+void ExpmapPose3(const Vectors6& xi, Matrices3* R, Vectors3* t) {
+  const Array wx = xi.col(0), wy = xi.col(1), wz = xi.col(2);
+  const Array vx = xi.col(3), vy = xi.col(4), vz = xi.col(5);
+  const Array theta2 = wx.square() + wy.square() + wz.square();
+  const ExpmapCoefficients c(theta2);
+  SetPolynomial(wx, wy, wz, theta2, c.A, c.B, R);
+
+  // t = v + B omega x v + D omega x (omega x v), the left Jacobian times v
+  const Array cx = wy * vz - wz * vy, cy = wz * vx - wx * vz,
+              cz = wx * vy - wy * vx;
+  t->resize(xi.rows(), 3);
+  t->col(0).array() = vx + c.B * cx + c.D * (wy * cz - wz * cy);
+  t->col(1).array() = vy + c.B * cy + c.D * (wz * cx - wx * cz);
+  t->col(2).array() = vz + c.B * cz + c.D * (wx * cy - wy * cx);
+}
+
+/* ************************************************************************* */
+void LogmapPose3(const Matrices3& R, const Vectors3& t, Vectors6* xi) {
+  Vectors3 omega;
+  LogmapSO3(R, &omega);
+  const Array wx = omega.col(0), wy = omega.col(1), wz = omega.col(2);
+  const Array tx = t.col(0), ty = t.col(1), tz = t.col(2);
+  const Array E = LogmapCoefficient(wx.square() + wy.square() + wz.square());
+
+  // u = t - omega x t / 2 + E omega x (omega x t), the inverse left Jacobian
+  const Array cx = wy * tz - wz * ty, cy = wz * tx - wx * tz,
+              cz = wx * ty - wy * tx;
+  xi->resize(R.rows(), 6);
+  xi->leftCols<3>() = omega;
+  xi->col(3).array() = tx - 0.5 * cx + E * (wy * cz - wz * cy);
+  xi->col(4).array() = ty - 0.5 * cy + E * (wz * cx - wx * cz);
+  xi->col(5).array() = tz - 0.5 * cz + E * (wx * cy - wy * cx);
+}
+
+/* ************************************************************************* */
+void ComposePose3(const Matrices3& R1, const Vectors3& t1, const Matrices3& R2,
+                  const Vectors3& t2, Matrices3* R, Vectors3* t) {
+  ComposeSO3(R1, R2, R);
+  Rotate(R1, t2.col(0), t2.col(1), t2.col(2), t);
+  *t += t1;
+}
+
+/* ************************************************************************* */
+void TransformFrom(const Matrices3& R, const Vectors3& t, const Vectors3& p,
+                   Vectors3* q, Matrices36* Hpose, Matrices3* Hpoint) {
+  const Array px = p.col(0), py = p.col(1), pz = p.col(2);
+  Rotate(R, px, py, pz, q);
+  *q += t;
+
+  if (Hpose) {
+    // [-R p^, R], column by column
+    Hpose->resize(p.rows(), 18);
+    auto r = [&R](int i, int j) { return R.col(i + 3 * j).array(); };
+    for (int i = 0; i < 3; ++i) {
+      Hpose->col(i).array() = r(i, 2) * py - r(i, 1) * pz;
+      Hpose->col(i + 3).array() = r(i, 0) * pz - r(i, 2) * px;
+      Hpose->col(i + 6).array() = r(i, 1) * px - r(i, 0) * py;
+    }
+    Hpose->rightCols<9>() = R;
+  }
+  if (Hpoint) *Hpoint = R;
+}
+
+}  // namespace batch
+}  // namespace gtsam
@@ -0,0 +1,112 @@
+/* ----------------------------------------------------------------------------
+
+ * GTSAM Copyright 2010, Georgia Tech Research Corporation,
+ * Atlanta, Georgia 30332-0415
+ * All Rights Reserved
+ * Authors: Frank Dellaert, et al. (see THANKS for the full author list)
+
+ * See LICENSE for the license information
+
+ * -------------------------------------------------------------------------- */
+
+/**
+ * @file    LieBatch.h
+ * @brief   SO(3) and SE(3) operations on many rotations and poses at once
+ * @date    October 2026
+ */
+
+#pragma once
+
+#include <gtsam/base/Matrix.h>
+#include <gtsam/dllexport.h>
+
+namespace gtsam {
+
+/**
+ * Batched versions of the SO(3) and SE(3) exponential and logarithm maps,
+ * composition and point transformation.
+ *
+ * Arguments are "structure of arrays": a batch of N objects is a matrix with
+ * N rows, and because Eigen stores matrices column-major every component of
+ * the N objects is contiguous in memory. The kernels are written as Eigen
+ * array expressions over these columns, so they run in SIMD registers with
+ * whatever instruction set GTSAM is compiled for (see
+ * GTSAM_BUILD_WITH_MARCH_NATIVE), while the scalar functions in Rot3, SO3 and
+ * Pose3 operate on one object at a time.
+ *
+ * Results agree with the scalar functions up to round-off, and the Jacobians
+ * use the same conventions, e.g., ExpmapSO3 and SO3::ExpmapDerivative.
+ * Twists are ordered as in Pose3, rotation first.
+ */
+namespace batch {
+
+/// N 3-vectors, one per row
+typedef Eigen::Matrix<double, Eigen::Dynamic, 3> Vectors3;
+
+/// N 6-vectors, one per row
+typedef Eigen::Matrix<double, Eigen::Dynamic, 6> Vectors6;
+
+/// N 3*3 matrices, row i holds the entries of matrix i in column-major order
+typedef Eigen::Matrix<double, Eigen::Dynamic, 9> Matrices3;
+
+/// N 3*6 matrices, row i holds the entries of matrix i in column-major order
+typedef Eigen::Matrix<double, Eigen::Dynamic, 18> Matrices36;
+
+/// Matrix i of a batch
+inline Matrix3 GetMatrix3(const Matrices3& M, Eigen::Index i) {
+  Matrix3 R;
+  Eigen::Map<Eigen::Matrix<double, 1, 9> >(R.data()) = M.row(i);
+  return R;
+}
+
+/// Set matrix i of a batch
+inline void SetMatrix3(Matrices3* M, Eigen::Index i, const Matrix3& R) {
+  M->row(i) = Eigen::Map<const Eigen::Matrix<double, 1, 9> >(R.data());
+}
+
+/**
+ * Exponential map of the rotation vectors \c omega, as SO3::Expmap
+ * @param R rotation matrices, resized to the number of rows of omega
+ * @param H optional derivatives, as SO3::ExpmapDerivative
+ */
+GTSAM_EXPORT void ExpmapSO3(const Vectors3& omega, Matrices3* R,
+                            Matrices3* H = nullptr);
+
+/**
+ * Logarithm map of the rotation matrices \c R, as SO3::Logmap
+ * @param omega rotation vectors, resized to the number of rows of R
+ * @param H optional derivatives, as SO3::LogmapDerivative
+ */
+GTSAM_EXPORT void LogmapSO3(const Matrices3& R, Vectors3* omega,
+                            Matrices3* H = nullptr);
+
+/// Products R1 * R2 of the rotations, R may alias neither R1 nor R2
+GTSAM_EXPORT void ComposeSO3(const Matrices3& R1, const Matrices3& R2,
+                             Matrices3* R);
+
+/// Exponential map of the twists \c xi, as Pose3::Expmap
+GTSAM_EXPORT void ExpmapPose3(const Vectors6& xi, Matrices3* R, Vectors3* t);
+
+/// Logarithm map of the poses (R, t), as Pose3::Logmap
+GTSAM_EXPORT void LogmapPose3(const Matrices3& R, const Vectors3& t,
+                              Vectors6* xi);
+
+/// Products (R1, t1) * (R2, t2) of the poses, outputs may not alias inputs
+GTSAM_EXPORT void ComposePose3(const Matrices3& R1, const Vectors3& t1,
+                               const Matrices3& R2, const Vectors3& t2,
+                               Matrices3* R, Vectors3* t);
+
+/**
+ * Transform the points \c p from the frames of the poses (R, t) to the world
+ * frame, as Pose3::transformFrom
+ * @param q transformed points, resized to the number of rows of p
+ * @param Hpose optional derivatives with respect to the poses
+ * @param Hpoint optional derivatives with respect to the points
+ */
+GTSAM_EXPORT void TransformFrom(const Matrices3& R, const Vectors3& t,
+                                const Vectors3& p, Vectors3* q,
+                                Matrices36* Hpose = nullptr,
+                                Matrices3* Hpoint = nullptr);
+
+}  // namespace batch
+}  // namespace gtsam
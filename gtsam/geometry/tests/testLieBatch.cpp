@@ -0,0 +1,135 @@
+/* ----------------------------------------------------------------------------
+
+ * GTSAM Copyright 2010, Georgia Tech Research Corporation,
+ * Atlanta, Georgia 30332-0415
+ * All Rights Reserved
+ * Authors: Frank Dellaert, et al. (see THANKS for the full author list)
+
+ * See LICENSE for the license information
+
+ * -------------------------------------------------------------------------- */
+
+/**
+ * @file   testLieBatch.cpp
+ * @brief  Unit tests for the batched SO(3) and SE(3) kernels
+ */
+
+#include <CppUnitLite/TestHarness.h>
+#include <gtsam/base/TestableAssertions.h>
+#include <gtsam/geometry/LieBatch.h>
+#include <gtsam/geometry/Pose3.h>
+
+#include <cmath>
+#include <vector>
+
+using namespace std;
+using namespace gtsam;
+
+namespace {
+
+// Twists with small, generic and nearly pi rotation angles
+vector<Vector6> twists() {
+  vector<Vector6> result;
+  const Vector3 axis = Vector3(0.3, -0.5, 0.8).normalized();
+  for (double angle : {0.0, 1e-9, 1e-5, 5e-3, 0.3, 1.0, 2.5, M_PI - 1e-4,
+                       M_PI}) {
+    Vector6 xi;
+    xi << angle * axis, 0.4, -1.2, 2.0;
+    result.push_back(xi);
+  }
+  for (int i = 0; i < 20; ++i) {
+    Vector6 xi;
+    xi << sin(i), cos(2 * i), 0.5 * sin(3 * i), i, -0.5 * i, cos(i);
+    result.push_back(xi);
+  }
+  return result;
+}
+
+}  // namespace
+
+/* ************************************************************************* */
+TEST(LieBatch, SO3) {
+  const vector<Vector6> xis = twists();
+  const Eigen::Index n = xis.size();
+  batch::Vectors3 omega(n, 3);
+  batch::Matrices3 R2(n, 9);
+  for (Eigen::Index i = 0; i < n; ++i) {
+    omega.row(i) = xis[i].head<3>().transpose();
+    batch::SetMatrix3(&R2, i, Rot3::Ypr(0.1 * i, -0.2, 0.3).matrix());
+  }
+
+  batch::Matrices3 R, H, composed, Hlog;
+  batch::Vectors3 log;
+  batch::ExpmapSO3(omega, &R, &H);
+  batch::LogmapSO3(R, &log, &Hlog);
+  batch::ComposeSO3(R, R2, &composed);
+
+  for (Eigen::Index i = 0; i < n; ++i) {
+    const Vector3 w = omega.row(i).transpose();
+    const SO3 expected = SO3::Expmap(w);
+    EXPECT(assert_equal(expected.matrix(), batch::GetMatrix3(R, i), 1e-12));
+    EXPECT(assert_equal(SO3::ExpmapDerivative(w), batch::GetMatrix3(H, i),
+                        1e-12));
+    const Vector3 expectedLog = SO3::Logmap(expected);
+    EXPECT(assert_equal(expectedLog, Vector3(log.row(i).transpose()), 1e-9));
+    EXPECT(assert_equal(SO3::LogmapDerivative(expectedLog),
+                        batch::GetMatrix3(Hlog, i), 1e-9));
+    EXPECT(assert_equal(Matrix3(expected.matrix() * batch::GetMatrix3(R2, i)),
+                        batch::GetMatrix3(composed, i), 1e-12));
+  }
+}
+
+/* ************************************************************************* */
+TEST(LieBatch, Pose3) {
+  const vector<Vector6> xis = twists();
+  const Eigen::Index n = xis.size();
+  batch::Vectors6 xi(n, 6);
+  batch::Vectors3 p(n, 3);
+  for (Eigen::Index i = 0; i < n; ++i) {
+    xi.row(i) = xis[i].transpose();
+    p.row(i) << 1.0 + i, -2.0, 0.5 * i;
+  }
+
+  batch::Matrices3 R, composedR, Hpoint;
+  batch::Vectors3 t, composedT, q;
+  batch::Vectors6 log;
+  batch::Matrices36 Hpose;
+  batch::ExpmapPose3(xi, &R, &t);
+  batch::LogmapPose3(R, t, &log);
+  batch::ComposePose3(R, t, R, t, &composedR, &composedT);
+  batch::TransformFrom(R, t, p, &q, &Hpose, &Hpoint);
+
+  for (Eigen::Index i = 0; i < n; ++i) {
+    // Pose3::Expmap loses precision for small angles, so the translation is
+    // checked against the left Jacobian J_l(omega) = J_r(-omega) instead
+    const Vector3 omega = xis[i].head<3>(), v = xis[i].tail<3>();
+    const Pose3 expected(Rot3::Expmap(omega),
+                         SO3::ExpmapDerivative(-omega) * v);
+    EXPECT(assert_equal(Pose3::Expmap(xis[i]), expected, 1e-5));
+    const Pose3 actual(Rot3(batch::GetMatrix3(R, i)), t.row(i).transpose());
+    EXPECT(assert_equal(expected, actual, 1e-12));
+    EXPECT(assert_equal(Pose3::Logmap(expected), Vector6(log.row(i).transpose()),
+                        1e-9));
+    EXPECT(assert_equal(expected * expected,
+                        Pose3(Rot3(batch::GetMatrix3(composedR, i)),
+                              composedT.row(i).transpose()),
+                        1e-12));
+
+    Matrix36 expectedHpose;
+    Matrix3 expectedHpoint;
+    const Point3 expectedQ = expected.transformFrom(
+        p.row(i).transpose(), expectedHpose, expectedHpoint);
+    EXPECT(assert_equal(expectedQ, Point3(q.row(i).transpose()), 1e-12));
+    const Eigen::Matrix<double, 1, 18> row = Hpose.row(i);
+    EXPECT(assert_equal(Matrix(expectedHpose),
+                        Matrix(Eigen::Map<const Matrix36>(row.data())), 1e-12));
+    EXPECT(assert_equal(expectedHpoint, batch::GetMatrix3(Hpoint, i), 1e-12));
+  }
+}
+
+/* ************************************************************************* */
+int main() {
+  TestResult tr;
+  return TestRegistry::runAllTests(tr);
+}
+/* ************************************************************************* */
@@ -853,6 +853,164 @@ TEST(triangulation, reprojectionError_cameraComparison) {
   EXPECT(assert_equal(expectedErrorSpherical, actualErrorSpherical, 1e-7));
 }
 
+//******************************************************************************
+TEST(triangulation, batch) {
+  // Four cameras with different calibrations looking at three landmarks
+  const Cal3DS2 calibration(1500, 1200, 0.1, 640, 480, -0.1, 0.01, 0.001, -0.002);
+  CameraSet<PinholeCamera<Cal3DS2>> cameras;
+  for (const Pose3& offset :
+       {Pose3(), Pose3(Rot3(), Point3(1, 0, 0)),
+        Pose3(Rot3::Ypr(0.1, 0.2, 0.1), Point3(0.1, -2, -.1)),
+        Pose3(Rot3::Ypr(-0.1, 0.0, 0.05), Point3(0.5, 1, 0.2))})
+    cameras.emplace_back(kPose1 * offset, calibration);
+  const std::vector<Point3> landmarks{kLandmark, Point3(6, -0.5, 1.5),
+                                      Point3(4, 1.0, 0.8)};
+
+  // Track 0 sees all cameras, track 1 three, track 2 only one (degenerate)
+  const std::vector<std::vector<size_t>> tracks{{0, 1, 2, 3}, {3, 0, 2}, {1}};
+  Point2Vector measurements;
+  std::vector<size_t> cameraIndices, trackOffsets{0};
+  for (size_t j = 0; j < tracks.size(); ++j) {
+    for (size_t c : tracks[j]) {
+      const Point2 noise(0.3 * std::sin(double(c + j)), 0.3 * std::cos(double(c * j)));
+      measurements.push_back(cameras[c].project(landmarks[j]) + noise);
+      cameraIndices.push_back(c);
+    }
+    trackOffsets.push_back(measurements.size());
+  }
+
+  auto model = noiseModel::Isotropic::Sigma(2, 0.5);
+  for (bool optimize : {false, true}) {
+    const std::vector<TriangulationResult> actual =
+        triangulateBatch<PinholeCamera<Cal3DS2>>(cameras, measurements,
+                                                cameraIndices, trackOffsets,
+                                                1e-9, optimize, model);
+    LONGS_EQUAL(3, actual.size());
+    EXPECT(actual[2].degenerate());
+
+    for (size_t j = 0; j < 2; ++j) {
+      CameraSet<PinholeCamera<Cal3DS2>> trackCameras;
+      Point2Vector trackMeasurements;
+      for (size_t i = trackOffsets[j]; i < trackOffsets[j + 1]; ++i) {
+        trackCameras.push_back(cameras[cameraIndices[i]]);
+        trackMeasurements.push_back(measurements[i]);
+      }
+      Point3 expected =
+          triangulatePoint3<PinholeCamera<Cal3DS2>>(trackCameras, trackMeasurements);
+      if (optimize) {
+        // Fully converged nonlinear refinement
+        const auto [graph, values] = triangulationGraph<PinholeCamera<Cal3DS2>>(
+            trackCameras, trackMeasurements, 0, expected, model);
+        LevenbergMarquardtParams params;
+        params.relativeErrorTol = params.absoluteErrorTol = 1e-14;
+        expected = LevenbergMarquardtOptimizer(graph, values, params)
+                       .optimize()
+                       .at<Point3>(0);
+      }
+      CHECK(actual[j].valid());
+      EXPECT(assert_equal(expected, *actual[j], 1e-6));
+    }
+  }
+
+  // Inconsistent offsets
+  CHECK_EXCEPTION(triangulateBatch<PinholeCamera<Cal3DS2>>(
+                      cameras, measurements, cameraIndices, {0, 2}),
+                  std::invalid_argument);
+
+  // Offsets that do not start at 0
+  CHECK_EXCEPTION(triangulateBatch<PinholeCamera<Cal3DS2>>(
+                      cameras, measurements, cameraIndices, {1, 4, 7, 8}),
+                  std::invalid_argument);
+
+  // Decreasing offsets
+  CHECK_EXCEPTION(triangulateBatch<PinholeCamera<Cal3DS2>>(
+                      cameras, measurements, cameraIndices, {0, 5, 4, 8}),
+                  std::invalid_argument);
+
+  // Camera index out of range
+  std::vector<size_t> badCameraIndices = cameraIndices;
+  badCameraIndices[5] = cameras.size();
+  CHECK_EXCEPTION(triangulateBatch<PinholeCamera<Cal3DS2>>(
+                      cameras, measurements, badCameraIndices, trackOffsets),
+                  std::invalid_argument);
+
+  // With a robust model, the refinement converges to the same point as LM
+  auto robust = noiseModel::Robust::Create(
+      noiseModel::mEstimator::Huber::Create(0.5), model);
+  const std::vector<TriangulationResult> robustResults =
+      triangulateBatch<PinholeCamera<Cal3DS2>>(
+          cameras, measurements, cameraIndices, trackOffsets,
+          TriangulationParameters(1e-9, true, -1, -1, robust));
+  {
+    CameraSet<PinholeCamera<Cal3DS2>> trackCameras(cameras.begin(),
+                                                   cameras.end());
+    const Point2Vector trackMeasurements(measurements.begin(),
+                                         measurements.begin() + 4);
+    const Point3 initial = triangulatePoint3<PinholeCamera<Cal3DS2>>(
+        trackCameras, trackMeasurements);
+    const auto [graph, values] = triangulationGraph<PinholeCamera<Cal3DS2>>(
+        trackCameras, trackMeasurements, 0, initial, robust);
+    LevenbergMarquardtParams params;
+    params.relativeErrorTol = params.absoluteErrorTol = 1e-14;
+    const Point3 expected = LevenbergMarquardtOptimizer(graph, values, params)
+                                .optimize()
+                                .at<Point3>(0);
+    CHECK(robustResults[0].valid());
+    EXPECT(assert_equal(expected, *robustResults[0], 1e-6));
+  }
+
+  // The refinement ends in a stationary point of the reprojection error, as
+  // computed with the scalar PinholeCamera::project2
+  {
+    const std::vector<TriangulationResult> refined =
+        triangulateBatch<PinholeCamera<Cal3DS2>>(
+            cameras, measurements, cameraIndices, trackOffsets,
+            TriangulationParameters(1e-9, true, -1, -1, model));
+    for (size_t j = 0; j < 2; ++j) {
+      CHECK(refined[j].valid());
+      Vector3 gradient = Vector3::Zero();
+      for (size_t i = trackOffsets[j]; i < trackOffsets[j + 1]; ++i) {
+        Matrix23 A;
+        const Vector2 e =
+            cameras[cameraIndices[i]].project2(*refined[j], {}, A) -
+            measurements[i];
+        gradient += A.transpose() * e;
+      }
+      EXPECT(assert_equal(Vector3(Vector3::Zero()), gradient, 1e-6));
+    }
+  }
+
+  // Results are checked the same way as triangulateSafe
+  for (const TriangulationParameters& params :
+       {TriangulationParameters(1e-9, true, 1.0),
+        TriangulationParameters(1e-9, true, -1, 0.1, model),
+        TriangulationParameters(1e-9, true, -1, 5.0, model)}) {
+    const std::vector<TriangulationResult> checked =
+        triangulateBatch<PinholeCamera<Cal3DS2>>(cameras, measurements,
+                                                cameraIndices, trackOffsets,
+                                                params);
+    for (size_t j = 0; j < 3; ++j) {
+      CameraSet<PinholeCamera<Cal3DS2>> trackCameras;
+      Point2Vector trackMeasurements;
+      for (size_t i = trackOffsets[j]; i < trackOffsets[j + 1]; ++i) {
+        trackCameras.push_back(cameras[cameraIndices[i]]);
+        trackMeasurements.push_back(measurements[i]);
+      }
+      const TriangulationResult expected =
+          triangulateSafe(trackCameras, trackMeasurements, params);
+      EXPECT_LONGS_EQUAL(expected.status, checked[j].status);
+    }
+  }
+
+  // Only Gaussian models, possibly robustified, can be whitened in batch
+  CHECK_EXCEPTION(
+      triangulateBatch<PinholeCamera<Cal3DS2>>(
+          cameras, measurements, cameraIndices, trackOffsets,
+          TriangulationParameters(1e-9, true, -1, -1,
+                                  noiseModel::Isotropic::Sigma(3, 0.5))),
+      std::invalid_argument);
+}
+
 //******************************************************************************
 int main() {
   TestResult tr;
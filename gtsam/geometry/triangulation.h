@@ -27,12 +27,19 @@
 #include <gtsam/geometry/Cal3_S2.h>
 #include <gtsam/geometry/Cal3DS2.h>
 #include <gtsam/geometry/CameraSet.h>
+#include <gtsam/geometry/LieBatch.h>
 #include <gtsam/geometry/PinholeCamera.h>
 #include <gtsam/geometry/SphericalCamera.h>
 #include <gtsam/geometry/Pose2.h>
 #include <gtsam/inference/Symbol.h>
 #include <gtsam/nonlinear/NonlinearFactorGraph.h>
 #include <gtsam/slam/TriangulationFactor.h>
+#include <gtsam/config.h>
+
+#ifdef GTSAM_USE_TBB
+#include <tbb/blocked_range.h>
+#include <tbb/parallel_for.h>
+#endif
 
 #include <optional>
 
@@ -742,6 +749,283 @@ TriangulationResult triangulateSafe(const CameraSet<CAMERA>& cameras,
     }
 }
 
+namespace internal {
+
+/**
+ * Fixed-size form of the noise model used by triangulateBatch: whitening with
+ * the square root information matrix of a Gaussian, followed by an optional
+ * robust reweighting, as in noiseModel::Robust::WhitenSystem.
+ */
+struct BatchTriangulationNoise {
+  Matrix2 sqrtInformation = Matrix2::Identity();
+  noiseModel::mEstimator::Base::shared_ptr robust;
+
+  explicit BatchTriangulationNoise(const SharedNoiseModel& model) {
+    if (!model) return;
+    SharedNoiseModel gaussianModel = model;
+    if (auto robustModel =
+            std::dynamic_pointer_cast<noiseModel::Robust>(model)) {
+      robust = robustModel->robust();
+      gaussianModel = robustModel->noise();
+    }
+    auto gaussian =
+        std::dynamic_pointer_cast<noiseModel::Gaussian>(gaussianModel);
+    if (!gaussian || gaussian->dim() != 2)
+      throw std::invalid_argument(
+          "triangulateBatch: noise model must be a 2D Gaussian, or Robust "
+          "around one");
+    sqrtInformation = gaussian->R();
+  }
+};
+
+/**
+ * Triangulate the measurements [begin, end) of a batch, see triangulateBatch.
+ * Row c of (cameraRotations, cameraTranslations) is the inverse of the pose
+ * of camera c, only used if params.enableEPI is set.
+ */
+template <class CAMERA>
+TriangulationResult triangulateBatchTrack(
+    const CameraSet<CAMERA>& cameras,
+    const std::vector<Matrix34, Eigen::aligned_allocator<Matrix34>>&
+        projectionMatrices,
+    const std::vector<Cal3_S2>& pinholeCalibrations,
+    const batch::Matrices3& cameraRotations,
+    const batch::Vectors3& cameraTranslations,
+    const typename CAMERA::MeasurementVector& measurements,
+    const std::vector<size_t>& cameraIndices, size_t begin, size_t end,
+    const TriangulationParameters& params,
+    const BatchTriangulationNoise& noise) {
+  if (end - begin < 2) return TriangulationResult::Degenerate();
+
+  // DLT. Rows of the DLT matrix are folded into a 4x4 triangular factor with
+  // Givens rotations, which has the same singular values and vectors, so the
+  // SVD is fixed-size and no per-track matrix is allocated.
+  Matrix4 R = Matrix4::Zero();
+  auto addRow = [&R](Eigen::Matrix<double, 1, 4> a) {
+    for (int k = 0; k < 4; ++k) {
+      if (a(k) == 0.0) continue;
+      const double r = std::hypot(R(k, k), a(k));
+      const double c = R(k, k) / r, s = a(k) / r;
+      for (int j = k; j < 4; ++j) {
+        const double t = R(k, j);
+        R(k, j) = c * t + s * a(j);
+        a(j) = c * a(j) - s * t;
+      }
+    }
+  };
+  for (size_t i = begin; i < end; ++i) {
+    const size_t c = cameraIndices[i];
+    const Matrix34& P = projectionMatrices[c];
+    const Point2 p = undistortMeasurementInternal<typename CAMERA::CalibrationType>(
+        cameras[c].calibration(), measurements[i], pinholeCalibrations[c]);
+    addRow(p.x() * P.row(2) - P.row(0));
+    addRow(p.y() * P.row(2) - P.row(1));
+  }
+  const Eigen::JacobiSVD<Matrix4> svd(R, Eigen::ComputeFullV);
+  int rank = 0;
+  for (int j = 0; j < 4; ++j)
+    if (svd.singularValues()(j) > params.rankTolerance) rank++;
+  if (rank < 3) return TriangulationResult::Degenerate();
+  const Vector4 v = svd.matrixV().col(3);
+  Point3 point = v.head<3>() / v[3];
+
+  try {
+    // Gauss-Newton refinement on the whitened reprojection errors, with 3x3
+    // normal equations since only the point is estimated. In every iteration
+    // the point is transformed into the frames of all cameras of the track at
+    // once, and then projected as in PinholeBase::project2.
+    if (params.enableEPI) {
+      const Eigen::Index m = end - begin;
+      batch::Matrices3 R(m, 9);
+      batch::Vectors3 t(m, 3), p(m, 3), q;
+      for (Eigen::Index k = 0; k < m; ++k) {
+        R.row(k) = cameraRotations.row(cameraIndices[begin + k]);
+        t.row(k) = cameraTranslations.row(cameraIndices[begin + k]);
+      }
+      for (size_t iteration = 0; iteration < 20; ++iteration) {
+        Matrix3 H = Matrix3::Zero();
+        Vector3 g = Vector3::Zero();
+        p.rowwise() = point.transpose();
+        batch::TransformFrom(R, t, p, &q);
+        for (Eigen::Index k = 0; k < m; ++k) {
+          const size_t i = begin + k;
+          const Point3 pc = q.row(k).transpose();
+#ifdef GTSAM_THROW_CHEIRALITY_EXCEPTION
+          if (pc.z() <= 0) throw CheiralityException();
+#endif
+          Matrix23 Dpn;
+          Matrix2 Dpi;
+          const Point2 pn = PinholeBase::Project(pc, Dpn);
+          Vector2 b = cameras[cameraIndices[i]].calibration().uncalibrate(
+                          pn, {}, Dpi) -
+                      measurements[i];
+          Matrix23 A = noise.sqrtInformation * Dpi * Dpn *
+                       batch::GetMatrix3(R, k);
+          b = -(noise.sqrtInformation * b);
+          if (noise.robust) {
+            const double sqrtWeight = noise.robust->sqrtWeight(b.norm());
+            A *= sqrtWeight;
+            b *= sqrtWeight;
+          }
+          H.noalias() += A.transpose() * A;
+          g.noalias() += A.transpose() * b;
+        }
+        const Eigen::LDLT<Matrix3> ldlt(H);
+        if (ldlt.info() != Eigen::Success) break;
+        const Vector3 delta = ldlt.solve(g);
+        point += delta;
+        if (delta.norm() <= 1e-10 * std::max(1.0, point.norm())) break;
+      }
+    }
+
+    // Same checks as triangulateSafe
+    double maxReprojError = 0.0;
+    for (size_t i = begin; i < end; ++i) {
+      const CAMERA& camera = cameras[cameraIndices[i]];
+      if (params.landmarkDistanceThreshold > 0 &&
+          distance3(camera.pose().translation(), point) >
+              params.landmarkDistanceThreshold)
+        return TriangulationResult::FarPoint();
+#ifdef GTSAM_THROW_CHEIRALITY_EXCEPTION
+      if (camera.pose().transformTo(point).z() <= 0)
+        return TriangulationResult::BehindCamera();
+#endif
+      if (params.dynamicOutlierRejectionThreshold > 0) {
+        const Point2 reprojectionError =
+            camera.reprojectionError(point, measurements[i]);
+        maxReprojError = std::max(maxReprojError, reprojectionError.norm());
+      }
+    }
+    if (params.dynamicOutlierRejectionThreshold > 0 &&
+        maxReprojError > params.dynamicOutlierRejectionThreshold)
+      return TriangulationResult::Outlier();
+  } catch (CheiralityException&) {
+    return TriangulationResult::BehindCamera();
+  }
+
+  return TriangulationResult(point);
+}
+
+}  // namespace internal
+
+/**
+ * Triangulate many tracks at once, e.g. to re-triangulate all landmarks after
+ * a bundle adjustment iteration. All tracks index into one flat array of
+ * cameras, so projection matrices are computed once per camera rather than
+ * once per observation. Each track is solved with a fixed-size DLT and,
+ * if params.enableEPI is set, Gauss-Newton refinement on the point only, which
+ * moves the point into all cameras of the track with batch::TransformFrom.
+ * Tracks are processed in parallel when TBB is enabled.
+ *
+ * Results are checked as in triangulateSafe, with rankTolerance,
+ * landmarkDistanceThreshold and dynamicOutlierRejectionThreshold. Unlike
+ * triangulateSafe, the refinement is Gauss-Newton rather than LM, and
+ * params.noiseModel must be a 2D Gaussian, possibly wrapped in a Robust model.
+ *
+ * @param cameras All cameras
+ * @param measurements All measurements, grouped by track
+ * @param cameraIndices Index into cameras for each measurement
+ * @param trackOffsets Track j consists of the measurements
+ *        [trackOffsets[j], trackOffsets[j+1]), so its size is one more than
+ *        the number of tracks
+ * @param params Triangulation parameters
+ * @return One result per track: degenerate if seen by fewer than two cameras
+ *         or if the DLT is rank deficient, and otherwise as triangulateSafe
+ * @throw std::invalid_argument if trackOffsets does not start at 0, end at
+ *        measurements.size() and never decrease, or a camera index is out of
+ *        range
+ */
+template <class CAMERA>
+std::vector<TriangulationResult> triangulateBatch(
+    const CameraSet<CAMERA>& cameras,
+    const typename CAMERA::MeasurementVector& measurements,
+    const std::vector<size_t>& cameraIndices,
+    const std::vector<size_t>& trackOffsets,
+    const TriangulationParameters& params) {
+  if (measurements.size() != cameraIndices.size() || trackOffsets.empty() ||
+      trackOffsets.back() != measurements.size())
+    throw std::invalid_argument(
+        "triangulateBatch: measurements, cameraIndices and trackOffsets are "
+        "inconsistent");
+  if (trackOffsets.front() != 0)
+    throw std::invalid_argument(
+        "triangulateBatch: trackOffsets has to start at 0");
+  for (size_t j = 0; j + 1 < trackOffsets.size(); ++j) {
+    if (trackOffsets[j] > trackOffsets[j + 1])
+      throw std::invalid_argument(
+          "triangulateBatch: trackOffsets has to be non-decreasing");
+  }
+  for (size_t index : cameraIndices) {
+    if (index >= cameras.size())
+      throw std::invalid_argument(
+          "triangulateBatch: camera index out of range");
+  }
+  const internal::BatchTriangulationNoise noise(
+      params.enableEPI ? params.noiseModel : nullptr);
+
+  std::vector<Matrix34, Eigen::aligned_allocator<Matrix34>> projectionMatrices;
+  std::vector<Cal3_S2> pinholeCalibrations;
+  projectionMatrices.reserve(cameras.size());
+  pinholeCalibrations.reserve(cameras.size());
+  for (const CAMERA& camera : cameras) {
+    projectionMatrices.push_back(camera.cameraProjectionMatrix());
+    pinholeCalibrations.push_back(createPinholeCalibration(camera.calibration()));
+  }
+
+  // Inverse camera poses, in batch form for the refinement
+  batch::Matrices3 cameraRotations;
+  batch::Vectors3 cameraTranslations;
+  if (params.enableEPI) {
+    cameraRotations.resize(cameras.size(), 9);
+    cameraTranslations.resize(cameras.size(), 3);
+    for (size_t c = 0; c < cameras.size(); ++c) {
+      const Matrix3 Rt = cameras[c].pose().rotation().transpose();
+      batch::SetMatrix3(&cameraRotations, c, Rt);
+      cameraTranslations.row(c) =
+          -(Rt * cameras[c].pose().translation()).transpose();
+    }
+  }
+
+  const size_t numTracks = trackOffsets.size() - 1;
+  std::vector<TriangulationResult> results(numTracks,
+                                           TriangulationResult::Degenerate());
+  auto triangulateRange = [&](size_t first, size_t last) {
+    for (size_t j = first; j < last; ++j)
+      results[j] = internal::triangulateBatchTrack<CAMERA>(
+          cameras, projectionMatrices, pinholeCalibrations, cameraRotations,
+          cameraTranslations, measurements, cameraIndices, trackOffsets[j],
+          trackOffsets[j + 1], params, noise);
+  };
+#ifdef GTSAM_USE_TBB
+  tbb::parallel_for(tbb::blocked_range<size_t>(0, numTracks),
+                    [&](const tbb::blocked_range<size_t>& range) {
+                      triangulateRange(range.begin(), range.end());
+                    });
+#else
+  triangulateRange(0, numTracks);
+#endif
+  return results;
+}
+
+/**
+ * Triangulate many tracks at once, without the distance and reprojection
+ * error checks of triangulateSafe. See above for the other arguments.
+ * @param rank_tol SVD rank tolerance
+ * @param optimize Flag to turn on nonlinear refinement of triangulation
+ * @param model Noise model used in the refinement
+ */
+template <class CAMERA>
+std::vector<TriangulationResult> triangulateBatch(
+    const CameraSet<CAMERA>& cameras,
+    const typename CAMERA::MeasurementVector& measurements,
+    const std::vector<size_t>& cameraIndices,
+    const std::vector<size_t>& trackOffsets, double rank_tol = 1e-9,
+    bool optimize = false, const SharedNoiseModel& model = nullptr) {
+  return triangulateBatch<CAMERA>(
+      cameras, measurements, cameraIndices, trackOffsets,
+      TriangulationParameters(rank_tol, optimize, -1, -1, model));
+}
+
 // Vector of Cameras - used by the Python/MATLAB wrapper
 using CameraSetCal3Bundler = CameraSet<PinholeCamera<Cal3Bundler>>;
 using CameraSetCal3_S2 = CameraSet<PinholeCamera<Cal3_S2>>;
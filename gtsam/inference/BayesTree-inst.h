@@ -24,6 +24,11 @@
 #include <gtsam/inference/BayesTree.h>
 #include <gtsam/base/treeTraversal-inst.h>
 #include <gtsam/base/timing.h>
+#include <gtsam/config.h> // for GTSAM_USE_TBB
+
+#ifdef GTSAM_USE_TBB
+#include <tbb/parallel_for.h>
+#endif
 
 #include <fstream>
 #include <queue>
@@ -59,6 +64,33 @@ namespace gtsam {
     return count;
   }
 
+  /* ************************************************************************* */
+  template <class CLIQUE>
+  void BayesTree<CLIQUE>::computeSeparatorMarginals(
+      const Eliminate& function) const {
+    gttic(BayesTree_computeSeparatorMarginals);
+    // A separator marginal needs the one of the parent clique, so all cliques
+    // of one level are independent once the previous level is done.
+    std::vector<sharedClique> level(roots_.begin(), roots_.end()), next;
+    while (!level.empty()) {
+#ifdef GTSAM_USE_TBB
+      tbb::parallel_for(tbb::blocked_range<size_t>(0, level.size()),
+                        [&](const tbb::blocked_range<size_t>& range) {
+                          for (size_t i = range.begin(); i != range.end(); ++i)
+                            level[i]->separatorMarginal(function);
+                        });
+#else
+      for (const sharedClique& clique : level)
+        clique->separatorMarginal(function);
+#endif
+      next.clear();
+      for (const sharedClique& clique : level)
+        next.insert(next.end(), clique->children.begin(),
+                    clique->children.end());
+      level.swap(next);
+    }
+  }
+
   /* ************************************************************************* */
   template <class CLIQUE>
   void BayesTree<CLIQUE>::dot(std::ostream& os,
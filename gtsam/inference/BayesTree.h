@@ -166,6 +166,15 @@ namespace gtsam {
     /** Collect number of cliques with cached separator marginals */
     size_t numCachedSeparatorMarginals() const;
 
+    /**
+     * Compute and cache the separator marginals of all cliques, level by level
+     * from the roots, with the cliques of each level processed in parallel when
+     * TBB is enabled. Afterwards marginalFactor and joint only read the cache,
+     * which is safe to do from many threads at once.
+     */
+    void computeSeparatorMarginals(
+        const Eliminate& function = EliminationTraitsType::DefaultEliminate) const;
+
     /** Return marginal on any variable.  Note that this actually returns a conditional, for which a
      *  solution may be directly obtained by calling .solve() on the returned object.
      *  Alternatively, it may be directly used as its factor base class.  For example, for Gaussian
@@ -92,8 +92,7 @@ namespace gtsam {
   template<class DERIVED, class FACTORGRAPH>
   size_t BayesTreeCliqueBase<DERIVED, FACTORGRAPH>::numCachedSeparatorMarginals() const
   {
-    std::lock_guard<std::mutex> marginalLock(cachedSeparatorMarginalMutex_);
-    if (!cachedSeparatorMarginal_)
+    if (!std::atomic_load(&cachedSeparatorMarginal_))
       return 0;
 
     size_t subtree_count = 1;
@@ -146,17 +145,18 @@ namespace gtsam {
   typename BayesTreeCliqueBase<DERIVED, FACTORGRAPH>::FactorGraphType
   BayesTreeCliqueBase<DERIVED, FACTORGRAPH>::separatorMarginal(
       Eliminate function) const {
-    std::lock_guard<std::mutex> marginalLock(cachedSeparatorMarginalMutex_);
     gttic(BayesTreeCliqueBase_separatorMarginal);
     // Check if the Separator marginal was already calculated
-    if (!cachedSeparatorMarginal_) {
+    std::shared_ptr<const FactorGraphType> cached =
+        std::atomic_load(&cachedSeparatorMarginal_);
+    if (!cached) {
       gttic(BayesTreeCliqueBase_separatorMarginal_cachemiss);
 
+      std::shared_ptr<const FactorGraphType> computed;
       // If this is the root, there is no separator
       if (parent_.expired() /*(if we're the root)*/) {
         // we are root, return empty
-        FactorGraphType empty;
-        cachedSeparatorMarginal_ = empty;
+        computed = std::make_shared<const FactorGraphType>();
       } else {
         // Flatten recursion in timing outline
         gttoc(BayesTreeCliqueBase_separatorMarginal_cachemiss);
@@ -178,12 +178,20 @@ namespace gtsam {
                            this->conditional()->endParents());
         auto separatorMarginal =
             p_Cp.marginalMultifrontalBayesNet(Ordering(indicesS), function);
-        cachedSeparatorMarginal_ = *separatorMarginal;
+        computed = std::make_shared<const FactorGraphType>(*separatorMarginal);
       }
+
+      // Publish, unless another thread got there first
+      std::shared_ptr<const FactorGraphType> expected;
+      if (std::atomic_compare_exchange_strong(&cachedSeparatorMarginal_,
+                                              &expected, computed))
+        cached = computed;
+      else
+        cached = expected;
     }
 
     // return the shortcut P(S||B)
-    return *cachedSeparatorMarginal_;  // return the cached version
+    return *cached;  // return the cached version
   }
 
   /* *********************************************************************** */
@@ -210,14 +218,13 @@ namespace gtsam {
     // root are also generated. So, if this clique's cached shortcut is set,
     // recursively call over all child cliques. Otherwise, it is unnecessary.
     
-    std::lock_guard<std::mutex> marginalLock(cachedSeparatorMarginalMutex_);
-    if (cachedSeparatorMarginal_) {
+    if (std::atomic_load(&cachedSeparatorMarginal_)) {
       for(derived_ptr& child: children) {
         child->deleteCachedShortcuts();
       }
 
       //Delete CachedShortcut for this clique
-      cachedSeparatorMarginal_ = {};
+      deleteCachedShortcutsNonRecursive();
     }
 
   }
@@ -23,7 +23,7 @@
 #include <gtsam/base/FastVector.h>
 
 #include <string>
-#include <mutex>
+#include <memory>
 #include <optional>
 
 namespace gtsam {
@@ -101,13 +101,11 @@ namespace gtsam {
 
     /// @}
 
-    /// This stores the Cached separator marginal P(S)
-    mutable std::optional<FactorGraphType> cachedSeparatorMarginal_;
-    /// This protects Cached seperator marginal P(S) from concurrent read/writes
-    /// as many the functions which access it are const (hence the mutable)
-    /// leading to the false impression that these const functions are thread-safe
-    /// which is not true due to these mutable values. This is fixed by applying this mutex.
-    mutable std::mutex cachedSeparatorMarginalMutex_;
+    /// This stores the Cached separator marginal P(S). It is only accessed
+    /// through std::atomic_load/std::atomic_store, so const queries from many
+    /// threads read it without locking. Threads that miss the cache at the same
+    /// time compute the same marginal, and the first one to finish publishes it.
+    mutable std::shared_ptr<const FactorGraphType> cachedSeparatorMarginal_;
 
   public:
     sharedConditional conditional_;
@@ -174,9 +172,11 @@ namespace gtsam {
      */
     void deleteCachedShortcuts();
 
-    const std::optional<FactorGraphType>& cachedSeparatorMarginal() const {
-      std::lock_guard<std::mutex> marginalLock(cachedSeparatorMarginalMutex_);
-      return cachedSeparatorMarginal_; 
+    /** The cached separator marginal P(S), if it was computed */
+    std::optional<FactorGraphType> cachedSeparatorMarginal() const {
+      const auto cached = std::atomic_load(&cachedSeparatorMarginal_);
+      if (!cached) return {};
+      return *cached;
     }
 
     friend class BayesTree<DerivedType>;
@@ -192,9 +192,9 @@ namespace gtsam {
     KeyVector shortcut_indices(const derived_ptr& B, const FactorGraphType& p_Cp_B) const;
 
     /** Non-recursive delete cached shortcuts and marginals - internal only. */
-    void deleteCachedShortcutsNonRecursive() { 
-      std::lock_guard<std::mutex> marginalLock(cachedSeparatorMarginalMutex_);
-      cachedSeparatorMarginal_ = {}; 
+    void deleteCachedShortcutsNonRecursive() {
+      std::atomic_store(&cachedSeparatorMarginal_,
+                        std::shared_ptr<const FactorGraphType>());
     }
 
   private:
@@ -158,6 +158,10 @@ struct EliminationData {
 
   EliminationData* const parentData;
   size_t myIndexInParent;
+  // Indexed by child position, which visitorPre assigns in tree order, so the
+  // remaining factors of the children are always gathered in the same order
+  // no matter which child finishes first. This keeps parallel elimination
+  // bitwise reproducible across thread counts.
   FastVector<sharedFactor> childFactors;
   std::shared_ptr<BTNode> bayesTreeNode;
 #ifdef GTSAM_USE_TBB
@@ -49,6 +49,9 @@ namespace gtsam {
       } else if (orderingType == Ordering::NATURAL) {
         Ordering computedOrdering = Ordering::Natural(asDerived());
         return eliminateSequential(computedOrdering, function, variableIndex);
+      } else if (orderingType == Ordering::AUTO) {
+        Ordering computedOrdering = Ordering::Auto(asDerived());
+        return eliminateSequential(computedOrdering, function, variableIndex);
       } else {
         Ordering computedOrdering = EliminationTraitsType::DefaultOrderingFunc(
             asDerived(), *variableIndex);
@@ -110,6 +113,9 @@ namespace gtsam {
       } else if (orderingType == Ordering::NATURAL) {
         Ordering computedOrdering = Ordering::Natural(asDerived());
         return eliminateMultifrontal(computedOrdering, function, variableIndex);
+      } else if (orderingType == Ordering::AUTO) {
+        Ordering computedOrdering = Ordering::Auto(asDerived());
+        return eliminateMultifrontal(computedOrdering, function, variableIndex);
       } else {
         Ordering computedOrdering = EliminationTraitsType::DefaultOrderingFunc(
             asDerived(), *variableIndex);
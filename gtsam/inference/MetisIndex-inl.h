@@ -17,7 +17,15 @@
 
 #pragma once
 
+#include <gtsam/config.h>  // for GTSAM_USE_TBB
+
+#ifdef GTSAM_USE_TBB
+#include <tbb/parallel_sort.h>
+#endif
+
+#include <algorithm>
 #include <map>
+#include <utility>
 #include <vector>
 
 namespace gtsam {
@@ -25,60 +33,67 @@ namespace gtsam {
 /* ************************************************************************* */
 template<class FACTORGRAPH>
 void MetisIndex::augment(const FACTORGRAPH& factors) {
-  std::map<int32_t, std::set<int32_t> > iAdjMap; // Stores a set of keys that are adjacent to key x, with  adjMap.first
-  std::map<int32_t, std::set<int32_t> >::iterator iAdjMapIt;
-  std::set<Key> keySet;
-
   /* ********** Convert to CSR format ********** */
   // Assuming that vertex numbering starts from 0 (C style),
   // then the adjacency list of vertex i is stored in array adjncy
   // starting at index xadj[i] and ending at(but not including)
   // index xadj[i + 1](i.e., adjncy[xadj[i]] through
   // and including adjncy[xadj[i + 1] - 1]).
-  int32_t keyCounter = 0;
+  int32_t keyCounter = static_cast<int32_t>(intKeyBMap_.left.size());
 
-  // First: Record a copy of each key inside the factorgraph and create a
-  // key to integer mapping. This is referenced during the adjaceny step
+  // First: create a key to integer mapping, in order of first appearance,
+  // and record the integer keys of every factor so that the map is looked up
+  // only once per key occurrence.
+  std::vector<int32_t> factorKeys;
+  std::vector<size_t> factorStarts{0};
+  size_t nrEdges = 0;
   for (size_t i = 0; i < factors.size(); i++) {
     if (factors[i]) {
-      for(const Key& key: *factors[i]) {
-        keySet.insert(keySet.end(), key); // Keep a track of all unique keys
-        if (intKeyBMap_.left.find(key) == intKeyBMap_.left.end()) {
-          intKeyBMap_.insert(key, keyCounter);
-          keyCounter++;
+      for (const Key& key : *factors[i]) {
+        const auto it = intKeyBMap_.left.lower_bound(key);
+        if (it != intKeyBMap_.left.end() && it->first == key) {
+          factorKeys.push_back(it->second);
+        } else {
+          intKeyBMap_.left.emplace_hint(it, key, keyCounter);
+          intKeyBMap_.right.emplace(keyCounter, key);
+          factorKeys.push_back(keyCounter++);
         }
       }
-    }
-  }
-
-  // Create an adjacency mapping that stores the set of all adjacent keys for every key
-  for (size_t i = 0; i < factors.size(); i++) {
-    if (factors[i]) {
-      for(const Key& k1: *factors[i])
-        for(const Key& k2: *factors[i])
-          if (k1 != k2) {
-            // Store both in Key and int32_t format
-            int i = intKeyBMap_.left.at(k1);
-            int j = intKeyBMap_.left.at(k2);
-            iAdjMap[i].insert(iAdjMap[i].end(), j);
-          }
+      const size_t n = factorKeys.size() - factorStarts.back();
+      nrEdges += n * (n - 1);
+      factorStarts.push_back(factorKeys.size());
     }
   }
 
   // Number of keys referenced in this factor graph
-  nKeys_ = keySet.size();
+  nKeys_ = keyCounter;
+
+  // Collect all directed edges, then sort and deduplicate them: this yields
+  // the adjacency lists of all vertices, in order, in one contiguous array.
+  std::vector<std::pair<int32_t, int32_t> > edges;
+  edges.reserve(nrEdges);
+  for (size_t f = 0; f + 1 < factorStarts.size(); f++) {
+    for (size_t a = factorStarts[f]; a < factorStarts[f + 1]; a++)
+      for (size_t b = factorStarts[f]; b < factorStarts[f + 1]; b++)
+        if (factorKeys[a] != factorKeys[b])
+          edges.emplace_back(factorKeys[a], factorKeys[b]);
+  }
+#ifdef GTSAM_USE_TBB
+  tbb::parallel_sort(edges.begin(), edges.end());
+#else
+  std::sort(edges.begin(), edges.end());
+#endif
+  edges.erase(std::unique(edges.begin(), edges.end()), edges.end());
 
-  xadj_.push_back(0); // Always set the first index to zero
-  for (iAdjMapIt = iAdjMap.begin(); iAdjMapIt != iAdjMap.end(); ++iAdjMapIt) {
-    std::vector<int32_t> temp;
-    // Copy from the FastSet into a temporary vector
-    std::copy(iAdjMapIt->second.begin(), iAdjMapIt->second.end(),
-        std::back_inserter(temp));
-    // Insert each index's set in order by appending them to the end of adj_
-    adj_.insert(adj_.end(), temp.begin(), temp.end());
-    //adj_.push_back(temp);
-    xadj_.push_back((int32_t) adj_.size());
+  // Every vertex gets a row, also those without neighbors
+  xadj_.assign(nKeys_ + 1, 0);
+  adj_.clear();
+  adj_.reserve(edges.size());
+  for (const auto& edge : edges) {
+    xadj_[edge.first + 1]++;
+    adj_.push_back(edge.second);
   }
+  for (size_t i = 0; i < nKeys_; i++) xadj_[i + 1] += xadj_[i];
 }
 
 } // \ gtsam
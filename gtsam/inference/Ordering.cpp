@@ -233,7 +233,7 @@ Ordering Ordering::Metis(const MetisIndex& met) {
 
   int outputError;
 
-  outputError = METIS_NodeND(&size, &xadj[0], &adj[0], nullptr, nullptr, &perm[0],
+  outputError = METIS_NodeND(&size, xadj.data(), adj.data(), nullptr, nullptr, &perm[0],
       &iperm[0]);
   Ordering result;
 
@@ -20,6 +20,7 @@
 
 #pragma once
 
+#include <gtsam/config.h>
 #include <gtsam/inference/Key.h>
 #include <gtsam/inference/VariableIndex.h>
 #include <gtsam/inference/MetisIndex.h>
@@ -42,7 +43,7 @@ public:
 
   /// Type of ordering to use
   enum OrderingType {
-    COLAMD, METIS, NATURAL, CUSTOM
+    COLAMD, METIS, NATURAL, CUSTOM, AUTO
   };
 
   typedef Ordering This; ///< Typedef to this class
@@ -215,6 +216,25 @@ public:
       return Metis(MetisIndex(graph));
   }
 
+  /// Number of factors from which Auto() switches from COLAMD to METIS
+  static constexpr size_t AutoMetisThreshold = 10000;
+
+  /**
+   * Compute a fill-reducing ordering, choosing the algorithm from the size of
+   * the graph: COLAMD for small and medium graphs, and METIS nested dissection
+   * for graphs with at least AutoMetisThreshold factors, where it typically
+   * produces less fill-in. Falls back to COLAMD if GTSAM was built without
+   * METIS support.
+   */
+  template<class FACTOR_GRAPH>
+  static Ordering Auto(const FACTOR_GRAPH& graph) {
+#ifdef GTSAM_SUPPORT_NESTED_DISSECTION
+    if (graph.size() >= AutoMetisThreshold)
+      return Metis(graph);
+#endif
+    return Colamd(graph);
+  }
+
   /// @}
 
   /// @name Named Constructors
@@ -233,6 +253,8 @@ public:
       return Metis(graph);
     case NATURAL:
       return Natural(graph);
+    case AUTO:
+      return Auto(graph);
     case CUSTOM:
       throw std::runtime_error(
           "Ordering::Create error: called with CUSTOM ordering type.");
@@ -99,7 +99,7 @@ size_t mrsymbolIndex(size_t key);
 #include <gtsam/inference/Ordering.h>
 class Ordering {
   /// Type of ordering to use
-  enum OrderingType { COLAMD, METIS, NATURAL, CUSTOM };
+  enum OrderingType { COLAMD, METIS, NATURAL, CUSTOM, AUTO };
 
   // Standard Constructors and Named Constructors
   Ordering();
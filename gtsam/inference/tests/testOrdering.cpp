@@ -254,6 +254,27 @@ TEST(Ordering, csr_format_4) {
 #endif
 /* ************************************************************************* */
 #ifdef GTSAM_SUPPORT_NESTED_DISSECTION
+TEST(Ordering, csr_format_isolated) {
+  // Variable 0 only appears in a unary factor, but still gets an empty row
+  SymbolicFactorGraph symbolicGraph;
+  symbolicGraph.push_factor(0);
+  symbolicGraph.push_factor(1, 2);
+  symbolicGraph.push_factor(1, 2);
+
+  MetisIndex mi(symbolicGraph);
+
+  const vector<int> xadjExpected{0, 0, 1, 2}, adjExpected{2, 1};
+
+  EXPECT(xadjExpected == mi.xadj());
+  EXPECT(adjExpected == mi.adj());
+  LONGS_EQUAL(3, mi.nValues());
+
+  Ordering actual = Ordering::Metis(symbolicGraph);
+  LONGS_EQUAL(3, actual.size());
+}
+#endif
+/* ************************************************************************* */
+#ifdef GTSAM_SUPPORT_NESTED_DISSECTION
 TEST(Ordering, metis) {
 
   SymbolicFactorGraph symbolicGraph;
@@ -369,6 +390,13 @@ TEST(Ordering, Create) {
   }
 #endif
 
+  // AUTO: small graphs use COLAMD
+  {
+    Ordering actual = Ordering::Create(Ordering::AUTO, symbolicGraph);
+    Ordering expected = Ordering::Colamd(symbolicGraph);
+    EXPECT(assert_equal(expected, actual));
+  }
+
   // CUSTOM
   CHECK_EXCEPTION(Ordering::Create(Ordering::CUSTOM, symbolicGraph), runtime_error);
 }
@@ -0,0 +1,226 @@
+/* ----------------------------------------------------------------------------
+
+ * GTSAM Copyright 2010, Georgia Tech Research Corporation,
+ * Atlanta, Georgia 30332-0415
+ * All Rights Reserved
+ * Authors: Frank Dellaert, et al. (see THANKS for the full author list)
+
+ * See LICENSE for the license information
+
+ * -------------------------------------------------------------------------- */
+
+/**
+ * @file    ContiguousVectorValues.cpp
+ * @brief   VectorValues stored in a single contiguous vector
+ */
+
+#include <gtsam/linear/ContiguousVectorValues.h>
+
+#include <algorithm>
+#include <iostream>
+#include <stdexcept>
+
+namespace gtsam {
+
+/* ************************************************************************* */
+ContiguousVectorValues::Layout::Layout(const VectorValues::Dims& dims) {
+  keys_.reserve(dims.size());
+  offsets_.reserve(dims.size() + 1);
+  offsets_.push_back(0);
+  for (const auto& [key, dim] : dims) {
+    keys_.push_back(key);
+    offsets_.push_back(offsets_.back() + dim);
+  }
+  buildLookup();
+}
+
+/* ************************************************************************* */
+ContiguousVectorValues::Layout::Layout(const VectorValues& values) {
+  std::vector<std::pair<Key, size_t>> keyDims;
+  keyDims.reserve(values.size());
+  for (const auto& [key, value] : values) keyDims.emplace_back(key, value.size());
+  std::sort(keyDims.begin(), keyDims.end());
+
+  keys_.reserve(keyDims.size());
+  offsets_.reserve(keyDims.size() + 1);
+  offsets_.push_back(0);
+  for (const auto& [key, dim] : keyDims) {
+    keys_.push_back(key);
+    offsets_.push_back(offsets_.back() + dim);
+  }
+  buildLookup();
+}
+
+/* ************************************************************************* */
+ContiguousVectorValues::Layout::Layout(const KeyVector& keys,
+                                       const std::vector<size_t>& dims)
+    : keys_(keys) {
+  if (keys.size() != dims.size())
+    throw std::invalid_argument(
+        "ContiguousVectorValues::Layout: keys and dims differ in size");
+  offsets_.reserve(dims.size() + 1);
+  offsets_.push_back(0);
+  for (size_t dim : dims) offsets_.push_back(offsets_.back() + dim);
+  buildLookup();
+  for (size_t i = 1; i < lookup_.size(); ++i) {
+    if (lookup_[i - 1].first == lookup_[i].first)
+      throw std::invalid_argument(
+          "ContiguousVectorValues::Layout: duplicate key " +
+          DefaultKeyFormatter(lookup_[i].first));
+  }
+}
+
+/* ************************************************************************* */
+void ContiguousVectorValues::Layout::buildLookup() {
+  lookup_.reserve(keys_.size());
+  for (size_t i = 0; i < keys_.size(); ++i) lookup_.emplace_back(keys_[i], i);
+  std::sort(lookup_.begin(), lookup_.end());
+}
+
+/* ************************************************************************* */
+bool ContiguousVectorValues::Layout::exists(Key j) const {
+  const auto it = std::lower_bound(lookup_.begin(), lookup_.end(),
+                                   std::make_pair(j, size_t(0)));
+  return it != lookup_.end() && it->first == j;
+}
+
+/* ************************************************************************* */
+size_t ContiguousVectorValues::Layout::index(Key j) const {
+  const auto it = std::lower_bound(lookup_.begin(), lookup_.end(),
+                                   std::make_pair(j, size_t(0)));
+  if (it == lookup_.end() || it->first != j)
+    throw std::out_of_range("Requested variable '" + DefaultKeyFormatter(j) +
+                            "' is not in this ContiguousVectorValues.");
+  return it->second;
+}
+
+/* ************************************************************************* */
+VectorValues::Dims ContiguousVectorValues::Layout::dims() const {
+  VectorValues::Dims result;
+  for (size_t i = 0; i < keys_.size(); ++i)
+    result.emplace(keys_[i], offsets_[i + 1] - offsets_[i]);
+  return result;
+}
+
+/* ************************************************************************* */
+ContiguousVectorValues::ContiguousVectorValues(const Layout::shared_ptr& layout,
+                                               const Vector& vector)
+    : layout_(layout), vector_(vector) {
+  if (static_cast<size_t>(vector.size()) != layout->dim())
+    throw std::invalid_argument(
+        "ContiguousVectorValues: vector dimension does not match the layout");
+}
+
+/* ************************************************************************* */
+ContiguousVectorValues::ContiguousVectorValues(const VectorValues& values)
+    : ContiguousVectorValues(values, std::make_shared<const Layout>(values)) {}
+
+/* ************************************************************************* */
+ContiguousVectorValues::ContiguousVectorValues(const VectorValues& values,
+                                               const Layout::shared_ptr& layout)
+    : layout_(layout), vector_(layout->dim()) {
+  if (values.size() != layout->size())
+    throw std::invalid_argument(
+        "ContiguousVectorValues: VectorValues does not match the layout");
+  const KeyVector& keys = layout->keys();
+  const std::vector<size_t>& offsets = layout->offsets();
+  for (size_t i = 0; i < keys.size(); ++i) {
+    const Vector& value = values.at(keys[i]);
+    const size_t dim = offsets[i + 1] - offsets[i];
+    if (static_cast<size_t>(value.size()) != dim)
+      throw std::invalid_argument(
+          "ContiguousVectorValues: VectorValues does not match the layout");
+    vector_.segment(offsets[i], dim) = value;
+  }
+}
+
+/* ************************************************************************* */
+VectorValues ContiguousVectorValues::vectorValues() const {
+  VectorValues result;
+  const KeyVector& keys = layout_->keys();
+  const std::vector<size_t>& offsets = layout_->offsets();
+  for (size_t i = 0; i < keys.size(); ++i)
+    result.emplace(keys[i],
+                   vector_.segment(offsets[i], offsets[i + 1] - offsets[i]));
+  return result;
+}
+
+/* ************************************************************************* */
+void ContiguousVectorValues::print(const std::string& str,
+                                   const KeyFormatter& formatter) const {
+  std::cout << str << ": " << size() << " elements\n";
+  const KeyVector& keys = layout_->keys();
+  const std::vector<size_t>& offsets = layout_->offsets();
+  for (size_t i = 0; i < keys.size(); ++i)
+    std::cout << "  " << formatter(keys[i]) << ": "
+              << vector_.segment(offsets[i], offsets[i + 1] - offsets[i])
+                     .transpose()
+              << "\n";
+  std::cout.flush();
+}
+
+/* ************************************************************************* */
+bool ContiguousVectorValues::equals(const ContiguousVectorValues& x,
+                                    double tol) const {
+  return hasSameLayout(x) && equal_with_abs_tol(vector_, x.vector_, tol);
+}
+
+/* ************************************************************************* */
+void ContiguousVectorValues::checkLayout(const ContiguousVectorValues& other,
+                                         const char* function) const {
+  if (!hasSameLayout(other))
+    throw std::invalid_argument(
+        std::string("ContiguousVectorValues::") + function +
+        " called with a ContiguousVectorValues of different structure");
+}
+
+/* ************************************************************************* */
+double ContiguousVectorValues::dot(const ContiguousVectorValues& v) const {
+  checkLayout(v, "dot");
+  return vector_.dot(v.vector_);
+}
+
+/* ************************************************************************* */
+ContiguousVectorValues ContiguousVectorValues::operator+(
+    const ContiguousVectorValues& c) const {
+  checkLayout(c, "operator+");
+  return ContiguousVectorValues(layout_, vector_ + c.vector_);
+}
+
+/* ************************************************************************* */
+ContiguousVectorValues ContiguousVectorValues::operator-(
+    const ContiguousVectorValues& c) const {
+  checkLayout(c, "operator-");
+  return ContiguousVectorValues(layout_, vector_ - c.vector_);
+}
+
+/* ************************************************************************* */
+ContiguousVectorValues& ContiguousVectorValues::operator+=(
+    const ContiguousVectorValues& c) {
+  checkLayout(c, "operator+=");
+  vector_ += c.vector_;
+  return *this;
+}
+
+/* ************************************************************************* */
+ContiguousVectorValues& ContiguousVectorValues::operator-=(
+    const ContiguousVectorValues& c) {
+  checkLayout(c, "operator-=");
+  vector_ -= c.vector_;
+  return *this;
+}
+
+/* ************************************************************************* */
+ContiguousVectorValues operator*(double a, const ContiguousVectorValues& v) {
+  return ContiguousVectorValues(v.layout_, a * v.vector_);
+}
+
+/* ************************************************************************* */
+ContiguousVectorValues& ContiguousVectorValues::axpy(
+    double alpha, const ContiguousVectorValues& x) {
+  checkLayout(x, "axpy");
+  vector_.noalias() += alpha * x.vector_;
+  return *this;
+}
+
+}  // namespace gtsam
@@ -0,0 +1,254 @@
+/* ----------------------------------------------------------------------------
+
+ * GTSAM Copyright 2010, Georgia Tech Research Corporation,
+ * Atlanta, Georgia 30332-0415
+ * All Rights Reserved
+ * Authors: Frank Dellaert, et al. (see THANKS for the full author list)
+
+ * See LICENSE for the license information
+
+ * -------------------------------------------------------------------------- */
+
+/**
+ * @file    ContiguousVectorValues.h
+ * @brief   VectorValues stored in a single contiguous vector
+ */
+
+#pragma once
+
+#include <gtsam/linear/VectorValues.h>
+
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace gtsam {
+
+/**
+ * A collection of keyed vectors, like VectorValues, but with all blocks stored
+ * one after the other in a single contiguous Vector.
+ *
+ * The key-to-offset index (the Layout) is immutable and shared by all
+ * instances with the same structure, so copying a ContiguousVectorValues only
+ * copies one Vector, and element-wise operations, dot products and norms are
+ * single Eigen expressions over the whole vector instead of a walk over a map
+ * of separately allocated blocks. This makes it a good fit for the inner loops
+ * of iterative methods that repeatedly combine vectors of the same structure.
+ *
+ * Blocks are stored in increasing key order, unless the layout is built from
+ * an explicit key order, e.g. the elimination ordering of an iterative solver.
+ * Binary operations require both operands to have the same layout and throw
+ * std::invalid_argument otherwise.
+ */
+class GTSAM_EXPORT ContiguousVectorValues {
+ public:
+  /**
+   * Immutable index from keys to the position of their blocks in the
+   * contiguous vector. Lookups are binary searches in a sorted copy of the
+   * keys.
+   */
+  class GTSAM_EXPORT Layout {
+   public:
+    typedef std::shared_ptr<const Layout> shared_ptr;
+
+    /// Empty layout
+    Layout() : offsets_(1, 0) {}
+
+    /// Layout from keyed dimensions
+    explicit Layout(const VectorValues::Dims& dims);
+
+    /// Layout with the keys and dimensions of a VectorValues
+    explicit Layout(const VectorValues& values);
+
+    /// Layout with blocks stored in the given key order, with dimensions dims
+    Layout(const KeyVector& keys, const std::vector<size_t>& dims);
+
+    /// Number of blocks
+    size_t size() const { return keys_.size(); }
+
+    /// Total dimension of all blocks
+    size_t dim() const { return offsets_.back(); }
+
+    /// The keys, in storage order
+    const KeyVector& keys() const { return keys_; }
+
+    /// Whether a block with key \c j exists
+    bool exists(Key j) const;
+
+    /// Offset of block \c j, throws std::out_of_range if \c j does not exist
+    size_t offset(Key j) const { return offsets_[index(j)]; }
+
+    /// Dimension of block \c j, throws std::out_of_range if \c j does not exist
+    size_t dim(Key j) const {
+      const size_t i = index(j);
+      return offsets_[i + 1] - offsets_[i];
+    }
+
+    /// Position of block \c j in keys(), throws std::out_of_range if absent
+    size_t index(Key j) const;
+
+    /// Offsets of all blocks, one more than size() with dim() at the end
+    const std::vector<size_t>& offsets() const { return offsets_; }
+
+    /// Keyed dimensions, e.g. to build a VectorValues
+    VectorValues::Dims dims() const;
+
+    /// Same keys and dimensions
+    bool operator==(const Layout& other) const {
+      return keys_ == other.keys_ && offsets_ == other.offsets_;
+    }
+
+   private:
+    void buildLookup();
+
+    KeyVector keys_;
+    std::vector<size_t> offsets_;
+    std::vector<std::pair<Key, size_t>> lookup_;  // (key, index), sorted
+  };
+
+  typedef ContiguousVectorValues This;
+  typedef std::shared_ptr<This> shared_ptr;
+  typedef Eigen::VectorBlock<Vector> Block;
+  typedef Eigen::VectorBlock<const Vector> ConstBlock;
+
+  /// @name Constructors
+  /// @{
+
+  /// Empty ContiguousVectorValues
+  ContiguousVectorValues()
+      : layout_(std::make_shared<const Layout>()), vector_(0) {}
+
+  /// Zero-initialized values with the given layout
+  explicit ContiguousVectorValues(const Layout::shared_ptr& layout)
+      : layout_(layout), vector_(Vector::Zero(layout->dim())) {}
+
+  /// Values with the given layout and data, dimensions have to match
+  ContiguousVectorValues(const Layout::shared_ptr& layout, const Vector& vector);
+
+  /// Copy the blocks of a VectorValues into a new layout
+  explicit ContiguousVectorValues(const VectorValues& values);
+
+  /// Copy the blocks of a VectorValues into an existing layout, which must
+  /// have the same keys and dimensions
+  ContiguousVectorValues(const VectorValues& values,
+                         const Layout::shared_ptr& layout);
+
+  /// Zero-initialized values with the same layout as \c other
+  static ContiguousVectorValues Zero(const ContiguousVectorValues& other) {
+    return ContiguousVectorValues(other.layout_);
+  }
+
+  /// @}
+  /// @name Standard Interface
+  /// @{
+
+  /// The shared key-to-offset index
+  const Layout::shared_ptr& layout() const { return layout_; }
+
+  /// Number of blocks
+  size_t size() const { return layout_->size(); }
+
+  /// Total dimension
+  size_t dim() const { return layout_->dim(); }
+
+  /// Whether a block with key \c j exists
+  bool exists(Key j) const { return layout_->exists(j); }
+
+  /// Read/write access to block \c j, throws std::out_of_range if absent
+  Block at(Key j) {
+    const size_t i = layout_->index(j);
+    const std::vector<size_t>& offsets = layout_->offsets();
+    return vector_.segment(offsets[i], offsets[i + 1] - offsets[i]);
+  }
+
+  /// Access to block \c j, throws std::out_of_range if absent
+  ConstBlock at(Key j) const {
+    const size_t i = layout_->index(j);
+    const std::vector<size_t>& offsets = layout_->offsets();
+    return vector_.segment(offsets[i], offsets[i + 1] - offsets[i]);
+  }
+
+  /// Read/write access to block \c j, identical to at(Key)
+  Block operator[](Key j) { return at(j); }
+
+  /// Access to block \c j, identical to at(Key)
+  ConstBlock operator[](Key j) const { return at(j); }
+
+  /// The contiguous vector holding all blocks in layout order
+  const Vector& vector() const { return vector_; }
+
+  /// Read/write access to the contiguous vector, its size must not change
+  Vector& vector() { return vector_; }
+
+  /// Copy into a VectorValues
+  VectorValues vectorValues() const;
+
+  /// Set all entries to zero
+  void setZero() { vector_.setZero(); }
+
+  /// Whether \c other has the same keys and dimensions
+  bool hasSameLayout(const ContiguousVectorValues& other) const {
+    return layout_ == other.layout_ || *layout_ == *other.layout_;
+  }
+
+  /// print required by Testable for unit testing
+  void print(const std::string& str = "ContiguousVectorValues",
+             const KeyFormatter& formatter = DefaultKeyFormatter) const;
+
+  /// equals required by Testable for unit testing
+  bool equals(const ContiguousVectorValues& x, double tol = 1e-9) const;
+
+  /// @}
+  /// @name Linear algebra operations
+  /// @{
+
+  /// Dot product with values of the same layout
+  double dot(const ContiguousVectorValues& v) const;
+
+  /// Vector L2 norm
+  double norm() const { return vector_.norm(); }
+
+  /// Squared vector L2 norm
+  double squaredNorm() const { return vector_.squaredNorm(); }
+
+  /// Element-wise addition
+  ContiguousVectorValues operator+(const ContiguousVectorValues& c) const;
+
+  /// Element-wise subtraction
+  ContiguousVectorValues operator-(const ContiguousVectorValues& c) const;
+
+  /// Element-wise addition in-place
+  ContiguousVectorValues& operator+=(const ContiguousVectorValues& c);
+
+  /// Element-wise subtraction in-place
+  ContiguousVectorValues& operator-=(const ContiguousVectorValues& c);
+
+  /// Element-wise scaling by a constant
+  friend GTSAM_EXPORT ContiguousVectorValues operator*(
+      double a, const ContiguousVectorValues& v);
+
+  /// Element-wise scaling by a constant in-place
+  ContiguousVectorValues& operator*=(double alpha) {
+    vector_ *= alpha;
+    return *this;
+  }
+
+  /// this += alpha * x, without temporaries
+  ContiguousVectorValues& axpy(double alpha, const ContiguousVectorValues& x);
+
+  /// @}
+
+ private:
+  void checkLayout(const ContiguousVectorValues& other,
+                   const char* function) const;
+
+  Layout::shared_ptr layout_;
+  Vector vector_;
+};
+
+/// traits
+template <>
+struct traits<ContiguousVectorValues>
+    : public Testable<ContiguousVectorValues> {};
+
+}  // namespace gtsam
@@ -28,6 +28,12 @@
 #include <gtsam/base/debug.h>
 #include <gtsam/base/timing.h>
 #include <gtsam/base/cholesky.h>
+#include <gtsam/config.h> // for GTSAM_USE_TBB
+#include <algorithm>
+
+#ifdef GTSAM_USE_TBB
+#include <tbb/parallel_for.h>
+#endif
 
 using namespace std;
 using namespace gtsam;
@@ -38,6 +44,46 @@ namespace gtsam {
   template class FactorGraph<GaussianFactor>;
   template class EliminateableFactorGraph<GaussianFactorGraph>;
 
+  /* ************************************************************************* */
+  namespace {
+  // Compute f(i) for all factor indices, in parallel when TBB is enabled.
+  // Callers combine the results in factor order, which keeps them identical
+  // to a serial loop regardless of scheduling.
+  template <typename RESULT, typename FUNCTION>
+  std::vector<RESULT> evaluateFactors(size_t n, const FUNCTION& f) {
+    std::vector<RESULT> results(n);
+#ifdef GTSAM_USE_TBB
+    tbb::parallel_for(tbb::blocked_range<size_t>(0, n),
+                      [&](const tbb::blocked_range<size_t>& range) {
+                        for (size_t i = range.begin(); i != range.end(); ++i)
+                          results[i] = f(i);
+                      });
+#else
+    for (size_t i = 0; i < n; ++i) results[i] = f(i);
+#endif
+    return results;
+  }
+
+  // Accumulate f(i, partial) for all factor indices into one VectorValues per
+  // chunk of factors, in parallel when TBB is enabled, and add the partial sums
+  // to `result` in chunk order. The chunks depend only on n, so the result does
+  // not depend on the number of threads, and only a few partial sums are held.
+  template <typename FUNCTION>
+  void accumulateFactors(size_t n, const FUNCTION& f, VectorValues* result) {
+    static const size_t kMaxChunks = 16, kMinChunkSize = 64;
+    const size_t nrChunks =
+        std::max<size_t>(1, std::min(kMaxChunks, n / kMinChunkSize));
+    const std::vector<VectorValues> partials =
+        evaluateFactors<VectorValues>(nrChunks, [&](size_t c) {
+          VectorValues partial;
+          for (size_t i = c * n / nrChunks; i < (c + 1) * n / nrChunks; ++i)
+            f(i, &partial);
+          return partial;
+        });
+    for (const VectorValues& partial : partials) result->addInPlace_(partial);
+  }
+  }  // namespace
+
   /* ************************************************************************* */
   bool GaussianFactorGraph::equals(const This& fg, double tol) const
   {
@@ -69,11 +115,12 @@ namespace gtsam {
 
   /* ************************************************************************* */
   double GaussianFactorGraph::error(const VectorValues& x) const {
+    const std::vector<double> errors =
+        evaluateFactors<double>(size(), [&](size_t i) {
+          return factors_[i] ? factors_[i]->error(x) : 0.0;
+        });
     double total_error = 0.;
-    for(const sharedFactor& factor: *this){
-      if(factor)
-        total_error += factor->error(x);
-    }
+    for (double error : errors) total_error += error;
     return total_error;
   }
 
@@ -356,12 +403,13 @@ namespace gtsam {
   /* ************************************************************************* */
   VectorValues GaussianFactorGraph::gradient(const VectorValues& x0) const
   {
+    // Sum of the contributions A_i^T (A_i x0 - b_i) of all factors
     VectorValues g = VectorValues::Zero(x0);
-    for (const sharedFactor& factor: *this) {
-      JacobianFactor::shared_ptr Ai = convertToJacobianFactorPtr(factor);
-      Vector e = Ai->error_vector(x0);
-      Ai->transposeMultiplyAdd(1.0, e, g);
-    }
+    accumulateFactors(size(), [&](size_t i, VectorValues* partial) {
+      if (!factors_[i]) return;
+      JacobianFactor::shared_ptr Ai = convertToJacobianFactorPtr(factors_[i]);
+      Ai->transposeMultiplyAdd(1.0, Ai->error_vector(x0), *partial);
+    }, &g);
     return g;
   }
 
@@ -369,11 +417,9 @@ namespace gtsam {
   VectorValues GaussianFactorGraph::gradientAtZero() const {
     // Zero-out the gradient
     VectorValues g;
-    for (const sharedFactor& factor: *this) {
-      if (!factor) continue;
-      VectorValues gi = factor->gradientAtZero();
-      g.addInPlace_(gi);
-    }
+    accumulateFactors(size(), [&](size_t i, VectorValues* partial) {
+      if (factors_[i]) partial->addInPlace_(factors_[i]->gradientAtZero());
+    }, &g);
     return g;
   }
 
@@ -511,12 +557,11 @@ namespace gtsam {
   /* ************************************************************************* */
   Errors GaussianFactorGraph::gaussianErrors(const VectorValues& x) const
   {
-    Errors e;
-    for (const sharedFactor& factor: *this) {
-      JacobianFactor::shared_ptr Ai = convertToJacobianFactorPtr(factor);
-      e.push_back(Ai->error_vector(x));
-    }
-    return e;
+    const std::vector<Vector> errors =
+        evaluateFactors<Vector>(size(), [&](size_t i) {
+          return convertToJacobianFactorPtr(factors_[i])->error_vector(x);
+        });
+    return Errors(errors.begin(), errors.end());
   }
 
   /* ************************************************************************* */
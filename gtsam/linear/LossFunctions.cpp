@@ -32,14 +32,28 @@ namespace noiseModel {
 
 namespace mEstimator {
 
-Vector Base::weight(const Vector& error) const {
-  const size_t n = error.rows();
+typedef Eigen::ArrayXd Array;
+
+Vector Base::weights(const Vector& distances) const {
+  const size_t n = distances.rows();
   Vector w(n);
   for (size_t i = 0; i < n; ++i)
-    w(i) = weight(error(i));
+    w(i) = weight(distances(i));
   return w;
 }
 
+Vector Base::losses(const Vector& distances) const {
+  const size_t n = distances.rows();
+  Vector rho(n);
+  for (size_t i = 0; i < n; ++i)
+    rho(i) = loss(distances(i));
+  return rho;
+}
+
+Vector Base::weight(const Vector& error) const {
+  return weights(error);
+}
+
 Vector Base::sqrtWeight(const Vector &error) const {
   return weight(error).cwiseSqrt();
 }
@@ -132,6 +146,14 @@ void Null::print(const std::string &s="") const
 Null::shared_ptr Null::Create()
 { return shared_ptr(new Null()); }
 
+Vector Null::weights(const Vector& distances) const {
+  return Vector::Ones(distances.size());
+}
+
+Vector Null::losses(const Vector& distances) const {
+  return 0.5 * distances.array().square();
+}
+
 /* ************************************************************************* */
 // Fair
 /* ************************************************************************* */
@@ -153,6 +175,15 @@ double Fair::loss(double distance) const {
   return c_2 * (normalizedError - std::log1p(normalizedError));
 }
 
+Vector Fair::weights(const Vector& distances) const {
+  return (1.0 + distances.array().abs() / c_).inverse();
+}
+
+Vector Fair::losses(const Vector& distances) const {
+  const Array normalizedError = distances.array().abs() / c_;
+  return c_ * c_ * (normalizedError - normalizedError.log1p());
+}
+
 void Fair::print(const std::string &s="") const
 { cout << s << "fair (" << c_ << ")" << endl; }
 
@@ -189,6 +220,17 @@ double Huber::loss(double distance) const {
   }
 }
 
+Vector Huber::weights(const Vector& distances) const {
+  const Array absError = distances.array().abs();
+  return (absError <= k_).select(1.0, k_ / absError);
+}
+
+Vector Huber::losses(const Vector& distances) const {
+  const Array absError = distances.array().abs();
+  return (absError <= k_).select(0.5 * absError.square(),
+                                 k_ * (absError - (k_ / 2)));
+}
+
 void Huber::print(const std::string &s="") const {
   cout << s << "huber (" << k_ << ")" << endl;
 }
@@ -222,6 +264,14 @@ double Cauchy::loss(double distance) const {
   return ksquared_ * val * 0.5;
 }
 
+Vector Cauchy::weights(const Vector& distances) const {
+  return ksquared_ / (ksquared_ + distances.array().square());
+}
+
+Vector Cauchy::losses(const Vector& distances) const {
+  return ksquared_ * 0.5 * (distances.array().square() / ksquared_).log1p();
+}
+
 void Cauchy::print(const std::string &s="") const {
   cout << s << "cauchy (" << k_ << ")" << endl;
 }
@@ -265,6 +315,17 @@ double Tukey::loss(double distance) const {
   }
 }
 
+Vector Tukey::weights(const Vector& distances) const {
+  const Array one_minus_xc2 = 1.0 - distances.array().square() / csquared_;
+  return (distances.array().abs() <= c_).select(one_minus_xc2.square(), 0.0);
+}
+
+Vector Tukey::losses(const Vector& distances) const {
+  const Array one_minus_xc2 = 1.0 - distances.array().square() / csquared_;
+  return (distances.array().abs() <= c_)
+      .select(csquared_ * (1 - one_minus_xc2.cube()) / 6.0, csquared_ / 6.0);
+}
+
 void Tukey::print(const std::string &s="") const {
   std::cout << s << ": Tukey (" << c_ << ")" << std::endl;
 }
@@ -295,6 +356,14 @@ double Welsch::loss(double distance) const {
   return csquared_ * 0.5 * -std::expm1(-xc2);
 }
 
+Vector Welsch::weights(const Vector& distances) const {
+  return (-distances.array().square() / csquared_).exp();
+}
+
+Vector Welsch::losses(const Vector& distances) const {
+  return csquared_ * 0.5 * -(-distances.array().square() / csquared_).expm1();
+}
+
 void Welsch::print(const std::string &s="") const {
   std::cout << s << ": Welsch (" << c_ << ")" << std::endl;
 }
@@ -329,6 +398,18 @@ double GemanMcClure::loss(double distance) const {
   return 0.5 * (c2 * error2) / (c2 + error2);
 }
 
+Vector GemanMcClure::weights(const Vector& distances) const {
+  const double c2 = c_*c_;
+  const double c4 = c2*c2;
+  return c4 / (c2 + distances.array().square()).square();
+}
+
+Vector GemanMcClure::losses(const Vector& distances) const {
+  const double c2 = c_*c_;
+  const Array error2 = distances.array().square();
+  return 0.5 * (c2 * error2) / (c2 + error2);
+}
+
 void GemanMcClure::print(const std::string &s="") const {
   std::cout << s << ": Geman-McClure (" << c_ << ")" << std::endl;
 }
@@ -371,6 +452,17 @@ double DCS::loss(double distance) const {
   return (c2*e2 + c_*e4) / ((e2 + c_)*(e2 + c_));
 }
 
+Vector DCS::weights(const Vector& distances) const {
+  const Array e2 = distances.array().square();
+  return (e2 > c_).select((2.0 * c_ / (c_ + e2)).square(), 1.0);
+}
+
+Vector DCS::losses(const Vector& distances) const {
+  const Array e2 = distances.array().square();
+  const double c2 = c_*c_;
+  return (c2 * e2 + c_ * e2.square()) / (e2 + c_).square();
+}
+
 void DCS::print(const std::string &s="") const {
   std::cout << s << ": DCS (" << c_ << ")" << std::endl;
 }
@@ -410,6 +502,17 @@ double L2WithDeadZone::loss(double distance) const {
   return (abs_error < k_) ? 0.0 : 0.5*(k_-abs_error)*(k_-abs_error);
 }
 
+Vector L2WithDeadZone::weights(const Vector& distances) const {
+  // on either side of the dead zone, the weight is (|x| - k) / |x|
+  const Array abs_error = distances.array().abs();
+  return (abs_error <= k_).select(0.0, (abs_error - k_) / abs_error);
+}
+
+Vector L2WithDeadZone::losses(const Vector& distances) const {
+  const Array abs_error = distances.array().abs();
+  return (abs_error < k_).select(0.0, 0.5 * (k_ - abs_error).square());
+}
+
 void L2WithDeadZone::print(const std::string &s="") const {
   std::cout << s << ": L2WithDeadZone (" << k_ << ")" << std::endl;
 }
@@ -110,6 +110,17 @@ class GTSAM_EXPORT Base {
   virtual void print(const std::string &s) const = 0;
   virtual bool equals(const Base &expected, double tol = 1e-8) const = 0;
 
+  /**
+   * Weights w(x) of many distances at once. The default calls weight(double)
+   * for each of them, the m-estimators below evaluate a single Eigen array
+   * expression instead. Used to reweight all robust factors of a graph in one
+   * pass, see NonlinearFactorGraph::linearize.
+   */
+  virtual Vector weights(const Vector &distances) const;
+
+  /// Losses \rho(x) of many distances at once, see weights()
+  virtual Vector losses(const Vector &distances) const;
+
   double sqrtWeight(double distance) const { return std::sqrt(weight(distance)); }
 
   /** produce a weight vector according to an error vector and the implemented
@@ -155,6 +166,8 @@ class GTSAM_EXPORT Null : public Base {
   ~Null() override {}
   double weight(double /*error*/) const override { return 1.0; }
   double loss(double distance) const override { return 0.5 * distance * distance; }
+  Vector weights(const Vector &distances) const override;
+  Vector losses(const Vector &distances) const override;
   void print(const std::string &s) const override;
   bool equals(const Base & /*expected*/, double /*tol*/) const override { return true; }
   static shared_ptr Create();
@@ -188,6 +201,8 @@ class GTSAM_EXPORT Fair : public Base {
   Fair(double c = 1.3998, const ReweightScheme reweight = Block);
   double weight(double distance) const override;
   double loss(double distance) const override;
+  Vector weights(const Vector &distances) const override;
+  Vector losses(const Vector &distances) const override;
   void print(const std::string &s) const override;
   bool equals(const Base &expected, double tol = 1e-8) const override;
   static shared_ptr Create(double c, const ReweightScheme reweight = Block);
@@ -223,6 +238,8 @@ class GTSAM_EXPORT Huber : public Base {
   Huber(double k = 1.345, const ReweightScheme reweight = Block);
   double weight(double distance) const override;
   double loss(double distance) const override;
+  Vector weights(const Vector &distances) const override;
+  Vector losses(const Vector &distances) const override;
   void print(const std::string &s) const override;
   bool equals(const Base &expected, double tol = 1e-8) const override;
   static shared_ptr Create(double k, const ReweightScheme reweight = Block);
@@ -263,6 +280,8 @@ class GTSAM_EXPORT Cauchy : public Base {
   Cauchy(double k = 0.1, const ReweightScheme reweight = Block);
   double weight(double distance) const override;
   double loss(double distance) const override;
+  Vector weights(const Vector &distances) const override;
+  Vector losses(const Vector &distances) const override;
   void print(const std::string &s) const override;
   bool equals(const Base &expected, double tol = 1e-8) const override;
   static shared_ptr Create(double k, const ReweightScheme reweight = Block);
@@ -299,6 +318,8 @@ class GTSAM_EXPORT Tukey : public Base {
   Tukey(double c = 4.6851, const ReweightScheme reweight = Block);
   double weight(double distance) const override;
   double loss(double distance) const override;
+  Vector weights(const Vector &distances) const override;
+  Vector losses(const Vector &distances) const override;
   void print(const std::string &s) const override;
   bool equals(const Base &expected, double tol = 1e-8) const override;
   static shared_ptr Create(double k, const ReweightScheme reweight = Block);
@@ -334,6 +355,8 @@ class GTSAM_EXPORT Welsch : public Base {
   Welsch(double c = 2.9846, const ReweightScheme reweight = Block);
   double weight(double distance) const override;
   double loss(double distance) const override;
+  Vector weights(const Vector &distances) const override;
+  Vector losses(const Vector &distances) const override;
   void print(const std::string &s) const override;
   bool equals(const Base &expected, double tol = 1e-8) const override;
   static shared_ptr Create(double k, const ReweightScheme reweight = Block);
@@ -370,6 +393,8 @@ class GTSAM_EXPORT GemanMcClure : public Base {
   ~GemanMcClure() override {}
   double weight(double distance) const override;
   double loss(double distance) const override;
+  Vector weights(const Vector &distances) const override;
+  Vector losses(const Vector &distances) const override;
   void print(const std::string &s) const override;
   bool equals(const Base &expected, double tol = 1e-8) const override;
   static shared_ptr Create(double k, const ReweightScheme reweight = Block);
@@ -410,6 +435,8 @@ class GTSAM_EXPORT DCS : public Base {
   ~DCS() override {}
   double weight(double distance) const override;
   double loss(double distance) const override;
+  Vector weights(const Vector &distances) const override;
+  Vector losses(const Vector &distances) const override;
   void print(const std::string &s) const override;
   bool equals(const Base &expected, double tol = 1e-8) const override;
   static shared_ptr Create(double k, const ReweightScheme reweight = Block);
@@ -453,6 +480,8 @@ class GTSAM_EXPORT L2WithDeadZone : public Base {
   L2WithDeadZone(double k = 1.0, const ReweightScheme reweight = Block);
   double weight(double distance) const override;
   double loss(double distance) const override;
+  Vector weights(const Vector &distances) const override;
+  Vector losses(const Vector &distances) const override;
   void print(const std::string &s) const override;
   bool equals(const Base &expected, double tol = 1e-8) const override;
   static shared_ptr Create(double k, const ReweightScheme reweight = Block);
@@ -19,6 +19,7 @@
 
 #include <gtsam/linear/PCGSolver.h>
 #include <gtsam/linear/GaussianFactorGraph.h>
+#include <gtsam/linear/JacobianFactor.h>
 #include <gtsam/linear/Preconditioner.h>
 #include <gtsam/linear/VectorValues.h>
 
@@ -66,7 +67,7 @@ VectorValues PCGSolver::optimize(const GaussianFactorGraph &gfg,
   Vector x0 = initial.vector(keyInfo.ordering());
   const Vector sol = preconditionedConjugateGradient(system, x0, parameters_);
 
-  return buildVectorValues(sol, keyInfo);
+  return ContiguousVectorValues(system.layout(), sol).vectorValues();
 }
 
 /*****************************************************************************/
@@ -75,6 +76,21 @@ GaussianFactorGraphSystem::GaussianFactorGraphSystem(
     const KeyInfo &keyInfo, const std::map<Key, Vector> &lambda) :
     gfg_(gfg), preconditioner_(preconditioner), keyInfo_(keyInfo), lambda_(
         lambda) {
+  layout_ = std::make_shared<const ContiguousVectorValues::Layout>(
+      keyInfo.ordering(), keyInfo.colSpec());
+
+  jacobians_.resize(gfg.size(), nullptr);
+  jacobianOffsets_.resize(gfg.size());
+  for (size_t i = 0; i < gfg.size(); ++i) {
+    if (!gfg[i]) continue;
+    jacobians_[i] = dynamic_cast<const JacobianFactor *>(gfg[i].get());
+    if (!jacobians_[i]) {
+      hasOtherFactors_ = true;
+      continue;
+    }
+    for (Key key : gfg[i]->keys())
+      jacobianOffsets_[i].push_back(layout_->offset(key));
+  }
 }
 
 /*****************************************************************************/
@@ -93,18 +109,40 @@ void GaussianFactorGraphSystem::residual(const Vector &x, Vector &r) const {
 /*****************************************************************************/
 void GaussianFactorGraphSystem::multiply(const Vector &x, Vector& AtAx) const {
   /* implement A^T*(A*x), assume x and AtAx are pre-allocated */
+  AtAx.setZero(layout_->dim());
+
+  // Jacobian factors read their blocks of x and add A'Ax in place, as in
+  // JacobianFactor::multiplyHessianAdd but without going through VectorValues
+  Vector Ax;
+  for (size_t i = 0; i < jacobians_.size(); ++i) {
+    const JacobianFactor *factor = jacobians_[i];
+    if (!factor) continue;
+    const std::vector<size_t> &offsets = jacobianOffsets_[i];
+    Ax.setZero(factor->rows());
+    for (size_t pos = 0; pos < offsets.size(); ++pos) {
+      const auto A = factor->getA(factor->begin() + pos);
+      Ax.noalias() += A * x.segment(offsets[pos], A.cols());
+    }
+    if (const auto &model = factor->get_model()) {
+      model->whitenInPlace(Ax);
+      model->whitenInPlace(Ax);
+    }
+    for (size_t pos = 0; pos < offsets.size(); ++pos) {
+      const auto A = factor->getA(factor->begin() + pos);
+      AtAx.segment(offsets[pos], A.cols()).noalias() += A.transpose() * Ax;
+    }
+  }
 
-  // Build a VectorValues for Vector x
-  VectorValues vvX = buildVectorValues(x, keyInfo_);
-
-  // VectorValues form of A'Ax for multiplyHessianAdd
-  VectorValues vvAtAx = keyInfo_.x0(); // crucial for performance
-
-  // vvAtAx += 1.0 * A'Ax for each factor
-  gfg_.multiplyHessianAdd(1.0, vvX, vvAtAx);
-
-  // Make the result as Vector form
-  AtAx = vvAtAx.vector(keyInfo_.ordering());
+  // Other factors go through VectorValues
+  if (hasOtherFactors_) {
+    const VectorValues vvX = buildVectorValues(x, keyInfo_);
+    VectorValues vvAtAx = keyInfo_.x0(); // crucial for performance
+    for (size_t i = 0; i < gfg_.size(); ++i) {
+      if (gfg_[i] && !jacobians_[i])
+        gfg_[i]->multiplyHessianAdd(1.0, vvX, vvAtAx);
+    }
+    AtAx += ContiguousVectorValues(vvAtAx, layout_).vector();
+  }
 }
 
 /*****************************************************************************/
@@ -20,11 +20,14 @@
 #pragma once
 
 #include <gtsam/linear/ConjugateGradientSolver.h>
+#include <gtsam/linear/ContiguousVectorValues.h>
 #include <string>
+#include <vector>
 
 namespace gtsam {
 
 class GaussianFactorGraph;
+class JacobianFactor;
 class KeyInfo;
 class Preconditioner;
 class VectorValues;
@@ -107,6 +110,19 @@ public:
   void axpy(const double alpha, const Vector &x, Vector &y) const;
 
   void getb(Vector &b) const;
+
+  /// Layout of the vectors x, y and b above, blocks in keyInfo order
+  const ContiguousVectorValues::Layout::shared_ptr &layout() const {
+    return layout_;
+  }
+
+private:
+  ContiguousVectorValues::Layout::shared_ptr layout_;
+  // Jacobian factors of gfg_ and the offsets of their blocks in x, so that
+  // multiply works on the contiguous vectors; null for other factors
+  std::vector<const JacobianFactor *> jacobians_;
+  std::vector<std::vector<size_t>> jacobianOffsets_;
+  bool hasOtherFactors_ = false;
 };
 
 /// @name utility functions
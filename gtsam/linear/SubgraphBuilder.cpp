@@ -36,6 +36,7 @@
 #include <fstream>
 #include <iomanip>
 #include <iostream>
+#include <limits>
 #include <numeric>  // accumulate
 #include <queue>
 #include <random>
@@ -140,6 +141,8 @@ SubgraphBuilderParameters::skeletonTranslator(const std::string &src) {
     return BFS;
   else if (s == "KRUSKAL")
     return KRUSKAL;
+  else if (s == "SHORTEST_PATH")
+    return SHORTEST_PATH;
   throw std::invalid_argument(
       "SubgraphBuilderParameters::skeletonTranslator undefined string " + s);
   return KRUSKAL;
@@ -153,6 +156,8 @@ std::string SubgraphBuilderParameters::skeletonTranslator(Skeleton s) {
     return "BFS";
   else if (s == KRUSKAL)
     return "KRUSKAL";
+  else if (s == SHORTEST_PATH)
+    return "SHORTEST_PATH";
   else
     return "UNKNOWN";
 }
@@ -233,6 +238,9 @@ vector<size_t> SubgraphBuilder::buildTree(const GaussianFactorGraph &gfg,
     case SubgraphBuilderParameters::KRUSKAL:
       return kruskal(gfg, weights);
       break;
+    case SubgraphBuilderParameters::SHORTEST_PATH:
+      return shortestPathTree(gfg, weights);
+      break;
     default:
       std::cerr << "SubgraphBuilder::buildTree undefined skeleton type" << endl;
       break;
@@ -311,6 +319,87 @@ vector<size_t> SubgraphBuilder::kruskal(const GaussianFactorGraph &gfg,
   return utils::kruskal(gfg, weights);
 }
 
+/****************************************************************/
+vector<size_t> SubgraphBuilder::shortestPathTree(
+    const GaussianFactorGraph &gfg, const vector<double> &weights) const {
+  // Adjacency lists over dense vertex ids, with the binary factors as edges
+  struct Neighbor {
+    size_t vertex, index;
+    double length;
+  };
+  FastMap<Key, size_t> vertices;
+  vector<vector<Neighbor>> adjacency;
+  const auto vertex = [&](Key key) {
+    const auto it = vertices.emplace(key, vertices.size());
+    if (it.second) adjacency.emplace_back();
+    return it.first->second;
+  };
+  for (size_t index = 0; index < gfg.size(); ++index) {
+    const auto &factor = gfg[index];
+    if (!factor || factor->size() != 2) continue;
+    const size_t u = vertex(factor->front()), v = vertex(factor->back());
+    // Heavy edges are short, so the tree prefers them like Kruskal does
+    const double length = 1.0 / std::max(weights[index], 1e-9);
+    adjacency[u].push_back({v, index, length});
+    adjacency[v].push_back({u, index, length});
+  }
+  const size_t n = adjacency.size();
+  if (n == 0) return {};
+
+  // Dijkstra from a root, recording the distance and tree edge of each vertex
+  const size_t none = std::numeric_limits<size_t>::max();
+  vector<double> distance;
+  vector<size_t> parentEdge, parentVertex;
+  const auto dijkstra = [&](size_t root) {
+    distance.assign(n, std::numeric_limits<double>::infinity());
+    parentEdge.assign(n, none);
+    parentVertex.assign(n, none);
+    typedef std::pair<double, size_t> Entry;
+    std::priority_queue<Entry, vector<Entry>, std::greater<Entry>> queue;
+    distance[root] = 0.0;
+    queue.emplace(0.0, root);
+    while (!queue.empty()) {
+      const auto [d, u] = queue.top();
+      queue.pop();
+      if (d > distance[u]) continue;
+      for (const Neighbor &neighbor : adjacency[u]) {
+        const double candidate = d + neighbor.length;
+        if (candidate < distance[neighbor.vertex]) {
+          distance[neighbor.vertex] = candidate;
+          parentEdge[neighbor.vertex] = neighbor.index;
+          parentVertex[neighbor.vertex] = u;
+          queue.emplace(candidate, neighbor.vertex);
+        }
+      }
+    }
+  };
+  const auto farthest = [&]() {
+    size_t result = 0;
+    for (size_t i = 1; i < n; ++i)
+      if (std::isfinite(distance[i]) && distance[i] > distance[result])
+        result = i;
+    return result;
+  };
+
+  // Root the tree at the middle of a long shortest path, found with two
+  // sweeps, which roughly halves the depth and thus the stretch of off-tree
+  // edges compared to rooting it at an arbitrary vertex.
+  dijkstra(0);
+  const size_t a = farthest();
+  dijkstra(a);
+  size_t center = farthest();
+  const double half = 0.5 * distance[center];
+  while (center != a && distance[parentVertex[center]] >= half)
+    center = parentVertex[center];
+  dijkstra(center);
+
+  vector<size_t> treeIndices;
+  treeIndices.reserve(n - 1);
+  for (size_t i = 0; i < n; ++i)
+    if (parentEdge[i] != none) treeIndices.push_back(parentEdge[i]);
+  return treeIndices;
+}
+
 /****************************************************************/
 vector<size_t> SubgraphBuilder::sample(const vector<double> &weights,
                                        const size_t t) const {
@@ -403,6 +492,46 @@ SubgraphBuilder::Weights SubgraphBuilder::weights(
   return weight;
 }
 
+/*****************************************************************************/
+Subgraph SubgraphCache::operator()(const GaussianFactorGraph &gfg,
+                                   const SubgraphBuilder &builder) {
+  if (cached_ && sameStructure(gfg)) return subgraph_;
+
+  subgraph_ = builder(gfg);
+  sizes_.clear();
+  keys_.clear();
+  sizes_.reserve(gfg.size());
+  for (const auto &factor : gfg) {
+    sizes_.push_back(factor ? factor->size() : 0);
+    if (factor) keys_.insert(keys_.end(), factor->begin(), factor->end());
+  }
+  cached_ = true;
+  return subgraph_;
+}
+
+/*****************************************************************************/
+void SubgraphCache::clear() {
+  cached_ = false;
+  sizes_.clear();
+  keys_.clear();
+  subgraph_ = Subgraph();
+}
+
+/*****************************************************************************/
+bool SubgraphCache::sameStructure(const GaussianFactorGraph &gfg) const {
+  if (gfg.size() != sizes_.size()) return false;
+  auto key = keys_.begin();
+  for (size_t i = 0; i < gfg.size(); ++i) {
+    const auto &factor = gfg[i];
+    const size_t size = factor ? factor->size() : 0;
+    if (size != sizes_[i]) return false;
+    if (factor && !std::equal(factor->begin(), factor->end(), key))
+      return false;
+    key += size;
+  }
+  return true;
+}
+
 /*****************************************************************************/
 GaussianFactorGraph buildFactorSubgraph(const GaussianFactorGraph &gfg,
                                         const Subgraph &subgraph,
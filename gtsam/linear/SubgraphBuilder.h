@@ -20,6 +20,7 @@
 #include <gtsam/base/FastMap.h>
 #include <gtsam/base/types.h>
 #include <gtsam/dllexport.h>
+#include <gtsam/inference/Key.h>
 
 #ifdef GTSAM_ENABLE_BOOST_SERIALIZATION
 #include <boost/serialization/version.hpp>
@@ -107,6 +108,8 @@ struct GTSAM_EXPORT SubgraphBuilderParameters {
     NATURALCHAIN = 0, /* natural ordering of the graph */
     BFS,              /* breadth-first search tree */
     KRUSKAL,          /* maximum weighted spanning tree */
+    SHORTEST_PATH,    /* shortest-path tree from a central variable, with edge
+                         lengths 1/weight, which has low stretch */
   } skeletonType;
 
   enum SkeletonWeight {            /* how to weigh the graph edges */
@@ -169,12 +172,46 @@ class GTSAM_EXPORT SubgraphBuilder {
   std::vector<size_t> bfs(const GaussianFactorGraph &gfg) const;
   std::vector<size_t> kruskal(const GaussianFactorGraph &gfg,
                               const std::vector<double> &weights) const;
+  std::vector<size_t> shortestPathTree(const GaussianFactorGraph &gfg,
+                                       const std::vector<double> &weights) const;
   std::vector<size_t> sample(const std::vector<double> &weights,
                              const size_t t) const;
   Weights weights(const GaussianFactorGraph &gfg) const;
   SubgraphBuilderParameters parameters_;
 };
 
+/*****************************************************************************/
+/**
+ * Remembers the subgraph built for one factor graph structure. Successive
+ * linearizations of a nonlinear problem have the same keys in every factor,
+ * and reusing their subgraph skips computing weights and a spanning tree.
+ * The subgraph still spans a graph with different values, it is just no
+ * longer chosen with the current weights. Not thread-safe.
+ */
+class GTSAM_EXPORT SubgraphCache {
+ public:
+  /**
+   * Return the cached subgraph if gfg has the structure it was built for,
+   * otherwise build one with the given builder and remember it.
+   */
+  Subgraph operator()(const GaussianFactorGraph &gfg,
+                      const SubgraphBuilder &builder);
+
+  /// Whether a subgraph is cached.
+  bool empty() const { return !cached_; }
+
+  /// Forget the cached subgraph.
+  void clear();
+
+ private:
+  bool sameStructure(const GaussianFactorGraph &gfg) const;
+
+  bool cached_ = false;
+  std::vector<size_t> sizes_;  ///< number of keys per factor, 0 if null
+  KeyVector keys_;             ///< keys of all factors, concatenated
+  Subgraph subgraph_;
+};
+
 /** Select the factors in a factor graph according to the subgraph. */
 GaussianFactorGraph buildFactorSubgraph(const GaussianFactorGraph &gfg,
                                         const Subgraph &subgraph,
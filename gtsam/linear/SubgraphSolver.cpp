@@ -82,7 +82,8 @@ SubgraphSolver::splitGraph(const GaussianFactorGraph &factorGraph) {
 
   /* identify the subgraph structure */
   const SubgraphBuilder builder(parameters_.builderParams);
-  auto subgraph = builder(factorGraph);
+  const auto &cache = parameters_.subgraphCache;
+  auto subgraph = cache ? (*cache)(factorGraph, builder) : builder(factorGraph);
 
   /* build factor subgraph */
   return splitFactorGraph(factorGraph, subgraph);
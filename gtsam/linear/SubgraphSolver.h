@@ -35,6 +35,9 @@ class SubgraphPreconditioner;
 struct GTSAM_EXPORT SubgraphSolverParameters
     : public ConjugateGradientParameters {
   SubgraphBuilderParameters builderParams;
+  /// If set, reuse the subgraph split across solvers while the structure of
+  /// the graph is unchanged, e.g. over the iterations of a nonlinear optimizer
+  std::shared_ptr<SubgraphCache> subgraphCache;
   explicit SubgraphSolverParameters(const SubgraphBuilderParameters &p = SubgraphBuilderParameters())
     : builderParams(p) {}
   void print() const { Base::print(); }
@@ -0,0 +1,124 @@
+/* ----------------------------------------------------------------------------
+
+ * GTSAM Copyright 2010, Georgia Tech Research Corporation,
+ * Atlanta, Georgia 30332-0415
+ * All Rights Reserved
+ * Authors: Frank Dellaert, et al. (see THANKS for the full author list)
+
+ * See LICENSE for the license information
+
+ * -------------------------------------------------------------------------- */
+
+/**
+ * @file    testContiguousVectorValues.cpp
+ * @brief   Unit tests for ContiguousVectorValues
+ */
+
+#include <gtsam/base/Testable.h>
+#include <gtsam/base/TestableAssertions.h>
+#include <gtsam/linear/ContiguousVectorValues.h>
+
+#include <CppUnitLite/TestHarness.h>
+
+using namespace std;
+using namespace gtsam;
+
+namespace {
+VectorValues createValues(double scale) {
+  VectorValues values;
+  values.insert(5, scale * Vector2(6, 7));
+  values.insert(0, scale * (Vector(1) << 1).finished());
+  values.insert(2, scale * Vector3(3, 4, 5));
+  return values;
+}
+}  // namespace
+
+/* ************************************************************************* */
+TEST(ContiguousVectorValues, basics) {
+  const ContiguousVectorValues actual(createValues(1.0));
+
+  // Blocks are stored in key order
+  LONGS_EQUAL(3, actual.size());
+  LONGS_EQUAL(6, actual.dim());
+  EXPECT(assert_equal((Vector(6) << 1, 3, 4, 5, 6, 7).finished(),
+                      actual.vector()));
+  EXPECT(actual.exists(2));
+  EXPECT(!actual.exists(1));
+  LONGS_EQUAL(1, actual.layout()->offset(2));
+  LONGS_EQUAL(3, actual.layout()->dim(2));
+  EXPECT(assert_equal(Vector(Vector2(6, 7)), Vector(actual.at(5))));
+  CHECK_EXCEPTION(actual.at(1), std::out_of_range);
+
+  // Round trip
+  EXPECT(assert_equal(createValues(1.0), actual.vectorValues()));
+
+  // Write access through a block
+  ContiguousVectorValues values = actual;
+  values[2] = Vector3(-1, -2, -3);
+  EXPECT(assert_equal((Vector(6) << 1, -1, -2, -3, 6, 7).finished(),
+                      values.vector()));
+  EXPECT(values.layout() == actual.layout());
+}
+
+/* ************************************************************************* */
+TEST(ContiguousVectorValues, LinearAlgebra) {
+  const VectorValues x = createValues(1.0), y = createValues(-0.5);
+  const ContiguousVectorValues cx(x);
+  const ContiguousVectorValues cy(y, cx.layout());
+
+  EXPECT_DOUBLES_EQUAL(x.dot(y), cx.dot(cy), 1e-9);
+  EXPECT_DOUBLES_EQUAL(x.norm(), cx.norm(), 1e-9);
+  EXPECT_DOUBLES_EQUAL(x.squaredNorm(), cx.squaredNorm(), 1e-9);
+  EXPECT(assert_equal(x + y, (cx + cy).vectorValues()));
+  EXPECT(assert_equal(x - y, (cx - cy).vectorValues()));
+  EXPECT(assert_equal(2.0 * x, (2.0 * cx).vectorValues()));
+
+  ContiguousVectorValues z = cx;
+  z.axpy(3.0, cy);
+  EXPECT(assert_equal(x + 3.0 * y, z.vectorValues()));
+  z -= cy;
+  z *= 0.5;
+  EXPECT(assert_equal(0.5 * (x + 2.0 * y), z.vectorValues()));
+
+  // A separately built layout with the same structure is compatible
+  const ContiguousVectorValues cy2(y);
+  EXPECT(cx.hasSameLayout(cy2));
+  EXPECT(assert_equal(cy, cy2));
+
+  // Different structure
+  VectorValues w;
+  w.insert(0, Vector2(1, 2));
+  const ContiguousVectorValues cw(w);
+  CHECK_EXCEPTION(cx.dot(cw), std::invalid_argument);
+  CHECK_EXCEPTION(ContiguousVectorValues(w, cx.layout()), std::invalid_argument);
+}
+
+/* ************************************************************************* */
+TEST(ContiguousVectorValues, GivenOrder) {
+  // Blocks stored in an elimination ordering rather than in key order
+  const auto layout = std::make_shared<const ContiguousVectorValues::Layout>(
+      KeyVector{2, 5, 0}, std::vector<size_t>{3, 2, 1});
+  const ContiguousVectorValues actual(createValues(1.0), layout);
+
+  EXPECT(assert_equal((Vector(6) << 3, 4, 5, 6, 7, 1).finished(),
+                      actual.vector()));
+  LONGS_EQUAL(5, layout->offset(0));
+  LONGS_EQUAL(2, layout->dim(5));
+  LONGS_EQUAL(1, layout->index(5));
+  EXPECT(!layout->exists(1));
+  EXPECT(assert_equal(createValues(1.0), actual.vectorValues()));
+
+  // Same keys in another order is a different layout
+  EXPECT(!actual.hasSameLayout(ContiguousVectorValues(createValues(1.0))));
+
+  CHECK_EXCEPTION(ContiguousVectorValues::Layout(KeyVector{2, 5},
+                                                 std::vector<size_t>{3}),
+                  std::invalid_argument);
+  CHECK_EXCEPTION(ContiguousVectorValues::Layout(KeyVector{2, 2},
+                                                 std::vector<size_t>{3, 3}),
+                  std::invalid_argument);
+}
+
+/* ************************************************************************* */
+int main() { TestResult tr; return TestRegistry::runAllTests(tr); }
+/* ************************************************************************* */
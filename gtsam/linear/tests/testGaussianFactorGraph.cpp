@@ -347,6 +347,32 @@ TEST(GaussianFactorGraph, gradientAtZero) {
   EXPECT(assert_equal(expected, actual));
 }
 
+/* ************************************************************************* */
+TEST(GaussianFactorGraph, gradientManyFactors) {
+  // A chain with enough factors to be accumulated in several chunks
+  const SharedDiagonal model = noiseModel::Isotropic::Sigma(2, 0.5);
+  GaussianFactorGraph gfg;
+  gfg.add(0, I_2x2, Vector2(0.1, -0.2), model);
+  for (Key j = 1; j < 1000; ++j)
+    gfg.add(j - 1, -I_2x2, j, I_2x2, Vector2(0.01 * j, 0.02), model);
+  gfg.push_back(GaussianFactor::shared_ptr());  // null factors are skipped
+
+  VectorValues x;
+  for (Key j = 0; j < 1000; ++j) x.insert(j, Vector2(0.001 * j, -0.003 * j));
+
+  // Serial sum of the per-factor contributions
+  VectorValues expected = VectorValues::Zero(x), expectedAtZero;
+  for (const auto& factor : gfg) {
+    if (!factor) continue;
+    auto jacobian = std::dynamic_pointer_cast<JacobianFactor>(factor);
+    jacobian->transposeMultiplyAdd(1.0, jacobian->error_vector(x), expected);
+    expectedAtZero.addInPlace_(factor->gradientAtZero());
+  }
+
+  EXPECT(assert_equal(expected, gfg.gradient(x), 1e-9));
+  EXPECT(assert_equal(expectedAtZero, gfg.gradientAtZero(), 1e-9));
+}
+
 /* ************************************************************************* */
 TEST(GaussianFactorGraph, clone) {
   // 2 variables, frontal has dim=4
@@ -699,6 +699,28 @@ TEST(NoiseModel, lossFunctionAtZero)
   DOUBLES_EQUAL(lsdz->weight(0), 0, 1e-8);
 }
 
+/* ************************************************************************* */
+TEST(NoiseModel, robustFunctionsBatch)
+{
+  const double k = 1.5;
+  const std::vector<mEstimator::Base::shared_ptr> estimators{
+      mEstimator::Null::Create(),         mEstimator::Fair::Create(k),
+      mEstimator::Huber::Create(k),       mEstimator::Cauchy::Create(k),
+      mEstimator::Tukey::Create(k),       mEstimator::Welsch::Create(k),
+      mEstimator::GemanMcClure::Create(k), mEstimator::DCS::Create(k),
+      mEstimator::L2WithDeadZone::Create(k)};
+  const Vector distances =
+      (Vector(9) << -4.0, -k, -1.0, -0.1, 0.0, 0.3, k, 2.0, 10.0).finished();
+  for (const auto& estimator : estimators) {
+    const Vector weights = estimator->weights(distances);
+    const Vector losses = estimator->losses(distances);
+    for (int i = 0; i < distances.size(); i++) {
+      DOUBLES_EQUAL(estimator->weight(distances(i)), weights(i), 1e-12);
+      DOUBLES_EQUAL(estimator->loss(distances(i)), losses(i), 1e-12);
+    }
+  }
+}
+
 
 /* ************************************************************************* */
 #define TEST_GAUSSIAN(gaussian)\
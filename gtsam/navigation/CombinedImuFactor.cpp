@@ -26,6 +26,7 @@
 #endif
 
 /* External or standard includes */
+#include <algorithm>
 #include <ostream>
 
 namespace gtsam {
@@ -69,7 +70,8 @@ void PreintegratedCombinedMeasurements::print(const string& s) const {
 bool PreintegratedCombinedMeasurements::equals(
     const PreintegratedCombinedMeasurements& other, double tol) const {
   return PreintegrationType::equals(other, tol)
-      && equal_with_abs_tol(preintMeasCov_, other.preintMeasCov_, tol);
+      && equal_with_abs_tol(preintMeasCov_, other.preintMeasCov_, tol)
+      && repreintegrationThreshold_ == other.repreintegrationThreshold_;
 }
 
 //------------------------------------------------------------------------------
@@ -77,6 +79,7 @@ void PreintegratedCombinedMeasurements::resetIntegration() {
   // Base class method to reset the preintegrated measurements
   PreintegrationType::resetIntegration();
   preintMeasCov_.setZero();
+  measurements_.clear();
 }
 
 //------------------------------------------------------------------------------
@@ -86,6 +89,29 @@ void PreintegratedCombinedMeasurements::resetIntegration(
   PreintegrationType::resetIntegration();
   p().biasAccOmegaInt = Q_init;
   preintMeasCov_.setZero();
+  measurements_.clear();
+}
+
+//------------------------------------------------------------------------------
+void PreintegratedCombinedMeasurements::setRepreintegrationThreshold(
+    double threshold) {
+  if (deltaTij_ > 0 && threshold > 0 && measurements_.empty()) {
+    throw std::runtime_error(
+        "PreintegratedCombinedMeasurements::setRepreintegrationThreshold: "
+        "must be called before integrating measurements");
+  }
+  repreintegrationThreshold_ = std::max(threshold, 0.0);
+  if (repreintegrationThreshold_ == 0.0) measurements_.clear();
+}
+
+//------------------------------------------------------------------------------
+void PreintegratedCombinedMeasurements::repreintegrate(
+    const imuBias::ConstantBias& biasHat) {
+  // NOTE: like resetIntegration, this starts again from a zero covariance.
+  const Measurements measurements = std::move(measurements_);
+  resetIntegrationAndSetBias(biasHat);
+  for (const Measurement& m : measurements)
+    integrateMeasurement(m.measuredAcc, m.measuredOmega, m.dt);
 }
 
 //------------------------------------------------------------------------------
@@ -110,6 +136,9 @@ void PreintegratedCombinedMeasurements::integrateMeasurement(
         "PreintegratedCombinedMeasurements::integrateMeasurement: dt <=0");
   }
 
+  if (repreintegrationThreshold_ > 0)
+    measurements_.push_back({measuredAcc, measuredOmega, dt});
+
   // Update preintegrated measurements.
   Matrix9 A; // Jacobian wrt preintegrated measurements without bias (df/dx)
   Matrix93 B, C;  // Jacobian of state wrpt accel bias and omega bias respectively.
@@ -230,6 +259,28 @@ bool CombinedImuFactor::equals(const NonlinearFactor& other, double tol) const {
   return e != nullptr && Base::equals(*e, tol) && _PIM_.equals(e->_PIM_, tol);
 }
 
+//------------------------------------------------------------------------------
+std::shared_ptr<const PreintegratedCombinedMeasurements>
+CombinedImuFactor::preintegrationAt(const imuBias::ConstantBias& bias_i) const {
+  // Not storing a shared_ptr to _PIM_ itself, return a non-owning one.
+  const std::shared_ptr<const PreintegratedCombinedMeasurements> pim(
+      std::shared_ptr<const PreintegratedCombinedMeasurements>(), &_PIM_);
+  const double threshold = _PIM_.repreintegrationThreshold_;
+  if (threshold <= 0 || _PIM_.measurements_.empty() ||
+      (bias_i - _PIM_.biasHat()).vector().norm() <= threshold)
+    return pim;
+
+  std::lock_guard<std::mutex> lock(cache_->mutex);
+  if (!cache_->pim ||
+      (bias_i - cache_->pim->biasHat()).vector().norm() > threshold) {
+    auto repreintegrated =
+        std::make_shared<PreintegratedCombinedMeasurements>(_PIM_);
+    repreintegrated->repreintegrate(bias_i);
+    cache_->pim = repreintegrated;
+  }
+  return cache_->pim;
+}
+
 //------------------------------------------------------------------------------
 Vector CombinedImuFactor::evaluateError(const Pose3& pose_i,
     const Vector3& vel_i, const Pose3& pose_j, const Vector3& vel_j,
@@ -247,7 +298,7 @@ Vector CombinedImuFactor::evaluateError(const Pose3& pose_i,
   Matrix93 D_r_vel_i, D_r_vel_j;
 
   // error wrt preintegrated measurements
-  Vector9 r_Rpv = _PIM_.computeErrorAndJacobians(pose_i, vel_i, pose_j, vel_j,
+  Vector9 r_Rpv = preintegrationAt(bias_i)->computeErrorAndJacobians(pose_i, vel_i, pose_j, vel_j,
       bias_i, H1 ? &D_r_pose_i : 0, H2 ? &D_r_vel_i : 0, H3 ? &D_r_pose_j : 0,
       H4 ? &D_r_vel_j : 0, H5 ? &D_r_bias_i : 0);
 
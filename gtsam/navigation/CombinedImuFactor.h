@@ -25,6 +25,12 @@
 /* GTSAM includes */
 #include <gtsam/navigation/PreintegrationCombinedParams.h>
 
+#ifdef GTSAM_ENABLE_BOOST_SERIALIZATION
+#include <boost/serialization/vector.hpp>
+#endif
+#include <mutex>
+#include <vector>
+
 namespace gtsam {
 
 #ifdef GTSAM_TANGENT_PREINTEGRATION
@@ -68,6 +74,26 @@ class GTSAM_EXPORT PreintegratedCombinedMeasurements
  public:
   typedef PreintegrationCombinedParams Params;
 
+  /// Raw IMU measurement, kept to allow re-preintegration at a new bias
+  struct Measurement {
+    Vector3 measuredAcc;
+    Vector3 measuredOmega;
+    double dt;
+
+#ifdef GTSAM_ENABLE_BOOST_SERIALIZATION
+    template <class ARCHIVE>
+    void serialize(ARCHIVE& ar, const unsigned int /*version*/) {
+      ar& BOOST_SERIALIZATION_NVP(measuredAcc);
+      ar& BOOST_SERIALIZATION_NVP(measuredOmega);
+      ar& BOOST_SERIALIZATION_NVP(dt);
+    }
+#endif
+
+    GTSAM_MAKE_ALIGNED_OPERATOR_NEW
+  };
+  typedef std::vector<Measurement, Eigen::aligned_allocator<Measurement>>
+      Measurements;
+
  protected:
   /* Covariance matrix of the preintegrated measurements
    * COVARIANCE OF: [PreintROTATION PreintPOSITION PreintVELOCITY BiasAcc
@@ -77,6 +103,12 @@ class GTSAM_EXPORT PreintegratedCombinedMeasurements
    */
   Eigen::Matrix<double, 15, 15> preintMeasCov_;
 
+  /// Bias change beyond which CombinedImuFactor re-preintegrates, 0 = never
+  double repreintegrationThreshold_ = 0.0;
+
+  /// Raw measurements, only stored when repreintegrationThreshold_ > 0
+  Measurements measurements_;
+
   friend class CombinedImuFactor;
 
  public:
@@ -137,6 +169,14 @@ class GTSAM_EXPORT PreintegratedCombinedMeasurements
   /// @{
   /// Return pre-integrated measurement covariance
   Matrix preintMeasCov() const { return preintMeasCov_; }
+
+  /// Return the bias change beyond which the factor re-preintegrates
+  double repreintegrationThreshold() const {
+    return repreintegrationThreshold_;
+  }
+
+  /// Return the raw measurements stored for re-preintegration
+  const Measurements& measurements() const { return measurements_; }
   /// @}
 
   /// @name Testable
@@ -166,6 +206,22 @@ class GTSAM_EXPORT PreintegratedCombinedMeasurements
                             const Vector3& measuredOmega,
                             const double dt) override;
 
+  /**
+   * Keep the raw IMU measurements so that a CombinedImuFactor built from this
+   * object can re-preintegrate them when the bias estimate moves further than
+   * `threshold` (Euclidean norm of the 6D bias change) away from biasHat.
+   * The first-order bias correction is used below the threshold.
+   * Must be called before integrating; a non-positive value disables it.
+   */
+  void setRepreintegrationThreshold(double threshold);
+
+  /**
+   * Reset and integrate the stored raw measurements again, using a new bias
+   * estimate as linearization point for the bias correction.
+   * @param biasHat New estimate of acceleration and rotation rate biases
+   */
+  void repreintegrate(const imuBias::ConstantBias& biasHat);
+
   /// @}
 
  private:
@@ -177,6 +233,8 @@ class GTSAM_EXPORT PreintegratedCombinedMeasurements
     namespace bs = ::boost::serialization;
     ar& BOOST_SERIALIZATION_BASE_OBJECT_NVP(PreintegrationType);
     ar& BOOST_SERIALIZATION_NVP(preintMeasCov_);
+    ar& BOOST_SERIALIZATION_NVP(repreintegrationThreshold_);
+    ar& BOOST_SERIALIZATION_NVP(measurements_);
   }
 #endif
 
@@ -214,6 +272,22 @@ class GTSAM_EXPORT CombinedImuFactor
 
   PreintegratedCombinedMeasurements _PIM_;
 
+  /**
+   * Measurements re-preintegrated at the bias last seen in evaluateError, used
+   * when that bias is more than _PIM_.repreintegrationThreshold() away from
+   * _PIM_.biasHat(). Shared between copies since it only depends on _PIM_.
+   */
+  struct RepreintegrationCache {
+    std::mutex mutex;
+    std::shared_ptr<const PreintegratedCombinedMeasurements> pim;
+  };
+  std::shared_ptr<RepreintegrationCache> cache_ =
+      std::make_shared<RepreintegrationCache>();
+
+  /// Return the preintegration to use for a given bias estimate
+  std::shared_ptr<const PreintegratedCombinedMeasurements> preintegrationAt(
+      const imuBias::ConstantBias& bias_i) const;
+
  public:
   // Provide access to Matrix& version of evaluateError:
   using Base::evaluateError;
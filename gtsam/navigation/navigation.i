@@ -188,8 +188,11 @@ class PreintegratedCombinedMeasurements {
       double deltaT);
   void resetIntegration();
   void resetIntegrationAndSetBias(const gtsam::imuBias::ConstantBias& biasHat);
+  void setRepreintegrationThreshold(double threshold);
+  void repreintegrate(const gtsam::imuBias::ConstantBias& biasHat);
 
   Matrix preintMeasCov() const;
+  double repreintegrationThreshold() const;
   double deltaTij() const;
   gtsam::Rot3 deltaRij() const;
   Vector deltaPij() const;
@@ -29,6 +29,7 @@
 #include <gtsam/navigation/ImuFactor.h>
 #include <gtsam/navigation/ScenarioRunner.h>
 #include <gtsam/nonlinear/Values.h>
+#include <gtsam/nonlinear/factorTesting.h>
 
 #include <list>
 
@@ -357,6 +358,70 @@ TEST(CombinedImuFactor, ResetIntegration) {
   EXPECT(assert_equal(expected_Q_init, pim.p().biasAccOmegaInt, 1e-9));
 }
 
+/* ************************************************************************* */
+TEST(CombinedImuFactor, Repreintegration) {
+  auto p = testing::Params();
+  testing::SomeMeasurements measurements;
+
+  const Bias biasHat(Vector3(0.01, 0, 0), Vector3(0, 0.01, 0));
+  PreintegratedCombinedMeasurements pim(p, biasHat);
+  pim.setRepreintegrationThreshold(0.1);
+  testing::integrateMeasurements(measurements, &pim);
+  EXPECT_LONGS_EQUAL(measurements.size(), pim.measurements().size());
+
+  // Re-preintegrating at the same bias reproduces the same deltas
+  PreintegratedCombinedMeasurements same = pim;
+  same.repreintegrate(biasHat);
+  EXPECT(assert_equal(pim, same, 1e-9));
+  EXPECT_LONGS_EQUAL(measurements.size(), same.measurements().size());
+
+  const Pose3 x1, x2(Rot3::RzRyRx(0.1, 0.2, 0.3), Point3(0.1, 0.2, -0.3));
+  const Vector3 v1(0.5, 0, 0), v2(0.6, 0.1, 0);
+  CombinedImuFactor factor(X(1), V(1), X(2), V(2), B(1), B(2), pim);
+
+  // Below the threshold the first-order bias correction is used
+  const Bias nearBias(Vector3(0.02, 0, 0), Vector3(0, 0.02, 0));
+  PreintegratedCombinedMeasurements plain(p, biasHat);
+  testing::integrateMeasurements(measurements, &plain);
+  CombinedImuFactor plainFactor(X(1), V(1), X(2), V(2), B(1), B(2), plain);
+  EXPECT(assert_equal(
+      plainFactor.evaluateError(x1, v1, x2, v2, nearBias, nearBias),
+      factor.evaluateError(x1, v1, x2, v2, nearBias, nearBias), 1e-9));
+
+  // Beyond the threshold the measurements are integrated again at bias_i
+  const Bias farBias(Vector3(0.3, -0.2, 0.1), Vector3(0.2, 0.1, -0.1));
+  PreintegratedCombinedMeasurements expected(p, farBias);
+  testing::integrateMeasurements(measurements, &expected);
+  CombinedImuFactor expectedFactor(X(1), V(1), X(2), V(2), B(1), B(2),
+                                   expected);
+  Matrix H1e, H2e, H3e, H4e, H5e, H6e, H1a, H2a, H3a, H4a, H5a, H6a;
+  Vector expectedError = expectedFactor.evaluateError(
+      x1, v1, x2, v2, farBias, farBias, H1e, H2e, H3e, H4e, H5e, H6e);
+  Vector actualError = factor.evaluateError(x1, v1, x2, v2, farBias, farBias,
+                                            H1a, H2a, H3a, H4a, H5a, H6a);
+  EXPECT(assert_equal(expectedError, actualError, 1e-9));
+  EXPECT(assert_equal(H1e, H1a, 1e-9));
+  EXPECT(assert_equal(H5e, H5a, 1e-9));
+
+  // A cached re-preintegration is reused for nearby biases, and is shared
+  // with clones of the factor
+  const Bias farBias2 = farBias + Bias(Vector3(0.01, 0, 0), Vector3::Zero());
+  auto clone = std::dynamic_pointer_cast<CombinedImuFactor>(factor.clone());
+  EXPECT(assert_equal(
+      expectedFactor.evaluateError(x1, v1, x2, v2, farBias2, farBias2),
+      clone->evaluateError(x1, v1, x2, v2, farBias2, farBias2), 1e-9));
+
+  // Check the derivatives numerically at the re-preintegrated bias
+  Values values;
+  values.insert(X(1), x1);
+  values.insert(V(1), v1);
+  values.insert(X(2), x2);
+  values.insert(V(2), v2);
+  values.insert(B(1), farBias);
+  values.insert(B(2), farBias);
+  EXPECT_CORRECT_FACTOR_JACOBIANS(factor, values, 1e-5, 1e-5);
+}
+
 /* ************************************************************************* */
 int main() {
   TestResult tr;
@@ -71,8 +71,13 @@ FixedLagSmoother::Result BatchFixedLagSmoother::update(
 
   // remove factors in factorToRemove
   for(const size_t i : factorsToRemove){
-    if(factors_[i])
+    if(factors_[i]) {
+      // Keep the FactorIndex in sync, it is used to find factors to marginalize
+      for(Key key: *factors_[i]) {
+        factorIndex_[key].erase(i);
+      }
       factors_[i].reset();
+    }
   }
 
   // Update the Timestamps associated with the factor keys
@@ -85,9 +90,12 @@ FixedLagSmoother::Result BatchFixedLagSmoother::update(
   KeyVector marginalizableKeys = findKeysBefore(
       current_timestamp - smootherLag_);
 
-  // Reorder
+  // Reorder, unless the structure of the window is unchanged since last time
   gttic(reorder);
-  reorder(marginalizableKeys);
+  if (!newFactors.empty() || !newTheta.empty() || !factorsToRemove.empty() ||
+      !marginalizableKeys.empty()) {
+    reorder(marginalizableKeys);
+  }
   gttoc(reorder);
 
   // Optimize
@@ -168,9 +176,13 @@ void BatchFixedLagSmoother::eraseKeys(const KeyVector& keys) {
 
   eraseKeyTimestampMap(keys);
 
-  // Remove marginalized keys from the ordering and delta
+  // Remove marginalized keys from the ordering and delta, in a single pass
+  // over the ordering rather than one search per key
+  const KeySet erased(keys.begin(), keys.end());
+  ordering_.erase(std::remove_if(ordering_.begin(), ordering_.end(),
+                                 [&erased](Key key) { return erased.exists(key); }),
+                  ordering_.end());
   for(Key key: keys) {
-    ordering_.erase(find(ordering_.begin(), ordering_.end(), key));
     delta_.erase(key);
   }
 }
@@ -208,6 +220,16 @@ FixedLagSmoother::Result BatchFixedLagSmoother::optimize() {
     return result;
   }
 
+  // The damping priors are allocated once, in whitened form, and rescaled in
+  // place for every lambda tried below.
+  std::vector<JacobianFactor::shared_ptr> dampingFactors;
+  dampingFactors.reserve(delta_.size());
+  for(const auto& key_value: delta_) {
+    const size_t dim = key_value.second.size();
+    dampingFactors.push_back(std::make_shared<JacobianFactor>(
+        key_value.first, Matrix::Identity(dim, dim), Vector::Zero(dim)));
+  }
+
   // Use a custom optimization loop so the linearization points can be controlled
   double previousError;
   VectorValues newDelta;
@@ -217,27 +239,26 @@ FixedLagSmoother::Result BatchFixedLagSmoother::optimize() {
     // Do next iteration
     gttic(optimizer_iteration);
     {
-      // Linearize graph around the linearization point
-      GaussianFactorGraph linearFactorGraph = *factors_.linearize(theta_);
+      // Linearize graph around the linearization point, and append the
+      // damping priors, which are shared by every lambda search step
+      GaussianFactorGraph dampedFactorGraph = *factors_.linearize(theta_);
+      dampedFactorGraph.reserve(dampedFactorGraph.size() + dampingFactors.size());
+      for(const auto& prior: dampingFactors) {
+        dampedFactorGraph.push_back(prior);
+      }
 
       // Keep increasing lambda until we make make progress
       while (true) {
 
-        // Add prior factors at the current solution
+        // Set the priors at the current solution, with sigma = 1/sqrt(lambda)
         gttic(damp);
-        GaussianFactorGraph dampedFactorGraph(linearFactorGraph);
-        dampedFactorGraph.reserve(linearFactorGraph.size() + delta_.size());
         {
-          // for each of the variables, add a prior at the current solution
-          double sigma = 1.0 / sqrt(lambda);
+          const double sqrtLambda = sqrt(lambda);
+          auto prior = dampingFactors.begin();
           for(const auto& key_value: delta_) {
-            size_t dim = key_value.second.size();
-            Matrix A = Matrix::Identity(dim, dim);
-            Vector b = key_value.second;
-            SharedDiagonal model = noiseModel::Isotropic::Sigma(dim, sigma);
-            GaussianFactor::shared_ptr prior(
-                new JacobianFactor(key_value.first, A, b, model));
-            dampedFactorGraph.push_back(prior);
+            JacobianFactor& factor = **prior++;
+            factor.getA(factor.begin()).diagonal().setConstant(sqrtLambda);
+            factor.getb() = sqrtLambda * key_value.second;
           }
         }
         gttoc(damp);
@@ -315,11 +336,13 @@ void BatchFixedLagSmoother::marginalize(const KeyVector& marginalizeKeys) {
   // adds the linearized factors back in.
 
   // Identify all of the factors involving any marginalized variable. These must be removed.
+  // The maintained FactorIndex is used, so this does not scale with the window size.
   set<size_t> removedFactorSlots;
-  const VariableIndex variableIndex(factors_);
   for(Key key: marginalizeKeys) {
-    const auto& slots = variableIndex[key];
-    removedFactorSlots.insert(slots.begin(), slots.end());
+    const auto slots = factorIndex_.find(key);
+    if (slots != factorIndex_.end()) {
+      removedFactorSlots.insert(slots->second.begin(), slots->second.end());
+    }
   }
 
   // Add the removed factors to a factor graph
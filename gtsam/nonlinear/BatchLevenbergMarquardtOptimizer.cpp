@@ -0,0 +1,386 @@
+/* ----------------------------------------------------------------------------
+
+ * GTSAM Copyright 2010, Georgia Tech Research Corporation,
+ * Atlanta, Georgia 30332-0415
+ * All Rights Reserved
+ * Authors: Frank Dellaert, et al. (see THANKS for the full author list)
+
+ * See LICENSE for the license information
+
+ * -------------------------------------------------------------------------- */
+
+/**
+ * @file    BatchLevenbergMarquardtOptimizer.cpp
+ * @brief   Levenberg-Marquardt on many small, structurally identical problems
+ */
+
+#include <gtsam/nonlinear/BatchLevenbergMarquardtOptimizer.h>
+#include <gtsam/nonlinear/NonlinearFactor.h>
+#include <gtsam/nonlinear/NonlinearOptimizer.h>
+#include <gtsam/linear/JacobianFactor.h>
+#include <gtsam/linear/VectorValues.h>
+#include <gtsam/config.h>  // for GTSAM_USE_TBB
+
+#ifdef GTSAM_USE_TBB
+#include <tbb/blocked_range.h>
+#include <tbb/parallel_for.h>
+#endif
+
+#include <Eigen/Cholesky>
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+
+namespace gtsam {
+
+namespace {
+
+/* ************************************************************************* */
+// Symbolic structure shared by all problems: where every variable lives in
+// the dense system, and which variables every factor touches.
+struct Structure {
+  KeyVector keys;                          // sorted, as in Values::keys()
+  std::vector<size_t> dims, offsets;       // of every variable
+  size_t dim = 0;                          // of the dense system
+  std::vector<std::vector<size_t>> slots;  // variable indices of every factor
+
+  size_t index(Key key) const {
+    const auto it = std::lower_bound(keys.begin(), keys.end(), key);
+    if (it == keys.end() || *it != key)
+      throw std::invalid_argument(
+          "BatchLevenbergMarquardtOptimizer: factor on a key without a value");
+    return it - keys.begin();
+  }
+};
+
+/* ************************************************************************* */
+// Compute the structure of the first problem, and check that all other
+// problems have exactly the same one.
+Structure computeStructure(const std::vector<NonlinearFactorGraph>& graphs,
+                           const std::vector<Values>& initialValues) {
+  Structure s;
+  s.keys = initialValues.front().keys();
+  for (Key key : s.keys) {
+    s.offsets.push_back(s.dim);
+    s.dims.push_back(initialValues.front().at(key).dim());
+    s.dim += s.dims.back();
+  }
+
+  const NonlinearFactorGraph& graph = graphs.front();
+  s.slots.resize(graph.size());
+  for (size_t k = 0; k < graph.size(); ++k) {
+    if (!graph[k]) continue;
+    for (Key key : graph[k]->keys()) s.slots[k].push_back(s.index(key));
+  }
+
+  auto mismatch = [](const std::string& what) {
+    return std::invalid_argument(
+        "BatchLevenbergMarquardtOptimizer::optimize: problems differ in " +
+        what);
+  };
+  for (size_t i = 0; i < graphs.size(); ++i) {
+    const Values& values = initialValues[i];
+    if (values.size() != s.keys.size()) throw mismatch("their variables");
+    for (size_t j = 0; j < s.keys.size(); ++j) {
+      if (!values.exists(s.keys[j]) || values.at(s.keys[j]).dim() != s.dims[j])
+        throw mismatch("their variables");
+    }
+    if (graphs[i].size() != graph.size()) throw mismatch("their factors");
+    for (size_t k = 0; k < graph.size(); ++k) {
+      const auto& factor = graphs[i][k];
+      if (!factor != !graph[k] || (factor && factor->keys() != graph[k]->keys()))
+        throw mismatch("their factors");
+      const auto noiseModelFactor =
+          dynamic_cast<const NoiseModelFactor*>(factor.get());
+      if (noiseModelFactor && noiseModelFactor->noiseModel() &&
+          noiseModelFactor->noiseModel()->isConstrained())
+        throw std::invalid_argument(
+            "BatchLevenbergMarquardtOptimizer: constrained noise models are "
+            "not supported");
+    }
+  }
+  return s;
+}
+
+/* ************************************************************************* */
+// Scratch space of one thread, reused across problems and iterations
+struct Workspace {
+  std::vector<Matrix> A;        // whitened Jacobians of one factor
+  Vector damping, step;         // diagonal added to H, and the solution
+  VectorValues delta;           // step, as passed to Values::retract
+  std::vector<Vector*> blocks;  // of delta, per variable
+
+  explicit Workspace(const Structure& s) : damping(s.dim), step(s.dim) {
+    for (size_t j = 0; j < s.keys.size(); ++j)
+      delta.insert(s.keys[j], Vector::Zero(s.dims[j]));
+    for (Key key : s.keys) blocks.push_back(&delta.at(key));
+  }
+
+  const VectorValues& setDelta(const Structure& s) {
+    for (size_t j = 0; j < s.keys.size(); ++j)
+      *blocks[j] = step.segment(s.offsets[j], s.dims[j]);
+    return delta;
+  }
+};
+
+/* ************************************************************************* */
+// Add the block of factor information between variable slots p and q to H
+template <class BLOCK>
+void addBlock(const Structure& s, size_t p, size_t q, const BLOCK& block,
+              Eigen::Ref<Matrix> H) {
+  H.block(s.offsets[p], s.offsets[q], s.dims[p], s.dims[q]) += block;
+  if (p != q)
+    H.block(s.offsets[q], s.offsets[p], s.dims[q], s.dims[p]) +=
+        block.transpose();
+}
+
+/* ************************************************************************* */
+// Linearize graph at values straight into the normal equations H delta = g of
+// the whitened system A delta = b, and return b'b. Noise model factors are
+// whitened in place, without creating a GaussianFactor.
+double linearize(const Structure& s, const NonlinearFactorGraph& graph,
+                 const Values& values, Eigen::Ref<Matrix> H,
+                 Eigen::Ref<Vector> g, Workspace* ws) {
+  H.setZero();
+  g.setZero();
+  double bb = 0.0;
+  for (size_t k = 0; k < graph.size(); ++k) {
+    const auto& factor = graph[k];
+    if (!factor) continue;
+    const std::vector<size_t>& slots = s.slots[k];
+
+    if (const auto noiseModelFactor =
+            dynamic_cast<const NoiseModelFactor*>(factor.get())) {
+      if (!noiseModelFactor->active(values)) continue;
+      std::vector<Matrix>& A = ws->A;
+      A.resize(slots.size());
+      Vector b = -noiseModelFactor->unwhitenedError(values, A);
+      if (const auto& model = noiseModelFactor->noiseModel())
+        model->WhitenSystem(A, b);
+      for (size_t p = 0; p < slots.size(); ++p) {
+        g.segment(s.offsets[slots[p]], s.dims[slots[p]]).noalias() +=
+            A[p].transpose() * b;
+        for (size_t q = p; q < slots.size(); ++q)
+          addBlock(s, slots[p], slots[q], A[p].transpose() * A[q], H);
+      }
+      bb += b.squaredNorm();
+    } else {
+      const auto gaussianFactor = factor->linearize(values);
+      if (!gaussianFactor) continue;
+      const auto jacobianFactor =
+          std::dynamic_pointer_cast<JacobianFactor>(gaussianFactor);
+      if (jacobianFactor && jacobianFactor->isConstrained())
+        throw std::invalid_argument(
+            "BatchLevenbergMarquardtOptimizer: constrained noise models are "
+            "not supported");
+      // Augmented information [A'A A'b; b'A b'b], in the factor's key order
+      const Matrix information = gaussianFactor->augmentedInformation();
+      const size_t n = information.rows() - 1;
+      std::vector<size_t> factorSlots, factorOffsets;
+      size_t offset = 0;
+      for (auto it = gaussianFactor->begin(); it != gaussianFactor->end();
+           ++it) {
+        factorSlots.push_back(s.index(*it));
+        factorOffsets.push_back(offset);
+        offset += gaussianFactor->getDim(it);
+      }
+      for (size_t p = 0; p < factorSlots.size(); ++p) {
+        const size_t sp = factorSlots[p];
+        g.segment(s.offsets[sp], s.dims[sp]) +=
+            information.block(factorOffsets[p], n, s.dims[sp], 1);
+        for (size_t q = p; q < factorSlots.size(); ++q) {
+          const size_t sq = factorSlots[q];
+          addBlock(s, sp, sq,
+                   information.block(factorOffsets[p], factorOffsets[q],
+                                     s.dims[sp], s.dims[sq]),
+                   H);
+        }
+      }
+      bb += information(n, n);
+    }
+  }
+  return bb;
+}
+
+/* ************************************************************************* */
+// Solve (H + lambda * diag(damping)) step = g with a Cholesky factorization
+// of size D, or of dynamic size if D is Eigen::Dynamic.
+template <int D>
+bool solveDamped(const Eigen::Ref<const Matrix>& H,
+                 const Eigen::Ref<const Vector>& g, const Vector& damping,
+                 double lambda, Vector* step) {
+  Eigen::Matrix<double, D, D> damped = H;
+  damped.diagonal() += lambda * damping;
+  const Eigen::LLT<Eigen::Matrix<double, D, D>> llt(damped);
+  if (llt.info() != Eigen::Success) return false;
+  *step = llt.solve(Eigen::Matrix<double, D, 1>(g));
+  return step->allFinite();
+}
+
+typedef bool (*DampedSolver)(const Eigen::Ref<const Matrix>&,
+                             const Eigen::Ref<const Vector>&, const Vector&,
+                             double, Vector*);
+
+// Fixed-size solver for systems up to dimension D, dynamic-size otherwise
+template <int D>
+DampedSolver dampedSolver(size_t dim) {
+  if constexpr (D == 0)
+    return &solveDamped<Eigen::Dynamic>;
+  else
+    return dim == D ? &solveDamped<D> : dampedSolver<D - 1>(dim);
+}
+
+static constexpr int kMaxFixedDim = 12;
+
+}  // namespace
+
+/* ************************************************************************* */
+BatchLevenbergMarquardtOptimizer::BatchLevenbergMarquardtOptimizer(
+    const LevenbergMarquardtParams& params)
+    : params_(params) {}
+
+/* ************************************************************************* */
+std::vector<Values> BatchLevenbergMarquardtOptimizer::optimize(
+    const std::vector<NonlinearFactorGraph>& graphs,
+    const std::vector<Values>& initialValues) const {
+  if (graphs.size() != initialValues.size()) {
+    throw std::invalid_argument(
+        "BatchLevenbergMarquardtOptimizer::optimize: number of graphs and "
+        "initial values differ");
+  }
+  const size_t n = graphs.size();
+  std::vector<Values> results(n);
+  if (n == 0) return results;
+
+  const Structure s = computeStructure(graphs, initialValues);
+  const size_t D = s.dim;
+  const DampedSolver solve = dampedSolver<kMaxFixedDim>(D);
+
+  // Hessian and gradient of problem i are hessians.middleCols(i * D, D) and
+  // gradients.col(i)
+  Matrix hessians(D, D * n);
+  Matrix gradients(D, n);
+
+  // Run Levenberg-Marquardt on problem i, with the same lambda schedule and
+  // stopping criteria as LevenbergMarquardtOptimizer
+  auto optimizeProblem = [&](size_t i, Workspace* ws) {
+    const NonlinearFactorGraph& graph = graphs[i];
+    Eigen::Ref<Matrix> H = hessians.middleCols(i * D, D);
+    Eigen::Ref<Vector> g = gradients.col(i);
+    Values values = initialValues[i];
+    double lambda = params_.lambdaInitial;
+    double lambdaFactor = params_.lambdaFactor;
+    size_t iterations = 0;
+
+    double currentError = graph.error(values), newError = currentError;
+    if (currentError <= params_.errorTol || params_.maxIterations == 0) {
+      results[i] = std::move(values);
+      return;
+    }
+
+    do {
+      currentError = newError;
+      const double bb = linearize(s, graph, values, H, g, ws);
+      if (params_.diagonalDamping)
+        ws->damping = H.diagonal()
+                          .cwiseMax(params_.minDiagonal)
+                          .cwiseMin(params_.maxDiagonal);
+      else
+        ws->damping.setOnes();
+
+      // Keep increasing lambda until we make progress, or give up
+      bool stepAccepted = false;
+      while (true) {
+        double modelFidelity = 0.0, costChange = 0.0;
+        double trialError = std::numeric_limits<double>::infinity();
+        bool success = false, stopSearchingLambda = false;
+        Values newValues;
+        if (solve(H, g, ws->damping, lambda, &ws->step)) {
+          // Linearized cost change 0.5 b'b - 0.5 |A step - b|^2
+          const Vector& step = ws->step;
+          const double linearizedCostChange =
+              step.dot(g) - 0.5 * step.dot(H * step);
+          if (linearizedCostChange >= 0) {
+            newValues = values.retract(ws->setDelta(s));
+            trialError = graph.error(newValues);
+            costChange = currentError - trialError;
+            if (linearizedCostChange >
+                std::numeric_limits<double>::epsilon() * 0.5 * bb) {
+              modelFidelity = costChange / linearizedCostChange;
+              success = modelFidelity > params_.minModelFidelity;
+            }
+            if (std::abs(costChange) <
+                params_.relativeErrorTol * currentError)
+              stopSearchingLambda = true;
+          }
+        }
+
+        if (success) {
+          if (params_.useFixedLambdaFactor) {
+            lambda /= lambdaFactor;
+          } else {
+            lambda *= std::max(1.0 / 3.0,
+                               1.0 - std::pow(2.0 * modelFidelity - 1.0, 3));
+            lambdaFactor *= 2.0;
+          }
+          lambda = std::max(params_.lambdaLowerBound, lambda);
+          values = std::move(newValues);
+          newError = trialError;
+          ++iterations;
+          stepAccepted = true;
+          break;
+        } else if (!stopSearchingLambda) {
+          lambda *= lambdaFactor;
+          if (!params_.useFixedLambdaFactor) lambdaFactor *= 2.0;
+          if (lambda >= params_.lambdaUpperBound) break;
+        } else {
+          break;
+        }
+      }
+      // Without an accepted step the error did not change, so we converged
+      if (!stepAccepted) break;
+    } while (iterations < params_.maxIterations &&
+             !checkConvergence(params_.relativeErrorTol,
+                               params_.absoluteErrorTol, params_.errorTol,
+                               currentError, newError) &&
+             std::isfinite(currentError));
+
+    results[i] = std::move(values);
+  };
+
+  // Problems with factors that may not be used concurrently run afterwards
+  std::vector<char> sendable(n, 1);
+  for (size_t i = 0; i < n; ++i) {
+    for (const auto& factor : graphs[i]) {
+      if (factor && !factor->sendable()) {
+        sendable[i] = 0;
+        break;
+      }
+    }
+  }
+
+#ifdef GTSAM_USE_TBB
+  tbb::parallel_for(tbb::blocked_range<size_t>(0, n),
+                    [&](const tbb::blocked_range<size_t>& range) {
+                      Workspace ws(s);
+                      for (size_t i = range.begin(); i != range.end(); ++i)
+                        if (sendable[i]) optimizeProblem(i, &ws);
+                    });
+#else
+  {
+    Workspace ws(s);
+    for (size_t i = 0; i < n; ++i)
+      if (sendable[i]) optimizeProblem(i, &ws);
+  }
+#endif
+
+  Workspace ws(s);
+  for (size_t i = 0; i < n; ++i)
+    if (!sendable[i]) optimizeProblem(i, &ws);
+
+  return results;
+}
+
+}  // namespace gtsam
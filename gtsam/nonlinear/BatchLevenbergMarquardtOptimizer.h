@@ -0,0 +1,71 @@
+/* ----------------------------------------------------------------------------
+
+ * GTSAM Copyright 2010, Georgia Tech Research Corporation,
+ * Atlanta, Georgia 30332-0415
+ * All Rights Reserved
+ * Authors: Frank Dellaert, et al. (see THANKS for the full author list)
+
+ * See LICENSE for the license information
+
+ * -------------------------------------------------------------------------- */
+
+/**
+ * @file    BatchLevenbergMarquardtOptimizer.h
+ * @brief   Levenberg-Marquardt on many small, structurally identical problems
+ */
+
+#pragma once
+
+#include <gtsam/nonlinear/LevenbergMarquardtParams.h>
+#include <gtsam/nonlinear/NonlinearFactorGraph.h>
+#include <gtsam/nonlinear/Values.h>
+
+#include <vector>
+
+namespace gtsam {
+
+/**
+ * Solves many small, independent nonlinear least-squares problems with the
+ * same structure, e.g. per-object pose refinement or per-track triangulation,
+ * with Levenberg-Marquardt.
+ *
+ * All problems must have the same factors on the same keys, and values of the
+ * same dimensions. The symbolic structure, i.e. the position of every variable
+ * and factor block in the dense D x D system, is computed once. The Hessian and
+ * gradient of every problem are stored side by side in one D x (D*N) and one
+ * D x N matrix, and each damped system is solved by a dense Cholesky
+ * factorization, of fixed size for small D. No GaussianFactorGraph, elimination
+ * tree or Bayes net is built. Problems are spread over threads when TBB is
+ * enabled.
+ *
+ * Each problem has its own lambda, which follows the same schedule as in
+ * LevenbergMarquardtOptimizer, and stops on its own when it converges. The
+ * linear solver type, ordering, verbosity, log file and iteration hook in the
+ * parameters are ignored. Constrained noise models are not supported.
+ */
+class GTSAM_EXPORT BatchLevenbergMarquardtOptimizer {
+ public:
+  /// Construct with the parameters used for every problem
+  explicit BatchLevenbergMarquardtOptimizer(
+      const LevenbergMarquardtParams& params = LevenbergMarquardtParams());
+
+  /// Parameters used for every problem
+  const LevenbergMarquardtParams& params() const { return params_; }
+
+  /**
+   * Optimize every problem.
+   * @param graphs The factor graph of each problem
+   * @param initialValues The initial estimate of each problem
+   * @return The optimized values, in the same order as the problems
+   * @throw std::invalid_argument if the problems are not structurally
+   * identical, or a factor has a constrained noise model
+   */
+  std::vector<Values> optimize(
+      const std::vector<NonlinearFactorGraph>& graphs,
+      const std::vector<Values>& initialValues) const;
+
+ private:
+  LevenbergMarquardtParams params_;
+};
+
+}  // namespace gtsam
@@ -115,41 +115,21 @@ protected:
   }
 
   std::shared_ptr<GaussianFactor> linearize(const Values& x) const override {
-    // Only linearize if the factor is active
-    if (!active(x))
-      return std::shared_ptr<JacobianFactor>();
-
-    // In case noise model is constrained, we need to provide a noise model
-    SharedDiagonal noiseModel;
-    if (noiseModel_ && noiseModel_->isConstrained()) {
-      noiseModel = std::static_pointer_cast<noiseModel::Constrained>(
-          noiseModel_)->unit();
-    }
-
-    // Create a writeable JacobianFactor in advance
-    std::shared_ptr<JacobianFactor> factor(
-        new JacobianFactor(keys_, dims_, Dim, noiseModel));
-
-    // Wrap keys and VerticalBlockMatrix into structure passed to expression_
-    VerticalBlockMatrix& Ab = factor->matrixObject();
-    internal::JacobianMap jacobianMap(keys_, Ab);
-
-    // Zero out Jacobian so we can simply add to it
-    Ab.matrix().setZero();
-
-    // Get value and Jacobians, writing directly into JacobianFactor
-    T value = expression_.valueAndJacobianMap(x, jacobianMap); // <<< Reverse AD happens here !
-
-    // Evaluate error and set RHS vector b
-    Ab(size()).col(0) = traits<T>::Local(value, measured_);
+    return linearizeWhitened(x, noiseModel_);
+  }
 
-    // Whiten the corresponding system, Ab already contains RHS
-    if (noiseModel_) {
-      Vector b = Ab(size()).col(0);  // need b to be valid for Robust noise models
-      noiseModel_->WhitenSystem(Ab.matrix(), b);
-    }
+  /// Linearize with reverse AD, whitening only with the Gaussian model inside
+  /// a robust noise model
+  std::shared_ptr<JacobianFactor> linearizeUnweighted(
+      const Values& x) const override {
+    const auto robust =
+        std::dynamic_pointer_cast<noiseModel::Robust>(noiseModel_);
+    return linearizeWhitened(x, robust ? robust->noise() : noiseModel_);
+  }
 
-    return std::move(factor);
+  /// Robust expression factors are reweighted together by NonlinearFactorGraph
+  const noiseModel::mEstimator::Base* robustEstimator() const override {
+    return noiseModelEstimator();
   }
 
   /// @return a deep copy of this factor
@@ -199,6 +179,46 @@ protected:
    throw std::runtime_error("ExpressionFactor::expression not provided: cannot deserialize.");
  }
 
+ /// Linearize with reverse AD and whiten with the given noise model
+ std::shared_ptr<JacobianFactor> linearizeWhitened(
+     const Values& x, const SharedNoiseModel& model) const {
+   // Only linearize if the factor is active
+   if (!active(x))
+     return std::shared_ptr<JacobianFactor>();
+
+   // In case noise model is constrained, we need to provide a noise model
+   SharedDiagonal noiseModel;
+   if (model && model->isConstrained()) {
+     noiseModel =
+         std::static_pointer_cast<noiseModel::Constrained>(model)->unit();
+   }
+
+   // Create a writeable JacobianFactor in advance
+   std::shared_ptr<JacobianFactor> factor(
+       new JacobianFactor(keys_, dims_, Dim, noiseModel));
+
+   // Wrap keys and VerticalBlockMatrix into structure passed to expression_
+   VerticalBlockMatrix& Ab = factor->matrixObject();
+   internal::JacobianMap jacobianMap(keys_, Ab);
+
+   // Zero out Jacobian so we can simply add to it
+   Ab.matrix().setZero();
+
+   // Get value and Jacobians, writing directly into JacobianFactor
+   T value = expression_.valueAndJacobianMap(x, jacobianMap); // <<< Reverse AD happens here !
+
+   // Evaluate error and set RHS vector b
+   Ab(size()).col(0) = traits<T>::Local(value, measured_);
+
+   // Whiten the corresponding system, Ab already contains RHS
+   if (model) {
+     Vector b = Ab(size()).col(0);  // need b to be valid for Robust noise models
+     model->WhitenSystem(Ab.matrix(), b);
+   }
+
+   return factor;
+ }
+
 private:
 #ifdef GTSAM_ENABLE_BOOST_SERIALIZATION
  /// Save to an archive: just saves the base class
@@ -26,10 +26,16 @@
 
 #pragma once
 
+#include <gtsam/config.h>
 #include <gtsam/nonlinear/GncParams.h>
 #include <gtsam/nonlinear/NonlinearFactorGraph.h>
 #include <boost/math/distributions/chi_squared.hpp>
 
+#ifdef GTSAM_USE_TBB
+#include <tbb/blocked_range.h>
+#include <tbb/parallel_for.h>
+#endif
+
 namespace gtsam {
 /*
  * Quantile of chi-squared distribution with given degrees of freedom at probability alpha.
@@ -183,9 +189,17 @@ class GncOptimizer {
 
   /// Compute optimal solution using graduated non-convexity.
   Values optimize() {
+    // All weighted graphs share the structure of nfg_, so the elimination
+    // ordering is computed once rather than by every inner optimizer.
+    auto baseOptimizerParams = params_.baseOptimizerParams;
+    if (!baseOptimizerParams.ordering) {
+      baseOptimizerParams.ordering =
+          Ordering::Create(baseOptimizerParams.orderingType, nfg_);
+    }
+
     NonlinearFactorGraph graph_initial = this->makeWeightedGraph(weights_);
     BaseOptimizer baseOptimizer(
-        graph_initial, state_, params_.baseOptimizerParams);
+        graph_initial, state_, baseOptimizerParams);
     Values result = baseOptimizer.optimize();
     double mu = initializeMu();
     double prev_cost = graph_initial.error(result);
@@ -231,16 +245,17 @@ class GncOptimizer {
         result.print("result\n");
       }
       // weights update
+      const Vector previousWeights = weights_;
       weights_ = calculateWeights(result, mu);
 
-      // variable/values update
-      NonlinearFactorGraph graph_iter = this->makeWeightedGraph(weights_);
+      // variable/values update: only factors whose weight changed are replaced
+      updateWeightedGraph(previousWeights, weights_, graph_initial);
       BaseOptimizer baseOptimizer_iter(
-          graph_iter, state_, params_.baseOptimizerParams);
+          graph_initial, state_, baseOptimizerParams);
       result = baseOptimizer_iter.optimize();
 
       // stopping condition
-      cost = graph_iter.error(result);
+      cost = graph_initial.error(result);
       if (checkConvergence(mu, weights_, cost, prev_cost)) {
         break;
       }
@@ -401,24 +416,64 @@ class GncOptimizer {
     newGraph.resize(nfg_.size());
     for (size_t i = 0; i < nfg_.size(); i++) {
       if (nfg_[i]) {
-        auto factor = std::dynamic_pointer_cast<
-            NoiseModelFactor>(nfg_[i]);
-        auto noiseModel =
-            std::dynamic_pointer_cast<noiseModel::Gaussian>(
-                factor->noiseModel());
-        if (noiseModel) {
-          Matrix newInfo = weights[i] * noiseModel->information();
-          auto newNoiseModel = noiseModel::Gaussian::Information(newInfo);
-          newGraph[i] = factor->cloneWithNewNoiseModel(newNoiseModel);
-        } else {
-          throw std::runtime_error(
-              "GncOptimizer::makeWeightedGraph: unexpected non-Gaussian noise model.");
-        }
+        newGraph[i] = makeWeightedFactor(i, weights[i]);
       }
     }
     return newGraph;
   }
 
+  /// Update a graph created by makeWeightedGraph(previousWeights) in place,
+  /// re-weighting only the factors whose weight changed.
+  void updateWeightedGraph(const Vector& previousWeights, const Vector& weights,
+                           NonlinearFactorGraph& weightedGraph) const {
+    for (size_t i = 0; i < nfg_.size(); i++) {
+      if (nfg_[i] && weights[i] != previousWeights[i]) {
+        weightedGraph[i] = makeWeightedFactor(i, weights[i]);
+      }
+    }
+  }
+
+  /// Copy of factor i with its information matrix scaled by the given weight.
+  NonlinearFactor::shared_ptr makeWeightedFactor(size_t i, double weight) const {
+    auto factor = std::dynamic_pointer_cast<NoiseModelFactor>(nfg_[i]);
+    auto noiseModel =
+        std::dynamic_pointer_cast<noiseModel::Gaussian>(factor->noiseModel());
+    if (!noiseModel) {
+      throw std::runtime_error(
+          "GncOptimizer::makeWeightedGraph: unexpected non-Gaussian noise model.");
+    }
+    Matrix newInfo = weight * noiseModel->information();
+    auto newNoiseModel = noiseModel::Gaussian::Information(newInfo);
+    return factor->cloneWithNewNoiseModel(newNoiseModel);
+  }
+
+  /// Whitened squared residuals of the factors with the given indices (zero
+  /// for all others). With TBB, sendable factors are evaluated in parallel and
+  /// the others serially, as in NonlinearFactorGraph::error.
+  Vector calculateSquaredResiduals(const Values& currentEstimate,
+                                   const std::vector<size_t>& indices) const {
+    Vector u2 = Vector::Zero(nfg_.size());
+#ifdef GTSAM_USE_TBB
+    tbb::parallel_for(tbb::blocked_range<size_t>(0, indices.size()),
+                      [&](const tbb::blocked_range<size_t>& range) {
+                        for (size_t j = range.begin(); j != range.end(); j++) {
+                          const size_t k = indices[j];
+                          if (nfg_[k] && nfg_[k]->sendable())
+                            u2[k] = nfg_[k]->error(currentEstimate);
+                        }
+                      });
+    for (size_t k : indices) {
+      if (nfg_[k] && !nfg_[k]->sendable())
+        u2[k] = nfg_[k]->error(currentEstimate);
+    }
+#else
+    for (size_t k : indices) {
+      if (nfg_[k]) u2[k] = nfg_[k]->error(currentEstimate);
+    }
+#endif
+    return u2;
+  }
+
   /// Calculate gnc weights.
   Vector calculateWeights(const Values& currentEstimate, const double mu) {
     Vector weights = initializeWeightsFromKnownInliersAndOutliers();
@@ -438,38 +493,36 @@ class GncOptimizer {
                         knownWeights.begin(), knownWeights.end(),
                         std::inserter(unknownWeights, unknownWeights.begin()));
 
-    // update weights of known inlier/outlier measurements
+    // squared (and whitened) residuals
+    const Vector u2 = calculateSquaredResiduals(currentEstimate, unknownWeights);
+
+    // update weights of known inlier/outlier measurements, evaluating the
+    // weights of all factors in one pass
+    const Eigen::ArrayXd r2 = u2.array(), barcSq = barcSq_.array();
+    Vector updatedWeights;
     switch (params_.lossType) {
       case GncLossType::GM: {  // use eq (12) in GNC paper
-        for (size_t k : unknownWeights) {
-          if (nfg_[k]) {
-            double u2_k = nfg_[k]->error(currentEstimate);  // squared (and whitened) residual
-            weights[k] = std::pow(
-                (mu * barcSq_[k]) / (u2_k + mu * barcSq_[k]), 2);
-          }
-        }
-        return weights;
+        updatedWeights = ((mu * barcSq) / (r2 + mu * barcSq)).square().matrix();
+        break;
       }
       case GncLossType::TLS: {  // use eq (14) in GNC paper
-        for (size_t k : unknownWeights) {
-          if (nfg_[k]) {
-            double u2_k = nfg_[k]->error(currentEstimate);  // squared (and whitened) residual
-            double upperbound = (mu + 1) / mu * barcSq_[k];
-            double lowerbound = mu / (mu + 1) * barcSq_[k];
-            weights[k] = std::sqrt(barcSq_[k] * mu * (mu + 1) / u2_k) - mu;
-            if (u2_k >= upperbound || weights[k] < 0) {
-              weights[k] = 0;
-            } else if (u2_k <= lowerbound || weights[k] > 1) {
-              weights[k] = 1;
-            }
-          }
-        }
-        return weights;
+        const Eigen::ArrayXd upperbound = (mu + 1) / mu * barcSq;
+        const Eigen::ArrayXd lowerbound = mu / (mu + 1) * barcSq;
+        const Eigen::ArrayXd w = (barcSq * mu * (mu + 1) / r2).sqrt() - mu;
+        updatedWeights = (r2 >= upperbound || w < 0)
+                             .select(0.0, (r2 <= lowerbound || w > 1)
+                                              .select(1.0, w))
+                             .matrix();
+        break;
       }
       default:
         throw std::runtime_error(
             "GncOptimizer::calculateWeights: called with unknown loss type.");
     }
+    for (size_t k : unknownWeights) {
+      if (nfg_[k]) weights[k] = updatedWeights[k];
+    }
+    return weights;
   }
 };
 
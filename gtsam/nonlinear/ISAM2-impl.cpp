@@ -47,7 +47,8 @@ inline static void optimizeInPlace(const ISAM2::sharedClique& clique,
 size_t DeltaImpl::UpdateGaussNewtonDelta(const ISAM2::Roots& roots,
                                            const KeySet& replacedKeys,
                                            double wildfireThreshold,
-                                           VectorValues* delta) {
+                                           VectorValues* delta,
+                                           KeySet* changedKeys) {
   size_t lastBacksubVariableCount;
 
   if (wildfireThreshold <= 0.0) {
@@ -55,13 +56,16 @@ size_t DeltaImpl::UpdateGaussNewtonDelta(const ISAM2::Roots& roots,
     for (const ISAM2::sharedClique& root : roots)
       internal::optimizeInPlace(root, delta);
     lastBacksubVariableCount = delta->size();
+    if (changedKeys)
+      for (const auto& [key, _] : *delta) changedKeys->insert(key);
 
   } else {
     // Optimize with wildfire
     lastBacksubVariableCount = 0;
     for (const ISAM2::sharedClique& root : roots)
       lastBacksubVariableCount += optimizeWildfireNonRecursive(
-          root, wildfireThreshold, replacedKeys, delta);  // modifies delta
+          root, wildfireThreshold, replacedKeys, delta,
+          changedKeys);  // modifies delta
 
 #if !defined(NDEBUG) && defined(GTSAM_EXTRA_CONSISTENCY_CHECKS)
     for (VectorValues::const_iterator key_delta = delta->begin();
@@ -76,12 +76,14 @@ struct GTSAM_EXPORT DeltaImpl {
   };
 
   /**
-   * Update the Newton's method step point, using wildfire
+   * Update the Newton's method step point, using wildfire. If \c changedKeys
+   * is given, the variables whose delta entries were modified are added to it.
    */
   static size_t UpdateGaussNewtonDelta(const ISAM2::Roots& roots,
                                        const KeySet& replacedKeys,
                                        double wildfireThreshold,
-                                       VectorValues* delta);
+                                       VectorValues* delta,
+                                       KeySet* changedKeys = nullptr);
 
   /**
    * Update the RgProd (R*g) incrementally taking into account which variables
@@ -508,6 +510,64 @@ struct GTSAM_EXPORT UpdateImpl {
 
     return cachedBoundary;
   }
+
+  // Ordering of the affected variables that keeps their previous elimination
+  // order: removeTop returns parents before children, so the affected keys are
+  // reversed, new variables are appended, and the result is stably sorted by
+  // constraint group.
+  static Ordering ReusedOrdering(const VariableIndex& affectedFactorsVarIndex,
+                                 const FastList<Key>& affectedKeys,
+                                 const KeyVector& observedKeys,
+                                 const FastMap<Key, int>& constraintGroups) {
+    std::vector<std::pair<int, Key>> groupKeys;
+    groupKeys.reserve(affectedFactorsVarIndex.size());
+    KeySet added;
+    auto add = [&](Key key) {
+      if (affectedFactorsVarIndex.find(key) == affectedFactorsVarIndex.end() ||
+          !added.insert(key).second)
+        return;
+      const auto group = constraintGroups.find(key);
+      groupKeys.emplace_back(
+          group == constraintGroups.end() ? 0 : group->second, key);
+    };
+    for (auto key = affectedKeys.rbegin(); key != affectedKeys.rend(); ++key)
+      add(*key);
+    for (Key key : observedKeys) add(key);
+    // Variables only reached through cached boundary factors, if any
+    for (const auto& key_factors : affectedFactorsVarIndex)
+      add(key_factors.first);
+
+    std::stable_sort(groupKeys.begin(), groupKeys.end(),
+                     [](const std::pair<int, Key>& a,
+                        const std::pair<int, Key>& b) {
+                       return a.first < b.first;
+                     });
+
+    Ordering ordering;
+    ordering.reserve(groupKeys.size());
+    for (const auto& group_key : groupKeys) ordering.push_back(group_key.second);
+    return ordering;
+  }
+
+  // Number of entries of the square root information matrix stored in the
+  // cliques indexed by nodes, counting each clique once.
+  static size_t Fill(const ISAM2::Nodes& nodes) {
+    size_t fill = 0;
+    for (const auto& key_clique : nodes) {
+      const auto& conditional = key_clique.second->conditional();
+      if (conditional->front() == key_clique.first)
+        fill += conditional->rows() * (conditional->cols() - 1);
+    }
+    return fill;
+  }
+
+  // Same count for the conditionals of a Bayes net.
+  static size_t Fill(const GaussianBayesNet& bayesNet) {
+    size_t fill = 0;
+    for (const auto& conditional : bayesNet)
+      fill += conditional->rows() * (conditional->cols() - 1);
+    return fill;
+  }
 };
 
 }  // namespace gtsam
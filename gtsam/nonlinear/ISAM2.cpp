@@ -27,6 +27,8 @@
 
 #include <algorithm>
 #include <map>
+#include <memory>
+#include <set>
 #include <utility>
 #include <variant>
 
@@ -38,15 +40,22 @@ namespace gtsam {
 template class BayesTree<ISAM2Clique>;
 
 /* ************************************************************************* */
-ISAM2::ISAM2(const ISAM2Params& params) : params_(params), update_count_(0) {
+ISAM2::ISAM2(const ISAM2Params& params)
+    : params_(params),
+      update_count_(0),
+      fill_(0),
+      fillPerVariableAtReorder_(0.0) {
   if (std::holds_alternative<ISAM2DoglegParams>(params_.optimizationParams)) {
     doglegDelta_ =
         std::get<ISAM2DoglegParams>(params_.optimizationParams).initialDelta;
   }
+  if (params_.enableSnapshots)
+    snapshot_ = std::make_shared<const ISAM2Snapshot>(
+        params_.getEliminationFunction());
 }
 
 /* ************************************************************************* */
-ISAM2::ISAM2() : update_count_(0) {
+ISAM2::ISAM2() : update_count_(0), fill_(0), fillPerVariableAtReorder_(0.0) {
   if (std::holds_alternative<ISAM2DoglegParams>(params_.optimizationParams)) {
     doglegDelta_ =
         std::get<ISAM2DoglegParams>(params_.optimizationParams).initialDelta;
@@ -119,6 +128,11 @@ void ISAM2::recalculate(const ISAM2UpdateParams& updateParams,
   UpdateImpl::LogRecalculateKeys(*result);
 
   if (!result->markedKeys.empty() || !result->observedKeys.empty()) {
+    // When reusing the previous ordering, check whether it has degraded enough
+    // to reorder everything. This has to happen before removing the top.
+    const bool reorder =
+        params_.incrementalOrdering && fillExceedsReorderThreshold();
+
     // Remove top of Bayes tree and convert to a factor graph:
     // (a) For each affected variable, remove the corresponding clique and all
     // parents up to the root. (b) Store orphaned sub-trees \BayesTree_{O} of
@@ -151,9 +165,12 @@ void ISAM2::recalculate(const ISAM2UpdateParams& updateParams,
                           conditional->endFrontals());
     gttoc(affectedKeys);
 
+    if (params_.incrementalOrdering)
+      fill_ -= UpdateImpl::Fill(affectedBayesNet);
+
     KeySet affectedKeysSet;
     static const double kBatchThreshold = 0.65;
-    if (affectedKeys.size() >= theta_.size() * kBatchThreshold) {
+    if (reorder || affectedKeys.size() >= theta_.size() * kBatchThreshold) {
       // Do a batch step - reorder and relinearize all variables
       recalculateBatch(updateParams, &affectedKeysSet, result);
     } else {
@@ -234,6 +251,15 @@ void ISAM2::recalculateBatch(const ISAM2UpdateParams& updateParams,
   nodes_.insert(bayesTree->nodes().begin(), bayesTree->nodes().end());
   gttoc(insert);
 
+  if (params_.enableSnapshots)
+    for (const auto& [key, _] : nodes_) snapshotChangedCliques_.insert(key);
+
+  if (params_.incrementalOrdering) {
+    fill_ = UpdateImpl::Fill(nodes_);
+    fillPerVariableAtReorder_ =
+        nodes_.empty() ? 0.0 : static_cast<double>(fill_) / nodes_.size();
+  }
+
   result->variablesReeliminated = affectedKeysSet->size();
   result->factorsRecalculated = nonlinearFactors_.size();
 
@@ -341,7 +367,11 @@ void ISAM2::recalculateIncremental(const ISAM2UpdateParams& updateParams,
   // Generate ordering
   gttic(Ordering);
   const Ordering ordering =
-      Ordering::ColamdConstrained(affectedFactorsVarIndex, constraintGroups);
+      params_.incrementalOrdering
+          ? UpdateImpl::ReusedOrdering(affectedFactorsVarIndex, affectedKeys,
+                                       result->observedKeys, constraintGroups)
+          : Ordering::ColamdConstrained(affectedFactorsVarIndex,
+                                        constraintGroups);
   gttoc(Ordering);
 
   // Do elimination
@@ -357,6 +387,15 @@ void ISAM2::recalculateIncremental(const ISAM2UpdateParams& updateParams,
   nodes_.insert(bayesTree->nodes().begin(), bayesTree->nodes().end());
   gttoc(reassemble);
 
+  // The orphans keep their conditionals but have new parents
+  if (params_.enableSnapshots) {
+    for (const auto& [key, _] : bayesTree->nodes())
+      snapshotChangedCliques_.insert(key);
+    for (const auto& orphan : *orphans) markSnapshotClique(orphan);
+  }
+
+  if (params_.incrementalOrdering) fill_ += UpdateImpl::Fill(bayesTree->nodes());
+
   // 4. The orphans have already been inserted during elimination
 }
 
@@ -372,6 +411,9 @@ void ISAM2::addVariables(const Values& newTheta,
   deltaNewton_.insert(newTheta.zeroVectors());
   RgProd_.insert(newTheta.zeroVectors());
 
+  if (params_.enableSnapshots)
+    for (Key key : newTheta.keys()) snapshotChangedEstimates_.insert(key);
+
   // New keys for detailed results
   if (detail && params_.enableDetailedResults) {
     for (Key key : newTheta.keys()) {
@@ -394,6 +436,11 @@ void ISAM2::removeVariables(const KeySet& unusedKeys) {
     theta_.erase(key);
     fixedVariables_.erase(key);
   }
+
+  if (params_.enableSnapshots) {
+    snapshotChangedEstimates_.insert(unusedKeys.begin(), unusedKeys.end());
+    snapshotChangedCliques_.insert(unusedKeys.begin(), unusedKeys.end());
+  }
 }
 
 /* ************************************************************************* */
@@ -459,6 +506,8 @@ ISAM2Result ISAM2::update(const NonlinearFactorGraph& newFactors,
       // 6. Update linearization point for marked variables:
       // \Theta_{J}:=\Theta_{J}+\Delta_{J}.
       theta_.retractMasked(delta_, relinKeys);
+      if (params_.enableSnapshots)
+        snapshotChangedEstimates_.insert(relinKeys.begin(), relinKeys.end());
     }
     result.variablesRelinearized = result.markedKeys.size();
   }
@@ -476,6 +525,7 @@ ISAM2Result ISAM2::update(const NonlinearFactorGraph& newFactors,
 
   if (params_.evaluateNonlinearError)
     update.error(nonlinearFactors_, calculateEstimate(), &result.errorAfter);
+  if (params_.enableSnapshots) publishSnapshot();
   return result;
 }
 
@@ -629,7 +679,16 @@ void ISAM2::marginalizeLeaves(
         if (eliminationResult1.second)
           marginalFactors[cg->front()].push_back(eliminationResult1.second);
 
-        // Split the current clique
+        // Split the current clique. Published snapshots share its conditional,
+        // so split a copy in that case.
+        if (params_.enableSnapshots) {
+          clique->conditional_ = std::make_shared<GaussianConditional>(*cg);
+          cg = clique->conditional_;
+          markSnapshotClique(clique);
+          for (const sharedClique& child : clique->children)
+            markSnapshotClique(child);
+        }
+
         // Find the position of the last leaf key in this clique
         DenseIndex nToRemove = 0;
         while (leafKeys.exists(cg->keys()[nToRemove])) ++nToRemove;
@@ -698,6 +757,23 @@ void ISAM2::marginalizeLeaves(
 
   // Remove the marginalized variables
   removeVariables(KeySet(leafKeys.begin(), leafKeys.end()));
+
+  // Cliques were changed in place, recount the fill when next needed
+  fill_ = 0;
+
+  if (params_.enableSnapshots) publishSnapshot();
+}
+
+/* ************************************************************************* */
+bool ISAM2::fillExceedsReorderThreshold() {
+  if (nodes_.empty()) return false;
+  if (fill_ == 0) fill_ = UpdateImpl::Fill(nodes_);
+  const double fillPerVariable = static_cast<double>(fill_) / nodes_.size();
+  if (fillPerVariableAtReorder_ == 0.0) {
+    fillPerVariableAtReorder_ = fillPerVariable;
+    return false;
+  }
+  return fillPerVariable > params_.reorderFillFactor * fillPerVariableAtReorder_;
 }
 
 /* ************************************************************************* */
@@ -711,8 +787,9 @@ void ISAM2::updateDelta(bool forceFullSolve) const {
     const double effectiveWildfireThreshold =
         forceFullSolve ? 0.0 : gaussNewtonParams.wildfireThreshold;
     gttic(Wildfire_update);
-    DeltaImpl::UpdateGaussNewtonDelta(roots_, deltaReplacedMask_,
-                                      effectiveWildfireThreshold, &delta_);
+    DeltaImpl::UpdateGaussNewtonDelta(
+        roots_, deltaReplacedMask_, effectiveWildfireThreshold, &delta_,
+        params_.enableSnapshots ? &snapshotChangedEstimates_ : nullptr);
     deltaReplacedMask_.clear();
     gttoc(Wildfire_update);
   } else if (std::holds_alternative<ISAM2DoglegParams>(params_.optimizationParams)) {
@@ -757,6 +834,8 @@ void ISAM2::updateDelta(bool forceFullSolve) const {
         doglegResult
             .dx_d;  // Copy the VectorValues containing with the linear solution
     gttoc(Copy_dx_d);
+    if (params_.enableSnapshots)
+      for (const auto& [key, _] : delta_) snapshotChangedEstimates_.insert(key);
   } else {
     throw std::runtime_error("iSAM2: unknown ISAM2Params type");
   }
@@ -790,6 +869,50 @@ Matrix ISAM2::marginalCovariance(Key key) const {
       .inverse();
 }
 
+/* ************************************************************************* */
+void ISAM2::publishSnapshot() {
+  gttic(ISAM2_publishSnapshot);
+  const VectorValues& delta = getDelta();
+  auto snapshot = std::make_shared<ISAM2Snapshot>(*std::atomic_load(&snapshot_));
+  snapshot->version_ += 1;
+
+  for (Key key : snapshotChangedEstimates_) {
+    if (theta_.exists(key))
+      snapshot->estimate_ = snapshot->estimate_.assign(
+          key, std::shared_ptr<const Value>(theta_.at(key).retract_(delta[key])));
+    else
+      snapshot->estimate_ = snapshot->estimate_.erase(key);
+  }
+
+  std::set<const Clique*> published;
+  for (Key key : snapshotChangedCliques_) {
+    const auto node = nodes_.find(key);
+    if (node == nodes_.end()) {
+      snapshot->cliques_ = snapshot->cliques_.erase(key);
+      continue;
+    }
+    const sharedClique& clique = node->second;
+    if (!published.insert(clique.get()).second) continue;
+    auto snapshotClique = std::make_shared<ISAM2Snapshot::Clique>();
+    snapshotClique->conditional = clique->conditional();
+    if (const sharedClique parent = clique->parent())
+      snapshotClique->parent = parent->conditional()->front();
+    for (Key frontal : clique->conditional()->frontals())
+      snapshot->cliques_ = snapshot->cliques_.assign(frontal, snapshotClique);
+  }
+
+  snapshotChangedEstimates_.clear();
+  snapshotChangedCliques_.clear();
+  std::atomic_store(&snapshot_, ISAM2Snapshot::shared_ptr(snapshot));
+}
+
+/* ************************************************************************* */
+void ISAM2::markSnapshotClique(const sharedClique& clique) {
+  const auto& conditional = clique->conditional();
+  snapshotChangedCliques_.insert(conditional->beginFrontals(),
+                                 conditional->endFrontals());
+}
+
 /* ************************************************************************* */
 const VectorValues& ISAM2::getDelta() const {
   if (!deltaReplacedMask_.empty()) updateDelta();
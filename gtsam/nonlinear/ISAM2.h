@@ -24,6 +24,7 @@
 #include <gtsam/nonlinear/ISAM2Clique.h>
 #include <gtsam/nonlinear/ISAM2Params.h>
 #include <gtsam/nonlinear/ISAM2Result.h>
+#include <gtsam/nonlinear/ISAM2Snapshot.h>
 #include <gtsam/nonlinear/ISAM2UpdateParams.h>
 #include <gtsam/nonlinear/NonlinearFactorGraph.h>
 
@@ -96,6 +97,24 @@ class GTSAM_EXPORT ISAM2 : public BayesTree<ISAM2Clique> {
   int update_count_;  ///< Counter incremented every update(), used to determine
                       ///< periodic relinearization
 
+  /** Entries of the square root information matrix in the Bayes tree, only
+   * tracked with ISAM2Params::incrementalOrdering, zero if not yet computed */
+  size_t fill_;
+
+  /** Fill per variable after the last full reordering, zero if unknown */
+  double fillPerVariableAtReorder_;
+
+  /** The last published snapshot, only accessed with std::atomic_load and
+   * std::atomic_store, see ISAM2Params::enableSnapshots */
+  ISAM2Snapshot::shared_ptr snapshot_;
+
+  /** Variables whose estimate changed since the last published snapshot. This
+   * is \c mutable because updateDelta() changes the estimate. */
+  mutable KeySet snapshotChangedEstimates_;
+
+  /** Variables whose clique changed since the last published snapshot */
+  KeySet snapshotChangedCliques_;
+
  public:
   using This = ISAM2;                       ///< This class
   using Base = BayesTree<ISAM2Clique>;      ///< The BayesTree base class
@@ -251,6 +270,16 @@ class GTSAM_EXPORT ISAM2 : public BayesTree<ISAM2Clique> {
   /** Return marginal on any variable as a covariance matrix */
   Matrix marginalCovariance(Key key) const;
 
+  /**
+   * The snapshot published after the last update or marginalizeLeaves call.
+   * Unlike all other methods, this may be called from any thread while ISAM2
+   * is being updated, and the returned snapshot can be queried without locks.
+   * Returns nullptr unless ISAM2Params::enableSnapshots is set.
+   */
+  ISAM2Snapshot::shared_ptr snapshot() const {
+    return std::atomic_load(&snapshot_);
+  }
+
   /// @name Public members for non-typical usage
   /// @{
 
@@ -339,6 +368,16 @@ class GTSAM_EXPORT ISAM2 : public BayesTree<ISAM2Clique> {
 
   void updateDelta(bool forceFullSolve = false) const;
 
+  /// Publish a new snapshot that shares everything unchanged with the last one
+  void publishSnapshot();
+
+  /// Record that the cliques of the frontal variables of \c clique changed
+  void markSnapshotClique(const sharedClique& clique);
+
+  /// Whether the fill has grown enough since the last full reordering to
+  /// reorder all variables, see ISAM2Params::incrementalOrdering.
+  bool fillExceedsReorderThreshold();
+
  private:
 #ifdef GTSAM_ENABLE_BOOST_SERIALIZATION
   /** Serialization function */
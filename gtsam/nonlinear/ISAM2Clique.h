@@ -172,8 +172,11 @@ class GTSAM_EXPORT ISAM2Clique
 size_t optimizeWildfire(const ISAM2Clique::shared_ptr& root, double threshold,
                         const KeySet& replaced, VectorValues* delta);
 
+/// Non-recursive version of optimizeWildfire. If \c changed is given, the
+/// variables whose delta entries were modified are added to it.
 size_t optimizeWildfireNonRecursive(const ISAM2Clique::shared_ptr& root,
                                     double threshold, const KeySet& replaced,
-                                    VectorValues* delta);
+                                    VectorValues* delta,
+                                    KeySet* changed = nullptr);
 
 }  // namespace gtsam
@@ -224,6 +224,26 @@ struct GTSAM_EXPORT ISAM2Params {
   /// cost of having to search for slots every time a factor is added.
   bool findUnusedFactorSlots;
 
+  /** Reuse the previous elimination order of the re-eliminated variables
+   * instead of computing a constrained COLAMD ordering in every update
+   * (default: false). New and newly observed variables are ordered last. The
+   * order is never improved locally, so ISAM2 tracks the fill of the Bayes tree
+   * and reorders all variables in a batch step once the fill per variable
+   * exceeds reorderFillFactor times its value after the last full reordering.
+   */
+  bool incrementalOrdering;
+
+  /// Growth of the fill per variable that triggers a full reordering when
+  /// incrementalOrdering is enabled (default: 1.5)
+  double reorderFillFactor;
+
+  /** Publish an immutable ISAM2Snapshot after every update and
+   * marginalizeLeaves call (default: false), see ISAM2::snapshot(). Snapshots
+   * share unchanged estimates and cliques with the previous version, so this
+   * costs time proportional to what the update changed.
+   */
+  bool enableSnapshots;
+
   /**
    * Specify parameters as constructor arguments
    * See the documentation of member variables above.
@@ -247,7 +267,10 @@ struct GTSAM_EXPORT ISAM2Params {
         keyFormatter(_keyFormatter),
         enableDetailedResults(_enableDetailedResults),
         enablePartialRelinearizationCheck(false),
-        findUnusedFactorSlots(false) {}
+        findUnusedFactorSlots(false),
+        incrementalOrdering(false),
+        reorderFillFactor(1.5),
+        enableSnapshots(false) {}
 
   /// print iSAM2 parameters
   void print(const std::string& str = "") const {
@@ -290,6 +313,10 @@ struct GTSAM_EXPORT ISAM2Params {
          << enablePartialRelinearizationCheck << "\n";
     cout << "findUnusedFactorSlots:             " << findUnusedFactorSlots
          << "\n";
+    cout << "incrementalOrdering:               " << incrementalOrdering
+         << "\n";
+    cout << "reorderFillFactor:                 " << reorderFillFactor << "\n";
+    cout << "enableSnapshots:                   " << enableSnapshots << "\n";
     cout.flush();
   }
 
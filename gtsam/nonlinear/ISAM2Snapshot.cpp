@@ -0,0 +1,56 @@
+/* ----------------------------------------------------------------------------
+
+ * GTSAM Copyright 2010, Georgia Tech Research Corporation,
+ * Atlanta, Georgia 30332-0415
+ * All Rights Reserved
+ * Authors: Frank Dellaert, et al. (see THANKS for the full author list)
+
+ * See LICENSE for the license information
+
+ * -------------------------------------------------------------------------- */
+
+/**
+ * @file    ISAM2Snapshot.cpp
+ * @brief   Immutable, structurally shared versions of an ISAM2 solution
+ */
+
+#include <gtsam/nonlinear/ISAM2Snapshot.h>
+#include <gtsam/linear/GaussianBayesNet.h>
+
+namespace gtsam {
+
+/* ************************************************************************* */
+Values ISAM2Snapshot::calculateEstimate() const {
+  Values result;
+  estimate_.forEach([&result](Key j, const std::shared_ptr<const Value>& value) {
+    result.insert(j, *value);
+  });
+  return result;
+}
+
+/* ************************************************************************* */
+const Value& ISAM2Snapshot::calculateEstimate(Key j) const {
+  const std::shared_ptr<const Value>* value = estimate_.find(j);
+  if (!value) throw ValuesKeyDoesNotExist("calculateEstimate", j);
+  return **value;
+}
+
+/* ************************************************************************* */
+Matrix ISAM2Snapshot::marginalCovariance(Key j) const {
+  const std::shared_ptr<const Clique>* clique = cliques_.find(j);
+  if (!clique) throw ValuesKeyDoesNotExist("marginalCovariance", j);
+
+  // The conditionals from the clique up to the root form the joint density
+  // of all variables on that path, the rest of the tree integrates out.
+  GaussianFactorGraph path;
+  for (const Clique* current = clique->get(); current;) {
+    path.push_back(current->conditional);
+    current = current->parent ? cliques_.find(*current->parent)->get() : nullptr;
+  }
+  return path.marginalMultifrontalBayesNet(Ordering{j}, function_)
+      ->front()
+      ->information()
+      .inverse();
+}
+
+}  // namespace gtsam
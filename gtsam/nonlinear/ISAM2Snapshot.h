@@ -0,0 +1,250 @@
+/* ----------------------------------------------------------------------------
+
+ * GTSAM Copyright 2010, Georgia Tech Research Corporation,
+ * Atlanta, Georgia 30332-0415
+ * All Rights Reserved
+ * Authors: Frank Dellaert, et al. (see THANKS for the full author list)
+
+ * See LICENSE for the license information
+
+ * -------------------------------------------------------------------------- */
+
+/**
+ * @file    ISAM2Snapshot.h
+ * @brief   Immutable, structurally shared versions of an ISAM2 solution
+ */
+
+// \callgraph
+
+#pragma once
+
+#include <gtsam/linear/GaussianConditional.h>
+#include <gtsam/linear/GaussianFactorGraph.h>
+#include <gtsam/nonlinear/Values.h>
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <utility>
+#include <vector>
+
+namespace gtsam {
+
+namespace internal {
+
+/**
+ * Persistent map from keys to values of type T, stored as a hashed trie.
+ * assign() and erase() return a new map and leave this one untouched; the two
+ * share every node that is not on the path to the changed key, so a change
+ * costs O(log n) instead of a copy of the whole map.
+ */
+template <class T>
+class SharedKeyMap {
+  static constexpr size_t kBits = 5;
+  static constexpr size_t kWidth = size_t(1) << kBits;
+  static constexpr uint64_t kMask = kWidth - 1;
+  static constexpr size_t kLeafSize = 16;
+
+  typedef std::pair<Key, T> Entry;
+
+  struct Node {
+    bool branch = false;
+    std::vector<Entry> entries;  ///< Entries of a leaf, sorted by key
+    std::array<std::shared_ptr<const Node>, kWidth> children;  ///< Of a branch
+  };
+  typedef std::shared_ptr<const Node> NodePtr;
+
+  NodePtr root_;
+  size_t size_ = 0;
+
+  // Multiplication by an odd constant is a bijection, so distinct keys never
+  // collide and sequential keys are spread over the trie.
+  static uint64_t Hash(Key j) { return j * 0x9E3779B97F4A7C15ull; }
+
+  static bool KeyLess(const Entry& entry, Key j) { return entry.first < j; }
+
+  static NodePtr Assign(const NodePtr& node, uint64_t hash, size_t shift,
+                        Key j, T&& value, bool* inserted) {
+    auto result =
+        node ? std::make_shared<Node>(*node) : std::make_shared<Node>();
+    if (result->branch) {
+      NodePtr& child = result->children[(hash >> shift) & kMask];
+      child = Assign(child, hash, shift + kBits, j, std::move(value), inserted);
+      return result;
+    }
+
+    std::vector<Entry>& entries = result->entries;
+    auto it = std::lower_bound(entries.begin(), entries.end(), j, KeyLess);
+    if (it != entries.end() && it->first == j) {
+      it->second = std::move(value);
+    } else {
+      entries.emplace(it, j, std::move(value));
+      *inserted = true;
+    }
+
+    // Split a full leaf while there are hash bits left to distinguish keys
+    if (entries.size() > kLeafSize && shift < 64) {
+      std::array<std::shared_ptr<Node>, kWidth> children;
+      for (Entry& entry : entries) {
+        std::shared_ptr<Node>& child =
+            children[(Hash(entry.first) >> shift) & kMask];
+        if (!child) child = std::make_shared<Node>();
+        child->entries.push_back(std::move(entry));
+      }
+      entries.clear();
+      result->branch = true;
+      std::copy(children.begin(), children.end(), result->children.begin());
+    }
+    return result;
+  }
+
+  static NodePtr Erase(const NodePtr& node, uint64_t hash, size_t shift,
+                       Key j, bool* erased) {
+    if (!node) return node;
+    if (node->branch) {
+      const size_t i = (hash >> shift) & kMask;
+      NodePtr child = Erase(node->children[i], hash, shift + kBits, j, erased);
+      if (!*erased) return node;
+      auto result = std::make_shared<Node>(*node);
+      result->children[i] = child;
+      return result;
+    }
+
+    const std::vector<Entry>& entries = node->entries;
+    auto it = std::lower_bound(entries.begin(), entries.end(), j, KeyLess);
+    if (it == entries.end() || it->first != j) return node;
+    *erased = true;
+    if (entries.size() == 1) return NodePtr();
+    auto result = std::make_shared<Node>(*node);
+    result->entries.erase(result->entries.begin() + (it - entries.begin()));
+    return result;
+  }
+
+  template <class FUNC>
+  static void ForEach(const Node& node, FUNC&& f) {
+    if (node.branch) {
+      for (const NodePtr& child : node.children)
+        if (child) ForEach(*child, f);
+    } else {
+      for (const Entry& entry : node.entries) f(entry.first, entry.second);
+    }
+  }
+
+ public:
+  /// Number of entries
+  size_t size() const { return size_; }
+
+  /// Whether the map is empty
+  bool empty() const { return size_ == 0; }
+
+  /// The value stored for \c j, or nullptr if there is none
+  const T* find(Key j) const {
+    const uint64_t hash = Hash(j);
+    const Node* node = root_.get();
+    for (size_t shift = 0; node && node->branch; shift += kBits)
+      node = node->children[(hash >> shift) & kMask].get();
+    if (!node) return nullptr;
+    auto it = std::lower_bound(node->entries.begin(), node->entries.end(), j,
+                               KeyLess);
+    return (it != node->entries.end() && it->first == j) ? &it->second
+                                                          : nullptr;
+  }
+
+  /// Call f(key, value) for all entries, in no particular order
+  template <class FUNC>
+  void forEach(FUNC&& f) const {
+    if (root_) ForEach(*root_, f);
+  }
+
+  /// A map in which \c j is set to \c value, inserting it if needed
+  SharedKeyMap assign(Key j, T value) const {
+    SharedKeyMap result;
+    bool inserted = false;
+    result.root_ = Assign(root_, Hash(j), 0, j, std::move(value), &inserted);
+    result.size_ = size_ + (inserted ? 1 : 0);
+    return result;
+  }
+
+  /// A map without \c j, which does not need to exist
+  SharedKeyMap erase(Key j) const {
+    SharedKeyMap result;
+    bool erased = false;
+    result.root_ = Erase(root_, Hash(j), 0, j, &erased);
+    result.size_ = size_ - (erased ? 1 : 0);
+    return result;
+  }
+};
+
+}  // namespace internal
+
+/**
+ * @ingroup isam2
+ * An immutable version of the ISAM2 estimate and Bayes tree, published by
+ * ISAM2 after every update when ISAM2Params::enableSnapshots is set.
+ *
+ * Any number of threads may query a snapshot without locking while ISAM2
+ * keeps updating, and a snapshot stays valid for as long as it is held. The
+ * estimates and cliques are stored in persistent maps, so each new version
+ * shares everything that did not change with the previous one: publishing a
+ * version costs time proportional to the variables and cliques the update
+ * touched, not to the size of the problem.
+ *
+ * Cliques refer to their parent by key instead of by pointer, so the subtrees
+ * that ISAM2 re-attaches below a recomputed top do not have to be copied.
+ * Marginals are computed from the conditionals on the path to the root and
+ * are not cached.
+ */
+class GTSAM_EXPORT ISAM2Snapshot {
+ public:
+  typedef std::shared_ptr<const ISAM2Snapshot> shared_ptr;
+
+  /// A clique of the Bayes tree in a snapshot
+  struct Clique {
+    /// The conditional, shared with ISAM2 and never modified
+    GaussianConditional::shared_ptr conditional;
+    /// A frontal variable of the parent clique, none for a root
+    std::optional<Key> parent;
+  };
+
+  /// Empty snapshot, marginals are computed with \c function
+  explicit ISAM2Snapshot(
+      const GaussianFactorGraph::Eliminate& function = EliminatePreferCholesky)
+      : version_(0), function_(function) {}
+
+  /// Number of snapshots published before this one by the same ISAM2
+  size_t version() const { return version_; }
+
+  /// Number of variables
+  size_t size() const { return estimate_.size(); }
+
+  /// Whether the variable \c j exists
+  bool exists(Key j) const { return estimate_.find(j) != nullptr; }
+
+  /// The estimate of all variables
+  Values calculateEstimate() const;
+
+  /// The estimate of variable \c j, throws ValuesKeyDoesNotExist if absent
+  const Value& calculateEstimate(Key j) const;
+
+  /// The estimate of variable \c j, throws ValuesKeyDoesNotExist if absent
+  template <class VALUE>
+  VALUE calculateEstimate(Key j) const {
+    return calculateEstimate(j).cast<VALUE>();
+  }
+
+  /// Marginal covariance of variable \c j, as ISAM2::marginalCovariance
+  Matrix marginalCovariance(Key j) const;
+
+ private:
+  friend class ISAM2;
+
+  size_t version_;
+  GaussianFactorGraph::Eliminate function_;
+  internal::SharedKeyMap<std::shared_ptr<const Value> > estimate_;
+  /// Clique of every variable, indexed by each of its frontal variables
+  internal::SharedKeyMap<std::shared_ptr<const Clique> > cliques_;
+};
+
+}  // namespace gtsam
@@ -134,6 +134,95 @@ Matrix Marginals::marginalCovariance(Key variable) const {
   return marginalInformation(variable).inverse();
 }
 
+/* ************************************************************************* */
+FastMap<Key, Matrix> Marginals::marginalCovariances() const {
+  gttic(marginalCovariances);
+
+  // Covariance of a clique on its frontal and separator variables, ordered as
+  // the keys of its conditional, with the offset of each key in that matrix.
+  struct CliqueCovariance {
+    FastMap<Key, DenseIndex> offsets;
+    Matrix covariance;
+  };
+  using CliqueAndParent = std::pair<GaussianBayesTree::sharedClique,
+                                    std::shared_ptr<const CliqueCovariance>>;
+
+  FastMap<Key, Matrix> result;
+
+  // Explicit stack, as long chains make for very deep trees. A clique's
+  // covariance is released as soon as all of its children have used it.
+  std::vector<CliqueAndParent> stack;
+  for (const auto& root : bayesTree_.roots()) stack.emplace_back(root, nullptr);
+
+  while (!stack.empty()) {
+    const CliqueAndParent item = std::move(stack.back());
+    stack.pop_back();
+    const auto& clique = item.first;
+    const auto& parent = item.second;
+    const GaussianConditional& conditional = *clique->conditional();
+
+    // Whitened square-root information: the conditional density is
+    // N(R^-1 (d - S x_S), R^-1 R^-T)
+    Matrix R = conditional.R();
+    Matrix S = conditional.S();
+    if (const auto& model = conditional.get_model()) {
+      model->WhitenInPlace(R);
+      if (S.cols() > 0) model->WhitenInPlace(S);
+    }
+    const DenseIndex nF = R.cols(), nS = S.cols();
+    const Matrix Rinv =
+        R.triangularView<Eigen::Upper>().solve(Matrix::Identity(nF, nF));
+
+    auto cov = std::make_shared<CliqueCovariance>();
+    DenseIndex offset = 0;
+    for (auto it = conditional.begin(); it != conditional.end(); ++it) {
+      cov->offsets.emplace(*it, offset);
+      offset += conditional.getDim(it);
+    }
+    Matrix& Sigma = cov->covariance;
+    Sigma.resize(nF + nS, nF + nS);
+
+    if (nS == 0) {
+      Sigma = Rinv * Rinv.transpose();
+    } else {
+      // Gather the separator covariance from the parent clique, which by the
+      // running intersection property contains every separator variable.
+      for (auto i = conditional.beginParents(); i != conditional.endParents();
+           ++i) {
+        const DenseIndex oi = cov->offsets.at(*i),
+                         pi = parent->offsets.at(*i),
+                         di = conditional.getDim(i);
+        for (auto j = conditional.beginParents(); j != conditional.endParents();
+             ++j) {
+          const DenseIndex dj = conditional.getDim(j);
+          Sigma.block(oi, cov->offsets.at(*j), di, dj) = parent->covariance.block(
+              pi, parent->offsets.at(*j), di, dj);
+        }
+      }
+
+      // Sigma_FS = -R^-1 S Sigma_SS,  Sigma_FF = R^-1 R^-T - Sigma_FS S^T R^-T
+      const Matrix W = Rinv * S;
+      Sigma.topRightCorner(nF, nS).noalias() =
+          -W * Sigma.bottomRightCorner(nS, nS);
+      Sigma.bottomLeftCorner(nS, nF) = Sigma.topRightCorner(nF, nS).transpose();
+      Sigma.topLeftCorner(nF, nF).noalias() = Rinv * Rinv.transpose();
+      Sigma.topLeftCorner(nF, nF).noalias() -=
+          Sigma.topRightCorner(nF, nS) * W.transpose();
+    }
+
+    for (auto it = conditional.beginFrontals(); it != conditional.endFrontals();
+         ++it) {
+      const DenseIndex o = cov->offsets.at(*it), d = conditional.getDim(it);
+      const Matrix block = Sigma.block(o, o, d, d);
+      result.emplace(*it, 0.5 * (block + block.transpose()));
+    }
+
+    for (const auto& child : clique->children) stack.emplace_back(child, cov);
+  }
+
+  return result;
+}
+
 /* ************************************************************************* */
 JointMarginal Marginals::jointMarginalCovariance(const KeyVector& variables) const {
   JointMarginal info = jointMarginalInformation(variables);
@@ -113,6 +113,16 @@ public:
   /** Compute the marginal covariance of a single variable */
   Matrix marginalCovariance(Key variable) const;
 
+  /**
+   * Compute the marginal covariances of all variables in a single top-down
+   * pass over the Bayes tree. Each clique's covariance on its frontal and
+   * separator variables is obtained from its parent's with the recursive
+   * sparse-inverse (Takahashi) equations, so no marginal factor or joint graph
+   * is eliminated per variable. Prefer this over repeated calls to
+   * marginalCovariance when covariances of many variables are needed.
+   */
+  FastMap<Key, Matrix> marginalCovariances() const;
+
   /** Compute the joint marginal covariance of several variables */
   JointMarginal jointMarginalCovariance(const KeyVector& variables) const;
 
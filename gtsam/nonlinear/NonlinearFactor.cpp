@@ -147,38 +147,66 @@ double NoiseModelFactor::error(const Values& c) const {
 }
 
 /* ************************************************************************* */
-std::shared_ptr<GaussianFactor> NoiseModelFactor::linearize(
-    const Values& x) const {
-
-  // Only linearize if the factor is active
-  if (!active(x))
-    return std::shared_ptr<JacobianFactor>();
+namespace {
 
+// Linearize factor at x and whiten the system with noiseModel
+std::shared_ptr<JacobianFactor> linearizeWhitened(
+    const NoiseModelFactor& factor, const Values& x,
+    const SharedNoiseModel& noiseModel) {
   // Call evaluate error to get Jacobians and RHS vector b
-  std::vector<Matrix> A(size());
-  Vector b = -unwhitenedError(x, A);
-  check(noiseModel_, b.size());
+  std::vector<Matrix> A(factor.size());
+  Vector b = -factor.unwhitenedError(x, A);
+  check(factor.noiseModel(), b.size());
 
   // Whiten the corresponding system now
-  if (noiseModel_)
-    noiseModel_->WhitenSystem(A, b);
+  if (noiseModel)
+    noiseModel->WhitenSystem(A, b);
 
   // Fill in terms, needed to create JacobianFactor below
-  std::vector<std::pair<Key, Matrix> > terms(size());
-  for (size_t j = 0; j < size(); ++j) {
-    terms[j].first = keys()[j];
+  std::vector<std::pair<Key, Matrix> > terms(factor.size());
+  for (size_t j = 0; j < factor.size(); ++j) {
+    terms[j].first = factor.keys()[j];
     terms[j].second.swap(A[j]);
   }
 
   // TODO pass unwhitened + noise model to Gaussian factor
   using noiseModel::Constrained;
-  if (noiseModel_ && noiseModel_->isConstrained())
-    return GaussianFactor::shared_ptr(
-        new JacobianFactor(terms, b,
-            std::static_pointer_cast<Constrained>(noiseModel_)->unit()));
-  else {
-    return GaussianFactor::shared_ptr(new JacobianFactor(terms, b));
-  }
+  if (noiseModel && noiseModel->isConstrained())
+    return std::make_shared<JacobianFactor>(
+        terms, b, std::static_pointer_cast<Constrained>(noiseModel)->unit());
+  else
+    return std::make_shared<JacobianFactor>(terms, b);
+}
+
+}  // namespace
+
+/* ************************************************************************* */
+std::shared_ptr<GaussianFactor> NoiseModelFactor::linearize(
+    const Values& x) const {
+
+  // Only linearize if the factor is active
+  if (!active(x))
+    return std::shared_ptr<JacobianFactor>();
+
+  return linearizeWhitened(*this, x, noiseModel_);
+}
+
+/* ************************************************************************* */
+std::shared_ptr<JacobianFactor> NoiseModelFactor::linearizeUnweighted(
+    const Values& x) const {
+  if (!active(x))
+    return std::shared_ptr<JacobianFactor>();
+
+  const auto robust = std::dynamic_pointer_cast<noiseModel::Robust>(noiseModel_);
+  return linearizeWhitened(*this, x, robust ? robust->noise() : noiseModel_);
+}
+
+/* ************************************************************************* */
+const noiseModel::mEstimator::Base* NoiseModelFactor::noiseModelEstimator()
+    const {
+  const auto robust = dynamic_cast<const noiseModel::Robust*>(noiseModel_.get());
+  if (!robust || robust->noise()->isConstrained()) return nullptr;
+  return robust->robust().get();
 }
 
 /* ************************************************************************* */
@@ -295,12 +295,38 @@ public:
    */
   std::shared_ptr<GaussianFactor> linearize(const Values& x) const override;
 
+  /**
+   * The m-estimator that linearize() applies, for factors that can also be
+   * linearized without it by linearizeUnweighted(). NonlinearFactorGraph
+   * linearizes such factors unweighted and reweights all factors that share
+   * an m-estimator in one pass. The default, nullptr, means the factor is
+   * always linearized with linearize(). Subclasses opt in by returning
+   * noiseModelEstimator(), and have to override both methods if they
+   * override linearize().
+   */
+  virtual const noiseModel::mEstimator::Base* robustEstimator() const {
+    return nullptr;
+  }
+
+  /**
+   * Linearize like NoiseModelFactor::linearize, but if the noise model is
+   * noiseModel::Robust, only whiten with the noise model inside it and leave
+   * the reweighting by its m-estimator to the caller.
+   * Returns nullptr if the factor is not active.
+   */
+  virtual std::shared_ptr<JacobianFactor> linearizeUnweighted(
+      const Values& x) const;
+
   /**
    * Creates a shared_ptr clone of the
    * factor with a new noise model
    */
   shared_ptr cloneWithNewNoiseModel(const SharedNoiseModel newNoise) const;
 
+ protected:
+  /// The m-estimator of a robust noise model around a Gaussian one, or nullptr
+  const noiseModel::mEstimator::Base* noiseModelEstimator() const;
+
  private:
 #ifdef GTSAM_ENABLE_BOOST_SERIALIZATION
   /** Serialization function */
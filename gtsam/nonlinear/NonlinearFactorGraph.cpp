@@ -36,6 +36,7 @@
 #include <algorithm>
 #include <cmath>
 #include <fstream>
+#include <map>
 #include <set>
 
 using namespace std;
@@ -170,11 +171,28 @@ void NonlinearFactorGraph::saveGraph(const std::string& filename,
 double NonlinearFactorGraph::error(const Values& values) const {
   gttic(NonlinearFactorGraph_error);
   double total_error = 0.;
+#ifdef GTSAM_USE_TBB
+  // Evaluate sendable factors in parallel and the others serially, then sum in
+  // factor order, so the result is reproducible and identical to the serial one
+  std::vector<double> errors(size(), 0.0);
+  tbb::parallel_for(tbb::blocked_range<size_t>(0, size()),
+                    [&](const tbb::blocked_range<size_t>& range) {
+                      for (size_t i = range.begin(); i != range.end(); ++i)
+                        if (factors_[i] && factors_[i]->sendable())
+                          errors[i] = factors_[i]->error(values);
+                    });
+  for (size_t i = 0; i < size(); ++i) {
+    if (factors_[i] && !factors_[i]->sendable())
+      errors[i] = factors_[i]->error(values);
+  }
+  for (double error : errors) total_error += error;
+#else
   // iterate over all the factors_ to accumulate the log probabilities
   for(const sharedFactor& factor: factors_) {
     if(factor)
       total_error += factor->error(values);
   }
+#endif
   return total_error;
 }
 
@@ -210,22 +228,91 @@ SymbolicFactorGraph::shared_ptr NonlinearFactorGraph::symbolic() const
 /* ************************************************************************* */
 namespace {
 
+typedef noiseModel::mEstimator::Base MEstimator;
+
+// Linearize factor i of graph into result[i]. For factors that report their
+// NoiseModelFactor::robustEstimator, the m-estimator is not applied but stored
+// in estimators[i], for reweighting all factors together afterwards.
+void linearizeFactor(const NonlinearFactorGraph& graph, size_t i,
+                     const Values& linearizationPoint,
+                     GaussianFactorGraph& result,
+                     std::vector<const MEstimator*>& estimators) {
+  const auto factor = dynamic_cast<const NoiseModelFactor*>(graph[i].get());
+  const MEstimator* estimator = factor ? factor->robustEstimator() : nullptr;
+  if (estimator) {
+    result[i] = factor->linearizeUnweighted(linearizationPoint);
+    if (result[i]) estimators[i] = estimator;
+  } else {
+    result[i] = graph[i]->linearize(linearizationPoint);
+  }
+}
+
+// Apply the m-estimators to the robust factors left unweighted by
+// linearizeFactor. All factors that share an m-estimator are reweighted with a
+// single call to MEstimator::weights, with the same result as
+// noiseModel::Robust::WhitenSystem on each factor.
+void reweightRobustFactors(const std::vector<const MEstimator*>& estimators,
+                           GaussianFactorGraph& result) {
+  std::map<const MEstimator*, std::vector<JacobianFactor*>> groups;
+  for (size_t i = 0; i < estimators.size(); ++i) {
+    if (estimators[i])
+      groups[estimators[i]].push_back(
+          static_cast<JacobianFactor*>(result[i].get()));
+  }
+
+  for (const auto& [estimator, factors] : groups) {
+    // Distances are whitened residual norms for block reweighting, and the
+    // whitened residual entries for scalar reweighting
+    const bool block = estimator->reweightScheme() == MEstimator::Block;
+    size_t n = 0;
+    for (const JacobianFactor* factor : factors)
+      n += block ? 1 : factor->rows();
+    Vector distances(n);
+    n = 0;
+    for (const JacobianFactor* factor : factors) {
+      if (block) {
+        distances(n++) = factor->getb().norm();
+      } else {
+        distances.segment(n, factor->rows()) = factor->getb();
+        n += factor->rows();
+      }
+    }
+
+    const Vector sqrtWeights = estimator->weights(distances).cwiseSqrt();
+    n = 0;
+    for (JacobianFactor* factor : factors) {
+      auto Ab = factor->matrixObject().full();
+      if (block) {
+        Ab *= sqrtWeights(n++);
+      } else {
+        Ab.array().colwise() *=
+            sqrtWeights.segment(n, factor->rows()).array();
+        n += factor->rows();
+      }
+    }
+  }
+}
+
 #ifdef GTSAM_USE_TBB
 class _LinearizeOneFactor {
   const NonlinearFactorGraph& nonlinearGraph_;
   const Values& linearizationPoint_;
   GaussianFactorGraph& result_;
+  std::vector<const MEstimator*>& estimators_;
 public:
   // Create functor with constant parameters
   _LinearizeOneFactor(const NonlinearFactorGraph& graph,
-      const Values& linearizationPoint, GaussianFactorGraph& result) :
-      nonlinearGraph_(graph), linearizationPoint_(linearizationPoint), result_(result) {
+      const Values& linearizationPoint, GaussianFactorGraph& result,
+      std::vector<const MEstimator*>& estimators) :
+      nonlinearGraph_(graph), linearizationPoint_(linearizationPoint),
+      result_(result), estimators_(estimators) {
   }
   // Operator that linearizes a given range of the factors
   void operator()(const tbb::blocked_range<size_t>& blocked_range) const {
     for (size_t i = blocked_range.begin(); i != blocked_range.end(); ++i) {
       if (nonlinearGraph_[i] && nonlinearGraph_[i]->sendable())
-        result_[i] = nonlinearGraph_[i]->linearize(linearizationPoint_);
+        linearizeFactor(nonlinearGraph_, i, linearizationPoint_, result_,
+                        estimators_);
       else
         result_[i] = GaussianFactor::shared_ptr();
     }
@@ -242,38 +329,39 @@ GaussianFactorGraph::shared_ptr NonlinearFactorGraph::linearize(const Values& li
 
   // create an empty linear FG
   GaussianFactorGraph::shared_ptr linearFG = std::make_shared<GaussianFactorGraph>();
+  linearFG->resize(size());
+
+  // m-estimators of the robust factors, applied after linearization
+  std::vector<const MEstimator*> estimators(size(), nullptr);
 
 #ifdef GTSAM_USE_TBB
 
-  linearFG->resize(size());
   TbbOpenMPMixedScope threadLimiter; // Limits OpenMP threads since we're mixing TBB and OpenMP
 
   // First linearize all sendable factors
   tbb::parallel_for(tbb::blocked_range<size_t>(0, size()),
-    _LinearizeOneFactor(*this, linearizationPoint, *linearFG));
+    _LinearizeOneFactor(*this, linearizationPoint, *linearFG, estimators));
 
   // Linearize all non-sendable factors
   for(size_t i = 0; i < size(); i++) {
     auto& factor = (*this)[i];
     if(factor && !(factor->sendable())) {
-      (*linearFG)[i] = factor->linearize(linearizationPoint);
+      linearizeFactor(*this, i, linearizationPoint, *linearFG, estimators);
     }
   }
 
 #else
 
-  linearFG->reserve(size());
-
   // linearize all factors
-  for (const sharedFactor& factor : factors_) {
-    if (factor) {
-      linearFG->push_back(factor->linearize(linearizationPoint));
-    } else
-      linearFG->push_back(GaussianFactor::shared_ptr());
+  for (size_t i = 0; i < size(); i++) {
+    if (factors_[i])
+      linearizeFactor(*this, i, linearizationPoint, *linearFG, estimators);
   }
 
 #endif
 
+  reweightRobustFactors(estimators, *linearFG);
+
   return linearFG;
 }
 
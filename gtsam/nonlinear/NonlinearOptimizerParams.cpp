@@ -115,6 +115,9 @@ void NonlinearOptimizerParams::print(const std::string& str) const {
   case Ordering::METIS:
     std::cout << "                   ordering: METIS\n";
     break;
+  case Ordering::AUTO:
+    std::cout << "                   ordering: AUTO\n";
+    break;
   default:
     std::cout << "                   ordering: custom\n";
     break;
@@ -172,6 +175,8 @@ std::string NonlinearOptimizerParams::orderingTypeTranslator(
     return "METIS";
   case Ordering::COLAMD:
     return "COLAMD";
+  case Ordering::AUTO:
+    return "AUTO";
   default:
     if (ordering)
       return "CUSTOM";
@@ -188,6 +193,8 @@ Ordering::OrderingType NonlinearOptimizerParams::orderingTypeTranslator(
     return Ordering::METIS;
   if (type == "COLAMD")
     return Ordering::COLAMD;
+  if (type == "AUTO")
+    return Ordering::AUTO;
   throw std::invalid_argument(
       "Invalid ordering type: You must provide an ordering for a custom ordering type. See setOrdering");
 }
@@ -101,6 +101,11 @@ namespace gtsam {
       return -traits<T>::Local(x, prior_);
     }
 
+    /// Robust priors are reweighted together by NonlinearFactorGraph
+    const noiseModel::mEstimator::Base* robustEstimator() const override {
+      return this->noiseModelEstimator();
+    }
+
     const VALUE & prior() const { return prior_; }
 
   private:
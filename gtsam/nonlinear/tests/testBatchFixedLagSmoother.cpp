@@ -22,12 +22,17 @@
 #include <gtsam/inference/Key.h>
 #include <gtsam/inference/Ordering.h>
 #include <gtsam/geometry/Point2.h>
+#include <gtsam/geometry/Pose2.h>
 #include <gtsam/linear/GaussianBayesNet.h>
 #include <gtsam/linear/GaussianFactorGraph.h>
+#include <gtsam/nonlinear/LevenbergMarquardtOptimizer.h>
 #include <gtsam/nonlinear/NonlinearFactorGraph.h>
 #include <gtsam/nonlinear/Values.h>
 #include <gtsam/slam/BetweenFactor.h>
 
+#include <iostream>
+#include <sstream>
+
 using namespace std;
 using namespace gtsam;
 
@@ -237,6 +242,158 @@ TEST( BatchFixedLagSmoother, Example )
   }
 }
 
+/* ************************************************************************* */
+TEST( BatchFixedLagSmoother, RemoveThenMarginalize )
+{
+  // Factors removed explicitly must not be touched again when their keys are
+  // marginalized later on
+  SharedDiagonal odometerNoise = noiseModel::Diagonal::Sigmas(Vector2(0.1, 0.1));
+  typedef BatchFixedLagSmoother::KeyTimestampMap Timestamps;
+  BatchFixedLagSmoother smoother(3.0, LevenbergMarquardtParams());
+
+  Values fullinit;
+  NonlinearFactorGraph fullgraph;
+
+  // A chain with two odometry factors between each pair of poses
+  for (size_t i = 0; i <= 3; ++i) {
+    NonlinearFactorGraph newFactors;
+    Values newValues;
+    Timestamps newTimestamps;
+    if (i == 0) {
+      newFactors.addPrior(Key(0), Point2(0.0, 0.0), odometerNoise);
+    } else {
+      newFactors.push_back(BetweenFactor<Point2>(Key(i - 1), Key(i), Point2(1.0, 0.0), odometerNoise));
+      newFactors.push_back(BetweenFactor<Point2>(Key(i - 1), Key(i), Point2(1.2, 0.1), odometerNoise));
+    }
+    newValues.insert(Key(i), Point2(double(i) + 0.1, -0.1));
+    newTimestamps[Key(i)] = double(i);
+    fullinit.insert(newValues);
+    smoother.update(newFactors, newValues, newTimestamps);
+  }
+
+  // Remove the second factor between 0 and 1, and one between 2 and 3
+  const FactorIndices factorsToRemove{2, 6};
+  smoother.update(NonlinearFactorGraph(), Values(), Timestamps(), factorsToRemove);
+  const NonlinearFactorGraph factors = smoother.getFactors();
+  for (size_t i = 0; i < factors.size(); ++i) {
+    if (i == 2 || i == 6) {
+      EXPECT(!factors[i]);
+    } else if (factors[i]) {
+      fullgraph.push_back(factors[i]);
+    }
+  }
+
+  // Add poses until 0, 1 and 2 are marginalized, the removed factors involve
+  // all of them
+  for (size_t i = 4; i <= 6; ++i) {
+    NonlinearFactorGraph newFactors;
+    Values newValues;
+    Timestamps newTimestamps;
+    newFactors.push_back(BetweenFactor<Point2>(Key(i - 1), Key(i), Point2(1.0, 0.0), odometerNoise));
+    newValues.insert(Key(i), Point2(double(i) + 0.1, -0.1));
+    newTimestamps[Key(i)] = double(i);
+    fullgraph.push_back(newFactors);
+    fullinit.insert(newValues);
+
+    // Marginalization only visits live factors, and does not report
+    // attempts to remove empty slots
+    std::stringstream output;
+    std::streambuf* coutBuffer = std::cout.rdbuf(output.rdbuf());
+    smoother.update(newFactors, newValues, newTimestamps);
+    std::cout.rdbuf(coutBuffer);
+    EXPECT(output.str().empty());
+
+    // In this linear problem marginalization is exact
+    CHECK(check_smoother(fullgraph, fullinit, smoother, Key(i)));
+    CHECK(check_smoother(fullgraph, fullinit, smoother, Key(i - 1)));
+  }
+
+  // The marginalized keys are gone from all factors, and the explicitly
+  // removed slots were not recycled
+  EXPECT(!smoother.getLinearizationPoint().exists(Key(0)));
+  EXPECT(!smoother.getLinearizationPoint().exists(Key(2)));
+  EXPECT(!smoother.getFactors()[2]);
+  EXPECT(!smoother.getFactors()[6]);
+  for (const auto& factor : smoother.getFactors()) {
+    if (!factor) continue;
+    for (Key key : *factor) EXPECT(key >= Key(3));
+  }
+}
+
+/* ************************************************************************* */
+TEST( BatchFixedLagSmoother, EmptyUpdate )
+{
+  // An update without new factors, values or removals leaves the estimate
+  // unchanged, and later updates still see a consistent ordering
+  SharedDiagonal odometerNoise = noiseModel::Diagonal::Sigmas(Vector2(0.1, 0.1));
+  typedef BatchFixedLagSmoother::KeyTimestampMap Timestamps;
+  BatchFixedLagSmoother smoother(10.0, LevenbergMarquardtParams());
+
+  Values fullinit;
+  NonlinearFactorGraph fullgraph;
+  for (size_t i = 0; i <= 4; ++i) {
+    NonlinearFactorGraph newFactors;
+    Values newValues;
+    Timestamps newTimestamps;
+    if (i == 0)
+      newFactors.addPrior(Key(0), Point2(0.0, 0.0), odometerNoise);
+    else
+      newFactors.push_back(BetweenFactor<Point2>(Key(i - 1), Key(i), Point2(1.0, 0.0), odometerNoise));
+    newValues.insert(Key(i), Point2(double(i) + 0.1, -0.1));
+    newTimestamps[Key(i)] = double(i);
+    fullgraph.push_back(newFactors);
+    fullinit.insert(newValues);
+    smoother.update(newFactors, newValues, newTimestamps);
+
+    if (i == 2) {
+      const Values before = smoother.calculateEstimate();
+      smoother.update();
+      EXPECT(assert_equal(before, smoother.calculateEstimate()));
+      smoother.update(NonlinearFactorGraph(), Values(), Timestamps());
+      EXPECT(assert_equal(before, smoother.calculateEstimate()));
+    }
+    CHECK(check_smoother(fullgraph, fullinit, smoother, Key(i)));
+  }
+}
+
+/* ************************************************************************* */
+TEST( BatchFixedLagSmoother, RejectedLambda )
+{
+  // A Gauss-Newton sized first step from a poor initial estimate increases
+  // the error, so at least one lambda is rejected before the step is accepted.
+  // The damping factors are reused for every lambda tried, check the result
+  // against the Levenberg-Marquardt optimizer.
+  const auto noise = noiseModel::Diagonal::Sigmas(Vector3(0.1, 0.1, 0.05));
+  typedef BatchFixedLagSmoother::KeyTimestampMap Timestamps;
+  LevenbergMarquardtParams params;
+  params.lambdaInitial = 1e-10;
+  params.relativeErrorTol = 1e-12;
+  params.absoluteErrorTol = 1e-12;
+  params.maxIterations = 100;
+  BatchFixedLagSmoother smoother(100.0, params);
+
+  NonlinearFactorGraph newFactors;
+  Values newValues;
+  Timestamps newTimestamps;
+  newFactors.addPrior(Key(0), Pose2(), noise);
+  for (size_t i = 0; i < 8; ++i) {
+    const Key key1(i), key2(i + 1);
+    newFactors.push_back(BetweenFactor<Pose2>(key1, key2, Pose2(1.0, 0.0, M_PI_2), noise));
+    newTimestamps[key1] = double(i);
+  }
+  newTimestamps[Key(8)] = 8.0;
+  for (size_t i = 0; i <= 8; ++i)
+    newValues.insert(Key(i), Pose2(0.5 * i, -0.3 * i, -1.2 * i));
+
+  const FixedLagSmoother::Result result =
+      smoother.update(newFactors, newValues, newTimestamps);
+  EXPECT(result.intermediateSteps > result.iterations);
+
+  const Values expected =
+      LevenbergMarquardtOptimizer(newFactors, newValues, params).optimize();
+  EXPECT(assert_equal(expected, smoother.calculateEstimate(), 1e-6));
+}
+
 /* ************************************************************************* */
 int main() { TestResult tr; return TestRegistry::runAllTests(tr);}
 /* ************************************************************************* */
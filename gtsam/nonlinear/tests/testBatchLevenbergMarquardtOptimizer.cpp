@@ -0,0 +1,150 @@
+/* ----------------------------------------------------------------------------
+
+ * GTSAM Copyright 2010, Georgia Tech Research Corporation,
+ * Atlanta, Georgia 30332-0415
+ * All Rights Reserved
+ * Authors: Frank Dellaert, et al. (see THANKS for the full author list)
+
+ * See LICENSE for the license information
+
+ * -------------------------------------------------------------------------- */
+
+/**
+ * @file    testBatchLevenbergMarquardtOptimizer.cpp
+ * @brief   Unit tests for BatchLevenbergMarquardtOptimizer
+ */
+
+#include <gtsam/nonlinear/BatchLevenbergMarquardtOptimizer.h>
+#include <gtsam/nonlinear/LevenbergMarquardtOptimizer.h>
+#include <gtsam/geometry/Pose2.h>
+#include <gtsam/geometry/Pose3.h>
+#include <gtsam/inference/Symbol.h>
+#include <gtsam/slam/BetweenFactor.h>
+#include <gtsam/base/TestableAssertions.h>
+
+#include <CppUnitLite/TestHarness.h>
+
+using namespace std;
+using namespace gtsam;
+using symbol_shorthand::X;
+
+/* ************************************************************************* */
+// A small pose graph with a loop closure, perturbed by the problem index
+static void createProblem(size_t index, NonlinearFactorGraph* graph,
+                          Values* initial) {
+  auto noise = noiseModel::Diagonal::Sigmas(Vector3(0.1, 0.1, 0.05));
+  const double s = 0.01 * index;
+  graph->addPrior(X(0), Pose2(s, 0, 0), noise);
+  graph->emplace_shared<BetweenFactor<Pose2>>(X(0), X(1),
+                                              Pose2(1 + s, 0, 0.1), noise);
+  graph->emplace_shared<BetweenFactor<Pose2>>(X(1), X(2),
+                                              Pose2(1, s, 0.2), noise);
+  graph->emplace_shared<BetweenFactor<Pose2>>(X(0), X(2),
+                                              Pose2(2, 0.3, 0.3 - s), noise);
+  initial->insert(X(0), Pose2(0.1, -0.1, 0.05));
+  initial->insert(X(1), Pose2(1.2, 0.1, 0.0));
+  initial->insert(X(2), Pose2(1.9, 0.5, 0.4));
+}
+
+/* ************************************************************************* */
+TEST(BatchLevenbergMarquardtOptimizer, MatchesIndividualSolves) {
+  std::vector<NonlinearFactorGraph> graphs(40);
+  std::vector<Values> initials(40);
+  for (size_t i = 0; i < graphs.size(); ++i)
+    createProblem(i, &graphs[i], &initials[i]);
+
+  LevenbergMarquardtParams params;
+  const std::vector<Values> actual =
+      BatchLevenbergMarquardtOptimizer(params).optimize(graphs, initials);
+
+  LONGS_EQUAL(graphs.size(), actual.size());
+  for (size_t i = 0; i < graphs.size(); ++i) {
+    const Values expected =
+        LevenbergMarquardtOptimizer(graphs[i], initials[i], params).optimize();
+    EXPECT(assert_equal(expected, actual[i], 1e-9));
+  }
+}
+
+/* ************************************************************************* */
+// Pose3 chains have 18 variables, more than the fixed-size Cholesky handles,
+// and use robust noise models and diagonal damping.
+TEST(BatchLevenbergMarquardtOptimizer, DynamicSizeDiagonalDamping) {
+  auto noise = noiseModel::Robust::Create(
+      noiseModel::mEstimator::Huber::Create(1.0),
+      noiseModel::Isotropic::Sigma(6, 0.1));
+  std::vector<NonlinearFactorGraph> graphs(10);
+  std::vector<Values> initials(10);
+  for (size_t i = 0; i < graphs.size(); ++i) {
+    const double s = 0.02 * i;
+    const Pose3 odometry = Pose3::Expmap(
+        (Vector6() << 0.1, s, -0.1, 1.0, 0.2 * s, 0.1).finished());
+    graphs[i].addPrior(X(0), Pose3(), noise);
+    graphs[i].emplace_shared<BetweenFactor<Pose3>>(X(0), X(1), odometry,
+                                                   noise);
+    graphs[i].emplace_shared<BetweenFactor<Pose3>>(X(1), X(2), odometry,
+                                                   noise);
+    graphs[i].emplace_shared<BetweenFactor<Pose3>>(
+        X(0), X(2), odometry * odometry * Pose3::Expmap(Vector6::Constant(s)),
+        noise);
+    initials[i].insert(X(0), Pose3::Expmap(Vector6::Constant(0.05)));
+    initials[i].insert(X(1), odometry.retract(Vector6::Constant(-0.1)));
+    initials[i].insert(X(2), (odometry * odometry).retract(Vector6::Ones()));
+  }
+
+  LevenbergMarquardtParams params;
+  params.diagonalDamping = true;
+  const std::vector<Values> actual =
+      BatchLevenbergMarquardtOptimizer(params).optimize(graphs, initials);
+
+  for (size_t i = 0; i < graphs.size(); ++i) {
+    const Values expected =
+        LevenbergMarquardtOptimizer(graphs[i], initials[i], params).optimize();
+    EXPECT(assert_equal(expected, actual[i], 1e-6));
+  }
+}
+
+/* ************************************************************************* */
+TEST(BatchLevenbergMarquardtOptimizer, InvalidArguments) {
+  const BatchLevenbergMarquardtOptimizer optimizer;
+  std::vector<NonlinearFactorGraph> graphs(2);
+  std::vector<Values> initials(1);
+  CHECK_EXCEPTION(optimizer.optimize(graphs, initials), std::invalid_argument);
+  LONGS_EQUAL(0, optimizer.optimize({}, {}).size());
+
+  // All problems need the same factors on the same keys, and the same values
+  initials.resize(2);
+  createProblem(0, &graphs[0], &initials[0]);
+  createProblem(1, &graphs[1], &initials[1]);
+  LONGS_EQUAL(2, optimizer.optimize(graphs, initials).size());
+
+  std::vector<NonlinearFactorGraph> moreFactors = graphs;
+  moreFactors[1].addPrior(X(1), Pose2(), noiseModel::Unit::Create(3));
+  CHECK_EXCEPTION(optimizer.optimize(moreFactors, initials),
+                  std::invalid_argument);
+
+  std::vector<NonlinearFactorGraph> otherKeys = graphs;
+  otherKeys[1].erase(otherKeys[1].begin());
+  otherKeys[1].addPrior(X(1), Pose2(), noiseModel::Unit::Create(3));
+  CHECK_EXCEPTION(optimizer.optimize(otherKeys, initials),
+                  std::invalid_argument);
+
+  std::vector<Values> otherValues = initials;
+  otherValues[1].erase(X(2));
+  otherValues[1].insert(X(2), Point2(0, 0));
+  CHECK_EXCEPTION(optimizer.optimize(graphs, otherValues),
+                  std::invalid_argument);
+
+  // Hard constraints are not supported
+  std::vector<NonlinearFactorGraph> constrained = graphs;
+  for (auto& graph : constrained)
+    graph.addPrior(X(1), Pose2(), noiseModel::Constrained::All(3));
+  CHECK_EXCEPTION(optimizer.optimize(constrained, initials),
+                  std::invalid_argument);
+}
+
+/* ************************************************************************* */
+int main() {
+  TestResult tr;
+  return TestRegistry::runAllTests(tr);
+}
+/* ************************************************************************* */
@@ -17,74 +17,172 @@
  */
 
 #include <gtsam/sfm/DsfTrackGenerator.h>
+#include <gtsam/base/ConcurrentDSF.h>
+#include <gtsam/config.h> // for GTSAM_USE_TBB
+
+#ifdef GTSAM_USE_TBB
+#include <tbb/parallel_for.h>
+#endif
 
 #include <algorithm>
+#include <atomic>
 #include <iostream>
 #include <iomanip>
+#include <stdexcept>
+#include <string>
 
 namespace gtsam {
 
 namespace gtsfm {
 
-typedef DSFMap<IndexPair> DSFMapIndexPair;
-
-/// Generate the DSF to form tracks.
-static DSFMapIndexPair generateDSF(const MatchIndicesMap& matches) {
-  DSFMapIndexPair dsf;
-
-  for (const auto& kv : matches) {
-    const auto pair_indices = kv.first;
-    const auto corr_indices = kv.second;
-
-    // Image pair is (i1,i2).
-    size_t i1 = pair_indices.first;
-    size_t i2 = pair_indices.second;
-    size_t m = static_cast<size_t>(corr_indices.rows());
-    for (size_t k = 0; k < m; k++) {
-      // Measurement indices are found in a single matrix row, as (k1,k2).
-      size_t k1 = corr_indices(k, 0), k2 = corr_indices(k, 1);
-      // Unique key for DSF is (i,k), representing keypoint index in an image.
-      dsf.merge({i1, k1}, {i2, k2});
-    }
+/**
+ * Dense indexing of all detections: detection (i,k) maps to offsets[i] + k,
+ * so that the union-find can use a flat vector instead of a map.
+ */
+class DetectionIndex {
+  std::vector<size_t> offsets_;  // N+1 offsets, last one is the total.
+  std::vector<size_t> images_;   // Image index of each dense index.
+
+ public:
+  explicit DetectionIndex(const KeypointsVector& keypoints) {
+    offsets_.reserve(keypoints.size() + 1);
+    offsets_.push_back(0);
+    for (const Keypoints& kps : keypoints)
+      offsets_.push_back(offsets_.back() + kps.coordinates.rows());
+    images_.resize(offsets_.back());
+    for (size_t i = 0; i < keypoints.size(); i++)
+      std::fill(images_.begin() + offsets_[i], images_.begin() + offsets_[i + 1],
+                i);
   }
 
-  return dsf;
-}
-
-/// Generate a single track from a set of index pairs
-static SfmTrack2d trackFromIndexPairs(const std::set<IndexPair>& index_pair_set,
-                                      const KeypointsVector& keypoints) {
-  // Initialize track from measurements.
-  SfmTrack2d track2d;
-
-  for (const auto& index_pair : index_pair_set) {
-    // Camera index is represented by i, and measurement index is
-    // represented by k.
-    size_t i = index_pair.i();
-    size_t k = index_pair.j();
-    // Add measurement to this track.
-    track2d.addMeasurement(i, keypoints[i].coordinates.row(k));
+  size_t size() const { return offsets_.back(); }
+  /// Dense index of detection (i,k), throws if image i has no keypoint k.
+  size_t index(size_t i, size_t k) const {
+    if (i + 1 >= offsets_.size() || k >= offsets_[i + 1] - offsets_[i])
+      throw std::out_of_range(
+          "tracksFromPairwiseMatches: no keypoint " + std::to_string(k) +
+          " in image " + std::to_string(i));
+    return offsets_[i] + k;
   }
+  size_t image(size_t index) const { return images_[index]; }
+  size_t keypoint(size_t index) const { return index - offsets_[images_[index]]; }
+};
+
+/// Flags detections that appear in at least one correspondence.
+typedef std::vector<std::atomic<bool>> MatchedFlags;
+
+/// Merge all correspondences of one image pair into the DSF.
+static void mergeMatches(const IndexPair& pair_indices,
+                         const CorrespondenceIndices& corr_indices,
+                         const DetectionIndex& index, ConcurrentDSF* dsf,
+                         MatchedFlags* matched) {
+  // Image pair is (i1,i2).
+  size_t i1 = pair_indices.first;
+  size_t i2 = pair_indices.second;
+  size_t m = static_cast<size_t>(corr_indices.rows());
+  for (size_t k = 0; k < m; k++) {
+    // Measurement indices are found in a single matrix row, as (k1,k2).
+    size_t k1 = corr_indices(k, 0), k2 = corr_indices(k, 1);
+    // Unique key for DSF is (i,k), representing keypoint index in an image.
+    const size_t j1 = index.index(i1, k1), j2 = index.index(i2, k2);
+    (*matched)[j1].store(true, std::memory_order_relaxed);
+    (*matched)[j2].store(true, std::memory_order_relaxed);
+    dsf->merge(j1, j2);
+  }
+}
 
-  return track2d;
+/// Generate the DSF to form tracks, one image pair per task.
+static void generateDSF(const MatchIndicesMap& matches,
+                        const DetectionIndex& index, ConcurrentDSF* dsf,
+                        MatchedFlags* matched) {
+  std::vector<MatchIndicesMap::const_iterator> pairs;
+  pairs.reserve(matches.size());
+  for (auto it = matches.begin(); it != matches.end(); ++it) pairs.push_back(it);
+
+#ifdef GTSAM_USE_TBB
+  tbb::parallel_for(tbb::blocked_range<size_t>(0, pairs.size()),
+                    [&](const tbb::blocked_range<size_t>& range) {
+                      for (size_t p = range.begin(); p != range.end(); ++p)
+                        mergeMatches(pairs[p]->first, pairs[p]->second, index,
+                                     dsf, matched);
+                    });
+#else
+  for (const auto& it : pairs)
+    mergeMatches(it->first, it->second, index, dsf, matched);
+#endif
 }
 
-/// Generate tracks from the DSF.
-static std::vector<SfmTrack2d> tracksFromDSF(const DSFMapIndexPair& dsf,
+/**
+ * Generate tracks from the DSF. Since ConcurrentDSF labels every set with its
+ * smallest member, tracks come out ordered by their smallest (i,k) and
+ * measurements within a track ordered by (i,k), regardless of thread count.
+ */
+static std::vector<SfmTrack2d> tracksFromDSF(const ConcurrentDSF& dsf,
+                                             const MatchedFlags& matched,
+                                             const DetectionIndex& index,
                                              const KeypointsVector& keypoints) {
-  const std::map<IndexPair, std::set<IndexPair> > key_sets = dsf.sets();
-
+  const size_t n = index.size();
+
+  // Label of every matched detection, root labels get a track index.
+  std::vector<size_t> labels(n);
+  auto findLabels = [&](size_t begin, size_t end) {
+    for (size_t j = begin; j < end; j++)
+      if (matched[j]) labels[j] = dsf.find(j);
+  };
+#ifdef GTSAM_USE_TBB
+  tbb::parallel_for(tbb::blocked_range<size_t>(0, n),
+                    [&](const tbb::blocked_range<size_t>& range) {
+                      findLabels(range.begin(), range.end());
+                    });
+#else
+  findLabels(0, n);
+#endif
+
+  // Count the track sizes (counting sort on the label), in label order.
+  std::vector<size_t> trackOfRoot(n), starts(1, 0);
+  for (size_t j = 0; j < n; j++) {
+    if (!matched[j]) continue;
+    if (labels[j] == j) {
+      trackOfRoot[j] = starts.size() - 1;
+      starts.push_back(0);
+    }
+    starts[trackOfRoot[labels[j]] + 1]++;
+  }
+  const size_t numTracks = starts.size() - 1;
   // Return immediately if no sets were found.
-  if (key_sets.empty()) return {};
+  if (numTracks == 0) return {};
+  for (size_t t = 0; t < numTracks; t++) starts[t + 1] += starts[t];
+
+  std::vector<size_t> members(starts.back());
+  std::vector<size_t> fill(starts.begin(), starts.end() - 1);
+  for (size_t j = 0; j < n; j++)
+    if (matched[j]) members[fill[trackOfRoot[labels[j]]]++] = j;
 
-  // Create a list of tracks.
+  // Create the tracks.
   // Each track will be represented as a list of (camera_idx, measurements).
-  std::vector<SfmTrack2d> tracks2d;
-  for (const auto& kv : key_sets) {
-    // Initialize track from measurements.
-    SfmTrack2d track2d = trackFromIndexPairs(kv.second, keypoints);
-    tracks2d.emplace_back(track2d);
-  }
+  std::vector<SfmTrack2d> tracks2d(numTracks);
+  auto makeTracks = [&](size_t begin, size_t end) {
+    for (size_t t = begin; t < end; t++) {
+      SfmTrack2d& track2d = tracks2d[t];
+      track2d.measurements.reserve(starts[t + 1] - starts[t]);
+      for (size_t m = starts[t]; m < starts[t + 1]; m++) {
+        // Camera index is represented by i, and measurement index is
+        // represented by k.
+        const size_t i = index.image(members[m]);
+        const size_t k = index.keypoint(members[m]);
+        // Add measurement to this track.
+        track2d.addMeasurement(i, keypoints[i].coordinates.row(k));
+      }
+    }
+  };
+#ifdef GTSAM_USE_TBB
+  tbb::parallel_for(tbb::blocked_range<size_t>(0, numTracks),
+                    [&](const tbb::blocked_range<size_t>& range) {
+                      makeTracks(range.begin(), range.end());
+                    });
+#else
+  makeTracks(0, numTracks);
+#endif
   return tracks2d;
 }
 
@@ -105,10 +203,14 @@ std::vector<SfmTrack2d> tracksFromPairwiseMatches(
     bool verbose) {
   // Generate the DSF to form tracks.
   if (verbose) std::cout << "[SfmTrack2d] Starting Union-Find..." << std::endl;
-  DSFMapIndexPair dsf = generateDSF(matches);
+  const DetectionIndex index(keypoints);
+  ConcurrentDSF dsf(index.size());
+  MatchedFlags matched(index.size());
+  generateDSF(matches, index, &dsf, &matched);
   if (verbose) std::cout << "[SfmTrack2d] Union-Find Complete" << std::endl;
 
-  std::vector<SfmTrack2d> tracks2d = tracksFromDSF(dsf, keypoints);
+  std::vector<SfmTrack2d> tracks2d =
+      tracksFromDSF(dsf, matched, index, keypoints);
 
   // Filter out erroneous tracks that had repeated measurements within the
   // same image. This is an expected result from an incorrect correspondence
@@ -65,6 +65,11 @@ using MatchIndicesMap = std::map<IndexPair, CorrespondenceIndices>;
  * detection and the index of that detection in that camera's keypoint list,
  * i.e. (i,k).
  *
+ * Detections are indexed densely and merged with a lock-free union-find, so
+ * image pairs are ingested and tracks extracted in parallel when GTSAM is
+ * built with TBB. Tracks are ordered by their smallest (i,k), and measurements
+ * within a track by (i,k), independent of the number of threads.
+ *
  * @param Map from (i1,i2) image pair indices to (K,2) matrix, for K
  *        correspondence indices, from each image.
  * @param Length-N list of keypoints, for N images/cameras.
@@ -6,166 +6,282 @@
  */
 
 #include <gtsam/sfm/MFAS.h>
+#include <gtsam/config.h> // for GTSAM_USE_TBB
+
+#ifdef GTSAM_USE_TBB
+#include <tbb/parallel_for.h>
+#endif
 
 #include <algorithm>
+#include <cmath>
+#include <functional>
 #include <map>
-#include <unordered_map>
+#include <numeric>
+#include <queue>
 #include <vector>
-#include <unordered_set>
 
 using namespace gtsam;
 using std::map;
 using std::pair;
-using std::unordered_map;
 using std::vector;
-using std::unordered_set;
 
-// A node in the graph.
-struct GraphNode {
-  double inWeightSum;               // Sum of absolute weights of incoming edges
-  double outWeightSum;              // Sum of absolute weights of outgoing edges
-  unordered_set<Key> inNeighbors;   // Nodes from which there is an incoming edge
-  unordered_set<Key> outNeighbors;  // Nodes to which there is an outgoing edge
+namespace {
 
-  // Heuristic for the node that is to select nodes in MFAS.
-  double heuristic() const { return (outWeightSum + 1) / (inWeightSum + 1); }
+// Indices into a vector of edges that keep one edge per KeyPair, the last one
+// given, sorted by KeyPair. This mimics inserting all edges into a std::map.
+vector<size_t> uniqueSortedEdges(const vector<MFAS::KeyPair>& edges) {
+  vector<size_t> order(edges.size());
+  std::iota(order.begin(), order.end(), 0);
+  std::stable_sort(order.begin(), order.end(), [&](size_t a, size_t b) {
+    return edges[a] < edges[b];
+  });
+  vector<size_t> unique;
+  unique.reserve(order.size());
+  for (size_t k = 0; k < order.size(); k++) {
+    if (k + 1 < order.size() && edges[order[k + 1]] == edges[order[k]])
+      continue;
+    unique.push_back(order[k]);
+  }
+  return unique;
+}
+
+// The graph structure shared by all projection directions: nodes are dense
+// indices into a sorted vector of keys, and every node has a list of incident
+// edges in compressed (CSR) form.
+struct EdgeGraph {
+  KeyVector keys;                 // Key of each node.
+  vector<size_t> first, second;   // Node indices of each edge.
+  vector<size_t> incidenceStart;  // Incident edges of node n are
+  vector<size_t> incidentEdges;   // incidentEdges[incidenceStart[n]...]
+
+  explicit EdgeGraph(const vector<MFAS::KeyPair>& edges) {
+    for (const auto& edge : edges) {
+      keys.push_back(edge.first);
+      keys.push_back(edge.second);
+    }
+    std::sort(keys.begin(), keys.end());
+    keys.erase(std::unique(keys.begin(), keys.end()), keys.end());
+
+    auto index = [this](Key key) {
+      return std::lower_bound(keys.begin(), keys.end(), key) - keys.begin();
+    };
+    first.reserve(edges.size());
+    second.reserve(edges.size());
+    incidenceStart.assign(keys.size() + 1, 0);
+    for (const auto& edge : edges) {
+      first.push_back(index(edge.first));
+      second.push_back(index(edge.second));
+      incidenceStart[first.back() + 1]++;
+      incidenceStart[second.back() + 1]++;
+    }
+    std::partial_sum(incidenceStart.begin(), incidenceStart.end(),
+                     incidenceStart.begin());
+    incidentEdges.resize(incidenceStart.back());
+    vector<size_t> fill(incidenceStart.begin(), incidenceStart.end() - 1);
+    for (size_t e = 0; e < edges.size(); e++) {
+      incidentEdges[fill[first[e]]++] = e;
+      incidentEdges[fill[second[e]]++] = e;
+    }
+  }
+
+  size_t numNodes() const { return keys.size(); }
+  size_t numEdges() const { return first.size(); }
+
+  // The direction of the edge is the direction of positive weight. This means
+  // that the edge is from first -> second if weight is positive and second ->
+  // first if weight is negative.
+  size_t source(size_t e, double weight) const {
+    return weight >= 0 ? first[e] : second[e];
+  }
+  size_t dest(size_t e, double weight) const {
+    return weight >= 0 ? second[e] : first[e];
+  }
 };
 
-// A graph is a map from key to GraphNode. This function returns the graph from
-// the edgeWeights between keys.
-unordered_map<Key, GraphNode> graphFromEdges(
-    const map<MFAS::KeyPair, double>& edgeWeights) {
-  unordered_map<Key, GraphNode> graph;
+// Computes the MFAS ordering of the nodes in the graph, as node indices.
+vector<size_t> computeOrdering(const EdgeGraph& graph,
+                               const vector<double>& weights) {
+  const size_t n = graph.numNodes();
+  vector<double> inWeightSum(n, 0.0), outWeightSum(n, 0.0);
+  for (size_t e = 0; e < graph.numEdges(); e++) {
+    inWeightSum[graph.dest(e, weights[e])] += std::abs(weights[e]);
+    outWeightSum[graph.source(e, weights[e])] += std::abs(weights[e]);
+  }
 
-  for (const auto& edgeWeight : edgeWeights) {
-    // The weights can be either negative or positive. The direction of the edge
-    // is the direction of positive weight. This means that the edges is from
-    // edge.first -> edge.second if weight is positive and edge.second ->
-    // edge.first if weight is negative.
-    const MFAS::KeyPair& edge = edgeWeight.first;
-    const double& weight = edgeWeight.second;
-
-    Key edgeSource = weight >= 0 ? edge.first : edge.second;
-    Key edgeDest = weight >= 0 ? edge.second : edge.first;
-
-    // Update the in weight and neighbors for the destination.
-    graph[edgeDest].inWeightSum += std::abs(weight);
-    graph[edgeDest].inNeighbors.insert(edgeSource);
-
-    // Update the out weight and neighbors for the source.
-    graph[edgeSource].outWeightSum += std::abs(weight);
-    graph[edgeSource].outNeighbors.insert(edgeDest);
+  // Heuristic for the node that is to select nodes in MFAS.
+  auto heuristic = [&](size_t node) {
+    return (outWeightSum[node] + 1) / (inWeightSum[node] + 1);
+  };
+  // It is a root node if the inWeightSum is close to zero.
+  auto isRoot = [&](size_t node) { return inWeightSum[node] < 1e-8; };
+
+  // Root nodes are taken first, smallest key first. Otherwise the node with
+  // the highest heuristic is taken, using a queue with lazy deletion: an entry
+  // is stale if the node was removed or its heuristic has changed since.
+  std::priority_queue<size_t, vector<size_t>, std::greater<size_t>> roots;
+  auto byHeuristic = [](const pair<double, size_t>& a,
+                        const pair<double, size_t>& b) {
+    return a.first < b.first || (a.first == b.first && a.second > b.second);
+  };
+  std::priority_queue<pair<double, size_t>, vector<pair<double, size_t>>,
+                      decltype(byHeuristic)>
+      candidates(byHeuristic);
+  for (size_t node = 0; node < n; node++) {
+    if (isRoot(node)) roots.push(node);
+    candidates.emplace(heuristic(node), node);
   }
-  return graph;
-}
 
-// Selects the next node in the ordering from the graph.
-Key selectNextNodeInOrdering(const unordered_map<Key, GraphNode>& graph) {
-  // Find the root nodes in the graph.
-  for (const auto& keyNode : graph) {
-    // It is a root node if the inWeightSum is close to zero.
-    if (keyNode.second.inWeightSum < 1e-8) {
-      // TODO(akshay-krishnan) if there are multiple roots, it is better to
-      // choose the one with highest heuristic. This is missing in the 1dsfm
-      // solution.
-      return keyNode.first;
+  vector<bool> removed(n, false);
+  vector<size_t> ordering;
+  ordering.reserve(n);
+  while (ordering.size() < n) {
+    size_t selection;
+    while (!roots.empty() && removed[roots.top()]) roots.pop();
+    if (!roots.empty()) {
+      selection = roots.top();
+      roots.pop();
+    } else {
+      while (removed[candidates.top().second] ||
+             candidates.top().first != heuristic(candidates.top().second))
+        candidates.pop();
+      selection = candidates.top().second;
+      candidates.pop();
+    }
+
+    // Remove the node from the graph and update edge weights of its neighbors.
+    removed[selection] = true;
+    ordering.push_back(selection);
+    for (size_t k = graph.incidenceStart[selection];
+         k < graph.incidenceStart[selection + 1]; k++) {
+      const size_t e = graph.incidentEdges[k];
+      const size_t source = graph.source(e, weights[e]);
+      const size_t neighbor = source == selection ? graph.dest(e, weights[e])
+                                                  : source;
+      if (removed[neighbor]) continue;
+      if (source == selection) {
+        inWeightSum[neighbor] -= std::abs(weights[e]);
+        if (isRoot(neighbor)) roots.push(neighbor);
+      } else {
+        outWeightSum[neighbor] -= std::abs(weights[e]);
+      }
+      candidates.emplace(heuristic(neighbor), neighbor);
     }
   }
-  // If there are no root nodes, return the node with the highest heuristic.
-  return std::max_element(graph.begin(), graph.end(),
-                          [](const std::pair<Key, GraphNode>& keyNode1,
-                             const std::pair<Key, GraphNode>& keyNode2) {
-                            return keyNode1.second.heuristic() <
-                                   keyNode2.second.heuristic();
-                          })
-      ->first;
+  return ordering;
 }
 
-// Returns the absolute weight of the edge between node1 and node2.
-double absWeightOfEdge(const Key key1, const Key key2,
-                       const map<MFAS::KeyPair, double>& edgeWeights) {
-  // Check the direction of the edge before returning.
-  return edgeWeights.find(MFAS::KeyPair(key1, key2)) != edgeWeights.end()
-             ? std::abs(edgeWeights.at(MFAS::KeyPair(key1, key2)))
-             : std::abs(edgeWeights.at(MFAS::KeyPair(key2, key1)));
-}
+// Computes the outlier weight of every edge. We define the outlier weight of
+// an edge to be zero if the edge is consistent with the ordering and the
+// magnitude of its weight if it is not.
+vector<double> computeOutlierWeights(const EdgeGraph& graph,
+                                     const vector<double>& weights) {
+  const vector<size_t> ordering = computeOrdering(graph, weights);
+
+  // Position of each node in the ordering.
+  vector<size_t> positions(graph.numNodes());
+  for (size_t i = 0; i < ordering.size(); i++) positions[ordering[i]] = i;
 
-// Removes a node from the graph and updates edge weights of its neighbors.
-void removeNodeFromGraph(const Key node,
-                         const map<MFAS::KeyPair, double> edgeWeights,
-                         unordered_map<Key, GraphNode>& graph) {
-  // Update the outweights and outNeighbors of node's inNeighbors
-  for (const Key neighbor : graph[node].inNeighbors) {
-    // the edge could be either (*it, choice) with a positive weight or
-    // (choice, *it) with a negative weight
-    graph[neighbor].outWeightSum -=
-        absWeightOfEdge(node, neighbor, edgeWeights);
-    graph[neighbor].outNeighbors.erase(node);
+  // If the direction is not consistent with the ordering (i.e dest occurs
+  // before src), it is an outlier edge, and has non-zero outlier weight.
+  vector<double> outlierWeights(graph.numEdges());
+  for (size_t e = 0; e < graph.numEdges(); e++) {
+    const size_t source = graph.source(e, weights[e]);
+    const size_t dest = graph.dest(e, weights[e]);
+    outlierWeights[e] =
+        positions[dest] < positions[source] ? std::abs(weights[e]) : 0.0;
   }
-  // Update the inWeights and inNeighbors of node's outNeighbors
-  for (const Key neighbor : graph[node].outNeighbors) {
-    graph[neighbor].inWeightSum -= absWeightOfEdge(node, neighbor, edgeWeights);
-    graph[neighbor].inNeighbors.erase(node);
+  return outlierWeights;
+}
+
+}  // namespace
+
+MFAS::MFAS(const map<KeyPair, double>& edgeWeights) {
+  edges_.reserve(edgeWeights.size());
+  weights_.reserve(edgeWeights.size());
+  for (const auto& edgeWeight : edgeWeights) {
+    edges_.push_back(edgeWeight.first);
+    weights_.push_back(edgeWeight.second);
   }
-  // Erase node.
-  graph.erase(node);
 }
 
 MFAS::MFAS(const TranslationEdges& relativeTranslations,
            const Unit3& projectionDirection) {
-  // Iterate over edges, obtain weights by projecting
-  // their relativeTranslations along the projection direction
-  for (const auto& measurement : relativeTranslations) {
-    edgeWeights_[{measurement.key1(), measurement.key2()}] =
-        measurement.measured().dot(projectionDirection);
+  vector<KeyPair> edges;
+  edges.reserve(relativeTranslations.size());
+  for (const auto& measurement : relativeTranslations)
+    edges.emplace_back(measurement.key1(), measurement.key2());
+
+  // Obtain weights by projecting the relativeTranslations along the
+  // projection direction.
+  const vector<size_t> unique = uniqueSortedEdges(edges);
+  edges_.reserve(unique.size());
+  weights_.reserve(unique.size());
+  for (size_t k : unique) {
+    edges_.push_back(edges[k]);
+    weights_.push_back(
+        relativeTranslations[k].measured().dot(projectionDirection));
   }
 }
 
 KeyVector MFAS::computeOrdering() const {
+  const EdgeGraph graph(edges_);
   KeyVector ordering;  // Nodes in MFAS order (result).
-
-  // A graph is an unordered map from keys to nodes. Each node contains a list
-  // of its adjacent nodes. Create the graph from the edgeWeights.
-  unordered_map<Key, GraphNode> graph = graphFromEdges(edgeWeights_);
-
-  // In each iteration, one node is removed from the graph and appended to the
-  // ordering.
-  while (!graph.empty()) {
-    Key selection = selectNextNodeInOrdering(graph);
-    removeNodeFromGraph(selection, edgeWeights_, graph);
-    ordering.push_back(selection);
-  }
+  for (size_t node : ::computeOrdering(graph, weights_))
+    ordering.push_back(graph.keys[node]);
   return ordering;
 }
 
 map<MFAS::KeyPair, double> MFAS::computeOutlierWeights() const {
-  // Find the ordering.
-  KeyVector ordering = computeOrdering();
-
-  // Create a map from the node key to its position in the ordering. This makes
-  // it easier to lookup positions of different nodes.
-  unordered_map<Key, int> orderingPositions;
-  for (size_t i = 0; i < ordering.size(); i++) {
-    orderingPositions[ordering[i]] = i;
-  }
-
+  const EdgeGraph graph(edges_);
+  const vector<double> weights = ::computeOutlierWeights(graph, weights_);
   map<KeyPair, double> outlierWeights;
-  // Check if the direction of each edge is consistent with the ordering.
-  for (const auto& edgeWeight : edgeWeights_) {
-    // Find edge source and destination.
-    Key source = edgeWeight.first.first;
-    Key dest = edgeWeight.first.second;
-    if (edgeWeight.second < 0) {
-      std::swap(source, dest);
-    }
+  for (size_t e = 0; e < edges_.size(); e++)
+    outlierWeights.emplace_hint(outlierWeights.end(), edges_[e], weights[e]);
+  return outlierWeights;
+}
 
-    // If the direction is not consistent with the ordering (i.e dest occurs
-    // before src), it is an outlier edge, and has non-zero outlier weight.
-    if (orderingPositions.at(dest) < orderingPositions.at(source)) {
-      outlierWeights[edgeWeight.first] = std::abs(edgeWeight.second);
-    } else {
-      outlierWeights[edgeWeight.first] = 0;
-    }
+map<MFAS::KeyPair, double> MFAS::AverageOutlierWeights(
+    const TranslationEdges& relativeTranslations,
+    const vector<Unit3>& projectionDirections) {
+  vector<KeyPair> edges;
+  edges.reserve(relativeTranslations.size());
+  for (const auto& measurement : relativeTranslations)
+    edges.emplace_back(measurement.key1(), measurement.key2());
+  const vector<size_t> unique = uniqueSortedEdges(edges);
+
+  vector<KeyPair> uniqueEdges;
+  uniqueEdges.reserve(unique.size());
+  for (size_t k : unique) uniqueEdges.push_back(edges[k]);
+  const EdgeGraph graph(uniqueEdges);
+
+  // Outlier weights for every direction.
+  const size_t numDirections = projectionDirections.size();
+  vector<vector<double>> outlierWeights(numDirections);
+  auto processDirection = [&](size_t i) {
+    vector<double> weights;
+    weights.reserve(unique.size());
+    for (size_t k : unique)
+      weights.push_back(
+          relativeTranslations[k].measured().dot(projectionDirections[i]));
+    outlierWeights[i] = ::computeOutlierWeights(graph, weights);
+  };
+#ifdef GTSAM_USE_TBB
+  tbb::parallel_for(tbb::blocked_range<size_t>(0, numDirections),
+                    [&](const tbb::blocked_range<size_t>& range) {
+                      for (size_t i = range.begin(); i != range.end(); ++i)
+                        processDirection(i);
+                    });
+#else
+  for (size_t i = 0; i < numDirections; i++) processDirection(i);
+#endif
+
+  // Average in a fixed order, so the result does not depend on threading.
+  map<KeyPair, double> averageWeights;
+  for (size_t e = 0; e < uniqueEdges.size(); e++) {
+    double sum = 0.0;
+    for (size_t i = 0; i < numDirections; i++) sum += outlierWeights[i][e];
+    averageWeights.emplace_hint(averageWeights.end(), uniqueEdges[e],
+                                numDirections ? sum / numDirections : 0.0);
   }
-  return outlierWeights;
+  return averageWeights;
 }
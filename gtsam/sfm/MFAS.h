@@ -22,6 +22,7 @@
 #include <gtsam/inference/Key.h>
 #include <gtsam/sfm/BinaryMeasurement.h>
 
+#include <map>
 #include <memory>
 #include <unordered_map>
 #include <vector>
@@ -46,6 +47,9 @@ namespace gtsam {
   i.e w_aZb is the unit translation from a to b expressed in the world
   coordinate frame. The weights for the edges are obtained by projecting the
   unit translations in a projection direction.
+
+  Internally, keys are mapped to dense indices and edges are kept in flat
+  arrays, and the next node of the ordering is found with a priority queue.
   @ingroup sfm
 */
 class GTSAM_EXPORT MFAS {
@@ -56,9 +60,10 @@ class GTSAM_EXPORT MFAS {
   using TranslationEdges = std::vector<BinaryMeasurement<Unit3>>;
 
  private:
-  // edges with a direction such that all weights are positive
-  // i.e, edges that originally had negative weights are flipped
-  std::map<KeyPair, double> edgeWeights_;
+  // unique edges, sorted, and their weights. A negative weight means the
+  // edge is directed from edges_[k].second to edges_[k].first.
+  std::vector<KeyPair> edges_;
+  std::vector<double> weights_;
 
  public:
   /**
@@ -66,8 +71,7 @@ class GTSAM_EXPORT MFAS {
    * between the nodes. Each node is identified by a Key.
    * @param edgeWeights: weights of edges in the graph
    */
-  MFAS(const std::map<KeyPair, double> &edgeWeights)
-      : edgeWeights_(edgeWeights) {}
+  MFAS(const std::map<KeyPair, double> &edgeWeights);
 
   /**
    * @brief Constructor to be used in the context of translation averaging.
@@ -94,6 +98,19 @@ class GTSAM_EXPORT MFAS {
    * @return outlierWeights: map from an edge to its outlier weight.
    */
   std::map<KeyPair, double> computeOutlierWeights() const;
+
+  /**
+   * @brief Run MFAS for several projection directions and average the
+   * resulting outlier weights, as done in 1DSfM to reject outlier translation
+   * directions. The graph structure is built once and shared, and the
+   * directions are processed in parallel when GTSAM is built with TBB.
+   * @param relativeTranslations translation directions between the cameras
+   * @param projectionDirections directions in which edges are projected
+   * @return map from an edge to its outlier weight, averaged over directions.
+   */
+  static std::map<KeyPair, double> AverageOutlierWeights(
+      const TranslationEdges &relativeTranslations,
+      const std::vector<Unit3> &projectionDirections);
 };
 
 typedef std::map<std::pair<Key, Key>, double> KeyPairDoubleMap;
@@ -28,6 +28,11 @@
 #include <gtsam/sfm/ShonanGaugeFactor.h>
 #include <gtsam/slam/FrobeniusFactor.h>
 #include <gtsam/slam/KarcherMeanFactor-inl.h>
+#include <gtsam/config.h> // for GTSAM_USE_TBB
+
+#ifdef GTSAM_USE_TBB
+#include <tbb/parallel_for.h>
+#endif
 
 #include <Eigen/Eigenvalues>
 #include <algorithm>
@@ -572,7 +577,8 @@ static bool PowerMinimumEigenValue(
 /** This is a lightweight struct used in conjunction with Spectra to compute
  * the minimum eigenvalue and eigenvector of a sparse matrix A; it has a single
  * nontrivial function, perform_op(x,y), that computes and returns the product
- * y = (A + sigma*I) x */
+ * y = (A + sigma*I) x. A is assumed symmetric, which with TBB lets every y_i be
+ * computed independently from column i of the (column-major) matrix. */
 struct MatrixProdFunctor {
   // Const reference to an externally-held matrix whose minimum-eigenvalue we
   // want to compute
@@ -594,8 +600,18 @@ struct MatrixProdFunctor {
     Eigen::Map<const Vector> X(x, rows());
     Eigen::Map<Vector> Y(y, rows());
 
+#ifdef GTSAM_USE_TBB
+    // Row i of A is column i, so y_i is a sparse dot product
+    tbb::parallel_for(tbb::blocked_range<Eigen::Index>(0, rows(), 1024),
+                      [&](const tbb::blocked_range<Eigen::Index> &range) {
+                        for (Eigen::Index i = range.begin(); i != range.end();
+                             ++i)
+                          Y(i) = A_.col(i).dot(X) + sigma_ * X(i);
+                      });
+#else
     // Do the multiplication using wrapped Eigen vectors
     Y = A_ * X + sigma_ * X;
+#endif
   }
 };
 
@@ -625,19 +641,28 @@ struct MatrixProdFunctor {
 //   ~1000 should be sufficiently large
 //   - We've been using 10^-4 for the nonnegativity tolerance
 //   - for numLanczosVectors, 20 is a good default value
+//
+// If dominantEigenVector is given and has the right size, it is used to
+// start the largest-magnitude Lanczos iterations, and is overwritten with the
+// new estimate. The dominant eigenpair of A changes little between levels of
+// the staircase, so this warm-starts the first solve at the next level.
 
 static bool SparseMinimumEigenValue(
     const Sparse &A, const Matrix &S, double *minEigenValue,
     Vector *minEigenVector = 0, size_t *numIterations = 0,
     size_t maxIterations = 1000,
     double minEigenvalueNonnegativityTolerance = 10e-4,
-    Eigen::Index numLanczosVectors = 20) {
+    Eigen::Index numLanczosVectors = 20,
+    Vector *dominantEigenVector = 0) {
   // a. Estimate the largest-magnitude eigenvalue of this matrix using Lanczos
   MatrixProdFunctor lmOperator(A);
   Spectra::SymEigsSolver<double, Spectra::SELECT_EIGENVALUE::LARGEST_MAGN,
                          MatrixProdFunctor>
       lmEigenValueSolver(&lmOperator, 1, std::min(numLanczosVectors, A.rows()));
-  lmEigenValueSolver.init();
+  if (dominantEigenVector && dominantEigenVector->size() == A.rows())
+    lmEigenValueSolver.init(dominantEigenVector->data());
+  else
+    lmEigenValueSolver.init();
 
   const int lmConverged = lmEigenValueSolver.compute(
       maxIterations, 1e-4, Spectra::SELECT_EIGENVALUE::LARGEST_MAGN);
@@ -646,6 +671,8 @@ static bool SparseMinimumEigenValue(
   if (lmConverged != 1) return false;
 
   const double lmEigenValue = lmEigenValueSolver.eigenvalues()(0);
+  if (dominantEigenVector)
+    *dominantEigenVector = lmEigenValueSolver.eigenvectors(1).col(0);
 
   if (lmEigenValue < 0) {
     // The largest-magnitude eigenvalue is negative, and therefore also the
@@ -717,12 +744,22 @@ static bool SparseMinimumEigenValue(
 template <size_t d>
 double ShonanAveraging<d>::computeMinEigenValue(const Values &values,
                                                 Vector *minEigenVector) const {
+  return computeMinEigenValue(values, minEigenVector, nullptr);
+}
+
+/* ************************************************************************* */
+template <size_t d>
+double ShonanAveraging<d>::computeMinEigenValue(
+    const Values &values, Vector *minEigenVector,
+    Vector *dominantEigenVector) const {
   assert(values.size() == nrUnknowns());
   const Matrix S = StiefelElementMatrix(values);
   auto A = computeA(S);
 
   double minEigenValue;
-  bool success = SparseMinimumEigenValue(A, S, &minEigenValue, minEigenVector);
+  bool success =
+      SparseMinimumEigenValue(A, S, &minEigenValue, minEigenVector, 0, 1000,
+                              10e-4, 20, dominantEigenVector);
   if (!success) {
     throw std::runtime_error(
         "SparseMinimumEigenValue failed to compute minimum eigenvalue.");
@@ -827,6 +864,8 @@ Values ShonanAveraging<d>::initializeWithDescent(
     double minEigenValue, double gradienTolerance,
     double preconditionedGradNormTolerance) const {
   double funcVal = costAt(p - 1, values);
+  // Build the graph at level p once, rather than in costAt at every step
+  const NonlinearFactorGraph graph = buildGraphAt(p);
   double alphaMin = 1e-2;
   double alpha =
       std::max(1024 * alphaMin, 10 * gradienTolerance / fabs(minEigenValue));
@@ -835,7 +874,7 @@ Values ShonanAveraging<d>::initializeWithDescent(
   // line search
   while ((alpha >= alphaMin)) {
     Values Qplus = LiftwithDescent(p, values, alpha * minEigenVector);
-    double funcValTest = costAt(p, Qplus);
+    double funcValTest = graph.error(Qplus);
     Matrix gradTest = riemannianGradient(p, Qplus);
     double gradTestNorm = gradTest.norm();
     // Record alpha and funcVal
@@ -896,6 +935,8 @@ std::pair<Values, double> ShonanAveraging<d>::run(const Values &initialEstimate,
                                                   size_t pMax) const {
   Values Qstar;
   Values initialSOp = LiftTo<Rot>(pMin, initialEstimate);  // lift to pMin!
+  // Dominant eigenvector of A, carried over to warm-start the next level
+  Vector dominantEigenVector;
   for (size_t p = pMin; p <= pMax; p++) {
     // Optimize until convergence at this level
     Qstar = tryOptimizingAt(p, initialSOp);
@@ -910,7 +951,8 @@ std::pair<Values, double> ShonanAveraging<d>::run(const Values &initialEstimate,
     } else {
       // Check certificate of global optimality
       Vector minEigenVector;
-      double minEigenValue = computeMinEigenValue(Qstar, &minEigenVector);
+      double minEigenValue =
+          computeMinEigenValue(Qstar, &minEigenVector, &dominantEigenVector);
       if (minEigenValue > parameters_.optimalityThreshold) {
         // If at global optimum, round and return solution
         const Values SO3Values = roundSolution(Qstar);
@@ -253,6 +253,16 @@ class GTSAM_EXPORT ShonanAveraging {
   double computeMinEigenValue(const Values &values,
                               Vector *minEigenVector = nullptr) const;
 
+  /**
+   * Version of computeMinEigenValue that warm-starts the Lanczos iterations.
+   * @param values: should be of type SOn
+   * @param dominantEigenVector: if of size dN, used as starting vector for the
+   * largest-magnitude eigenvalue estimate, and overwritten with the new one.
+   * Passing the same vector at every level of the staircase reuses it.
+   */
+  double computeMinEigenValue(const Values &values, Vector *minEigenVector,
+                              Vector *dominantEigenVector) const;
+
   /**
    * Compute minimum eigenvalue with accelerated power method.
    * @param values: should be of type SOn
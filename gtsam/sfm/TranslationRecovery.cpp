@@ -32,6 +32,7 @@
 #include <gtsam/slam/PriorFactor.h>
 #include <gtsam/slam/expressions.h>
 
+#include <map>
 #include <set>
 #include <utility>
 
@@ -77,15 +78,16 @@ std::vector<BinaryMeasurement<T>> removeSameTranslationNodes(
 
 // Adds nodes that were not optimized for because they were connected
 // to another node with a zero-translation edge in the input.
-Values addSameTranslationNodes(const Values &result,
-                               const DSFMap<Key> &sameTranslationDSFMap) {
+Values addSameTranslationNodes(
+    const Values &result,
+    const std::map<Key, std::set<Key>> &sameTranslationSets) {
   Values final_result = result;
   // Nodes that were not optimized are stored in sameTranslationNodes_ as a map
   // from a key that was optimized to keys that were not optimized. Iterate over
   // map and add results for keys not optimized.
-  for (const auto &optimizedAndDuplicateKeys : sameTranslationDSFMap.sets()) {
+  for (const auto &optimizedAndDuplicateKeys : sameTranslationSets) {
     Key optimizedKey = optimizedAndDuplicateKeys.first;
-    std::set<Key> duplicateKeys = optimizedAndDuplicateKeys.second;
+    const std::set<Key> &duplicateKeys = optimizedAndDuplicateKeys.second;
     // Add the result for the duplicate key if it does not already exist.
     for (const Key duplicateKey : duplicateKeys) {
       if (final_result.exists(duplicateKey)) continue;
@@ -99,9 +101,10 @@ Values addSameTranslationNodes(const Values &result,
 NonlinearFactorGraph TranslationRecovery::buildGraph(
     const std::vector<BinaryMeasurement<Unit3>> &relativeTranslations) const {
   NonlinearFactorGraph graph;
+  graph.reserve(relativeTranslations.size());
 
   // Add translation factors for input translation directions.
-  for (auto edge : relativeTranslations) {
+  for (const auto &edge : relativeTranslations) {
     graph.emplace_shared<TranslationFactor>(edge.key1(), edge.key2(),
                                             edge.measured(), edge.noiseModel());
   }
@@ -127,7 +130,7 @@ void TranslationRecovery::addPrior(
   }
 
   // Add between factors for optional relative translations.
-  for (auto prior_edge : betweenTranslations) {
+  for (const auto &prior_edge : betweenTranslations) {
     graph->emplace_shared<BetweenFactor<Point3>>(
         prior_edge.key1(), prior_edge.key2(), prior_edge.measured(),
         prior_edge.noiseModel());
@@ -154,12 +157,12 @@ Values TranslationRecovery::initializeRandomly(
   };
 
   // Loop over measurements and add a random translation
-  for (auto edge : relativeTranslations) {
+  for (const auto &edge : relativeTranslations) {
     insert(edge.key1());
     insert(edge.key2());
   }
   // There may be nodes in betweenTranslations that do not have a measurement.
-  for (auto edge : betweenTranslations) {
+  for (const auto &edge : betweenTranslations) {
     insert(edge.key1());
     insert(edge.key2());
   }
@@ -186,6 +189,9 @@ Values TranslationRecovery::run(
       removeSameTranslationNodes(relativeTranslations, sameTranslationDSFMap);
   const std::vector<BinaryMeasurement<Point3>> nonzeroBetweenTranslations =
       removeSameTranslationNodes(betweenTranslations, sameTranslationDSFMap);
+  // Compute the sets of same-translation nodes only once.
+  const std::map<Key, std::set<Key>> sameTranslationSets =
+      sameTranslationDSFMap.sets();
 
   // Create graph of translation factors.
   NonlinearFactorGraph graph = buildGraph(nonzeroRelativeTranslations);
@@ -201,8 +207,8 @@ Values TranslationRecovery::run(
 
   // If there are no valid edges, but zero-distance edges exist, initialize one
   // of the nodes in a connected component of zero-distance edges.
-  if (initial.empty() && !sameTranslationDSFMap.sets().empty()) {
-    for (const auto &optimizedAndDuplicateKeys : sameTranslationDSFMap.sets()) {
+  if (initial.empty() && !sameTranslationSets.empty()) {
+    for (const auto &optimizedAndDuplicateKeys : sameTranslationSets) {
       Key optimizedKey = optimizedAndDuplicateKeys.first;
       initial.insert<Point3>(optimizedKey, Point3(0, 0, 0));
     }
@@ -210,7 +216,7 @@ Values TranslationRecovery::run(
 
   LevenbergMarquardtOptimizer lm(graph, initial, lmParams_);
   Values result = lm.optimize();
-  return addSameTranslationNodes(result, sameTranslationDSFMap);
+  return addSameTranslationNodes(result, sameTranslationSets);
 }
 
 TranslationRecovery::TranslationEdges TranslationRecovery::SimulateMeasurements(
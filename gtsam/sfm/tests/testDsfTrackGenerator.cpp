@@ -0,0 +1,123 @@
+/* ----------------------------------------------------------------------------
+
+ * GTSAM Copyright 2010, Georgia Tech Research Corporation,
+ * Atlanta, Georgia 30332-0415
+ * All Rights Reserved
+ * Authors: Frank Dellaert, et al. (see THANKS for the full author list)
+
+ * See LICENSE for the license information
+
+ * -------------------------------------------------------------------------- */
+
+/**
+ * @file testDsfTrackGenerator.cpp
+ * @date October 2026
+ * @brief tests for track generation from pairwise matches
+ */
+
+#include <CppUnitLite/TestHarness.h>
+#include <gtsam/base/TestableAssertions.h>
+#include <gtsam/sfm/DsfTrackGenerator.h>
+
+using namespace std;
+using namespace gtsam;
+using namespace gtsam::gtsfm;
+
+/* ************************************************************************* */
+// Three images, same setup as the python test.
+TEST(DsfTrackGenerator, threeImages) {
+  Eigen::MatrixX2d c0(2, 2), c1(3, 2), c2(2, 2);
+  c0 << 10, 20, 30, 40;
+  c1 << 50, 60, 70, 80, 90, 100;
+  c2 << 110, 120, 130, 140;
+  KeypointsVector keypoints{Keypoints(c0), Keypoints(c1), Keypoints(c2)};
+
+  MatchIndicesMap matches;
+  CorrespondenceIndices m01(2, 2), m12(2, 2);
+  m01 << 0, 0, 1, 1;
+  m12 << 2, 0, 1, 1;
+  matches[IndexPair(0, 1)] = m01;
+  matches[IndexPair(1, 2)] = m12;
+
+  const vector<SfmTrack2d> tracks = tracksFromPairwiseMatches(matches, keypoints);
+  LONGS_EQUAL(3, tracks.size());
+
+  // Tracks are ordered by their smallest (i,k), measurements by (i,k).
+  LONGS_EQUAL(2, tracks[0].numberMeasurements());
+  LONGS_EQUAL(0, tracks[0].measurements[0].first);
+  LONGS_EQUAL(1, tracks[0].measurements[1].first);
+  EXPECT(assert_equal(Point2(10, 20), tracks[0].measurements[0].second));
+  EXPECT(assert_equal(Point2(50, 60), tracks[0].measurements[1].second));
+
+  LONGS_EQUAL(3, tracks[1].numberMeasurements());
+  EXPECT(assert_equal(Point2(30, 40), tracks[1].measurements[0].second));
+  EXPECT(assert_equal(Point2(70, 80), tracks[1].measurements[1].second));
+  EXPECT(assert_equal(Point2(130, 140), tracks[1].measurements[2].second));
+
+  LONGS_EQUAL(2, tracks[2].numberMeasurements());
+  EXPECT(assert_equal(Point2(90, 100), tracks[2].measurements[0].second));
+  EXPECT(assert_equal(Point2(110, 120), tracks[2].measurements[1].second));
+}
+
+/* ************************************************************************* */
+// Many image pairs forming one chain per keypoint index.
+TEST(DsfTrackGenerator, chains) {
+  const size_t numImages = 50, numKeypoints = 20;
+  KeypointsVector keypoints;
+  for (size_t i = 0; i < numImages; i++) {
+    Eigen::MatrixX2d coordinates(numKeypoints, 2);
+    for (size_t k = 0; k < numKeypoints; k++) coordinates.row(k) << i, k;
+    keypoints.emplace_back(coordinates);
+  }
+
+  // Match keypoint k in image i with keypoint k in image i+1, in reverse order
+  // so merges do not happen in track order.
+  MatchIndicesMap matches;
+  for (size_t i = 0; i + 1 < numImages; i++) {
+    CorrespondenceIndices corr(numKeypoints, 2);
+    for (size_t k = 0; k < numKeypoints; k++)
+      corr.row(k) << numKeypoints - 1 - k, numKeypoints - 1 - k;
+    matches[IndexPair(i, i + 1)] = corr;
+  }
+
+  const vector<SfmTrack2d> tracks = tracksFromPairwiseMatches(matches, keypoints);
+  LONGS_EQUAL(numKeypoints, tracks.size());
+  for (size_t k = 0; k < numKeypoints; k++) {
+    LONGS_EQUAL(numImages, tracks[k].numberMeasurements());
+    for (size_t i = 0; i < numImages; i++) {
+      LONGS_EQUAL(i, tracks[k].measurements[i].first);
+      EXPECT(assert_equal(Point2(i, k), tracks[k].measurements[i].second));
+    }
+  }
+}
+
+/* ************************************************************************* */
+// A correspondence with a keypoint index beyond the image's keypoints throws,
+// rather than silently referring to a detection in the next image.
+TEST(DsfTrackGenerator, keypointOutOfRange) {
+  Eigen::MatrixX2d c0(2, 2), c1(2, 2);
+  c0 << 10, 20, 30, 40;
+  c1 << 50, 60, 70, 80;
+  KeypointsVector keypoints{Keypoints(c0), Keypoints(c1)};
+
+  MatchIndicesMap matches;
+  CorrespondenceIndices m01(1, 2);
+  m01 << 2, 0;  // image 0 only has keypoints 0 and 1
+  matches[IndexPair(0, 1)] = m01;
+  CHECK_EXCEPTION(tracksFromPairwiseMatches(matches, keypoints),
+                  std::out_of_range);
+
+  // Same for an image index beyond the keypoints vector
+  matches.clear();
+  m01 << 0, 0;
+  matches[IndexPair(0, 2)] = m01;
+  CHECK_EXCEPTION(tracksFromPairwiseMatches(matches, keypoints),
+                  std::out_of_range);
+}
+
+/* ************************************************************************* */
+int main() {
+  TestResult tr;
+  return TestRegistry::runAllTests(tr);
+}
+/* ************************************************************************* */
@@ -96,6 +96,37 @@ TEST(MFAS, OrderingWeights1) {
   }
 }
 
+// test that averaging over projection directions matches running MFAS
+// separately for every direction
+TEST(MFAS, AverageOutlierWeights) {
+  const auto model = noiseModel::Isotropic::Sigma(3, 0.01);
+  MFAS::TranslationEdges translations;
+  translations.emplace_back(0, 1, Unit3(1, 0, 0), model);
+  translations.emplace_back(1, 2, Unit3(1, 1, 0), model);
+  translations.emplace_back(0, 2, Unit3(1, 0.5, 0), model);
+  translations.emplace_back(2, 3, Unit3(0, 1, 0.2), model);
+  // outlier, pointing back from 3 to 0
+  translations.emplace_back(3, 0, Unit3(0.5, 1, 0), model);
+
+  const vector<Unit3> directions = {Unit3(1, 0, 0), Unit3(0, 1, 0),
+                                    Unit3(1, 1, 1)};
+  map<MFAS::KeyPair, double> expected;
+  for (const Unit3 &direction : directions) {
+    for (const auto &edgeWeight :
+         MFAS(translations, direction).computeOutlierWeights())
+      expected[edgeWeight.first] += edgeWeight.second / directions.size();
+  }
+
+  const map<MFAS::KeyPair, double> actual =
+      MFAS::AverageOutlierWeights(translations, directions);
+  EXPECT_LONGS_EQUAL(expected.size(), actual.size());
+  for (const auto &edgeWeight : expected) {
+    EXPECT_DOUBLES_EQUAL(edgeWeight.second, actual.at(edgeWeight.first), 1e-9);
+  }
+  // the outlier is inconsistent for at least one direction
+  EXPECT(actual.at(make_pair(Key(3), Key(0))) > 0);
+}
+
 /* ************************************************************************* */
 int main() {
   TestResult tr;
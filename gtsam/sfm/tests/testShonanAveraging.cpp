@@ -215,6 +215,25 @@ TEST(ShonanAveraging3, CheckWithEigen) {
   // EXPECT(assert_equal(SOn(expected), initialQ4.at<SOn>(0), 1e-5));
 }
 
+/* ************************************************************************* */
+TEST(ShonanAveraging3, computeMinEigenValueWarmStart) {
+  std::mt19937 rng(7);
+  const Values random = kShonan.initializeRandomlyAt(4, rng);
+  const double expected = kShonan.computeMinEigenValue(random);
+
+  // Cold start fills in the dominant eigenvector...
+  Vector dominantEigenVector;
+  double actual =
+      kShonan.computeMinEigenValue(random, nullptr, &dominantEigenVector);
+  EXPECT_LONGS_EQUAL(15, dominantEigenVector.size());
+  EXPECT_DOUBLES_EQUAL(expected, actual, 1e-4);
+
+  // ...which can then be used to warm-start at another point.
+  const Values Qstar4 = kShonan.tryOptimizingAt(4, random);
+  actual = kShonan.computeMinEigenValue(Qstar4, nullptr, &dominantEigenVector);
+  EXPECT_DOUBLES_EQUAL(kShonan.computeMinEigenValue(Qstar4), actual, 1e-4);
+}
+
 /* ************************************************************************* */
 TEST(ShonanAveraging3, initializeWithDescent) {
   const Values randomRotations = kShonan.initializeRandomly(kRandomNumberGenerator);
@@ -123,6 +123,11 @@ namespace gtsam {
 #endif
     }
 
+    /// Robust between factors are reweighted together by NonlinearFactorGraph
+    const noiseModel::mEstimator::Base* robustEstimator() const override {
+      return this->noiseModelEstimator();
+    }
+
     /// @}
     /// @name Standard interface 
     /// @{
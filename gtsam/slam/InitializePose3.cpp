@@ -26,6 +26,14 @@
 #include <gtsam/geometry/Pose2.h>
 #include <gtsam/geometry/Pose3.h>
 #include <gtsam/base/timing.h>
+#include <gtsam/config.h>  // for GTSAM_USE_TBB
+
+#include <Eigen/Sparse>
+#include <Eigen/SparseCholesky>
+
+#ifdef GTSAM_USE_TBB
+#include <tbb/parallel_for.h>
+#endif
 
 #include <utility>
 
@@ -70,25 +78,134 @@ GaussianFactorGraph InitializePose3::buildLinearOrientationGraph(const Nonlinear
   return linearGraph;
 }
 
+/* ************************************************************************* */
+// Project the relaxed matrices M[i] to the closest rotations, which takes an
+// SVD each and is done in parallel if TBB is available.
+static Values closestRotations(const KeyVector& keys,
+                               const std::vector<Matrix3>& relaxed) {
+  std::vector<Rot3> rotations(keys.size());
+  const auto project = [&](size_t i) {
+    // ClosestTo finds rotation matrix closest to H in Frobenius sense
+    rotations[i] = Rot3::ClosestTo(relaxed[i].transpose());
+  };
+#ifdef GTSAM_USE_TBB
+  tbb::parallel_for(size_t(0), keys.size(), project);
+#else
+  for (size_t i = 0; i < keys.size(); ++i) project(i);
+#endif
+
+  Values validRot3;
+  for (size_t i = 0; i < keys.size(); ++i) {
+    if (keys[i] != initialize::kAnchorKey) validRot3.insert(keys[i], rotations[i]);
+  }
+  return validRot3;
+}
+
 /* ************************************************************************* */
 // Transform VectorValues into valid Rot3
 Values InitializePose3::normalizeRelaxedRotations(
     const VectorValues& relaxedRot3) {
   gttic(InitializePose3_computeOrientationsChordal);
 
-  Values validRot3;
+  KeyVector keys;
+  std::vector<Matrix3> relaxed;
+  keys.reserve(relaxedRot3.size());
+  relaxed.reserve(relaxedRot3.size());
   for(const auto& it: relaxedRot3) {
-    Key key = it.first;
-    if (key != initialize::kAnchorKey) {
-      Matrix3 M;
-      M << Eigen::Map<const Matrix3>(it.second.data()); // Recover M from vectorized
+    keys.push_back(it.first);
+    // Recover M from vectorized
+    relaxed.push_back(Eigen::Map<const Matrix3>(it.second.data()));
+  }
+  return closestRotations(keys, relaxed);
+}
 
-      // ClosestTo finds rotation matrix closest to H in Frobenius sense
-      Rot3 initRot = Rot3::ClosestTo(M.transpose());
-      validRot3.insert(key, initRot);
-    }
+/* ************************************************************************* */
+// The 9x9 blocks of the chordal relaxation are three copies of the same 3x3
+// rotation, so the three columns of the relaxed rotations decouple: they solve
+// one sparse 3n x 3n system with three right-hand sides, which is assembled
+// here directly as normal equations and factorized with a sparse Cholesky.
+// Returns false if the graph has anything but BetweenFactor<Pose3>, or if the
+// system is singular, leaving the generic path to handle or report it.
+static bool solveChordalRelaxation(const NonlinearFactorGraph& pose3Graph,
+                                   KeyVector* keys,
+                                   std::vector<Matrix3>* relaxed) {
+  struct Edge {
+    size_t i, j;
+    Matrix3 Rij;
+    double precision;
+  };
+  std::vector<Edge> edges;
+  edges.reserve(pose3Graph.size());
+  FastMap<Key, size_t> ids;
+  keys->clear();
+  const auto id = [&](Key key) {
+    const auto it = ids.emplace(key, keys->size());
+    if (it.second) keys->push_back(key);
+    return it.first->second;
+  };
+  id(initialize::kAnchorKey);
+  for (const auto& factor : pose3Graph) {
+    auto pose3Between = std::dynamic_pointer_cast<BetweenFactor<Pose3> >(factor);
+    if (!pose3Between) return false;
+    // same precision as in buildLinearOrientationGraph
+    Vector precisions = Vector::Zero(6);
+    precisions[0] = 1.0;
+    pose3Between->noiseModel()->whitenInPlace(precisions);
+    edges.push_back({id(pose3Between->key1()), id(pose3Between->key2()),
+                     pose3Between->measured().rotation().matrix(),
+                     precisions[0]});
   }
-  return validRot3;
+
+  // Lower triangle of the Hessian: one off-diagonal block per edge, written in
+  // parallel, and diagonal blocks accumulated per variable.
+  const size_t n = keys->size();
+  typedef Eigen::Triplet<double> Triplet;
+  std::vector<Triplet> triplets(9 * edges.size());
+  const auto offDiagonal = [&](size_t e) {
+    const Edge& edge = edges[e];
+    // block (i, j) is -p Rij, store it or its transpose below the diagonal
+    const bool lower = edge.i > edge.j;
+    for (size_t r = 0; r < 3; ++r)
+      for (size_t c = 0; c < 3; ++c) {
+        const size_t row = lower ? 3 * edge.i + r : 3 * edge.j + c;
+        const size_t col = lower ? 3 * edge.j + c : 3 * edge.i + r;
+        triplets[9 * e + 3 * r + c] =
+            Triplet(row, col, -edge.precision * edge.Rij(r, c));
+      }
+  };
+#ifdef GTSAM_USE_TBB
+  tbb::parallel_for(size_t(0), edges.size(), offDiagonal);
+#else
+  for (size_t e = 0; e < edges.size(); ++e) offDiagonal(e);
+#endif
+
+  std::vector<Matrix3> diagonal(n, Z_3x3);
+  diagonal[0] = I_3x3;  // prior on the anchor orientation
+  for (const Edge& edge : edges) {
+    diagonal[edge.i] += edge.precision * I_3x3;
+    diagonal[edge.j] += edge.precision * edge.Rij.transpose() * edge.Rij;
+  }
+  for (size_t k = 0; k < n; ++k)
+    for (size_t c = 0; c < 3; ++c)
+      for (size_t r = c; r < 3; ++r)
+        triplets.emplace_back(3 * k + r, 3 * k + c, diagonal[k](r, c));
+
+  Eigen::SparseMatrix<double> H(3 * n, 3 * n);
+  H.setFromTriplets(triplets.begin(), triplets.end());
+  triplets = std::vector<Triplet>();
+
+  // The prior pulls the anchor to the identity, all other rows are zero
+  Matrix B = Matrix::Zero(3 * n, 3);
+  B.topRows<3>() = I_3x3;
+
+  Eigen::SimplicialLDLT<Eigen::SparseMatrix<double>, Eigen::Lower> solver(H);
+  if (solver.info() != Eigen::Success) return false;
+  const Matrix X = solver.solve(B);
+  if (solver.info() != Eigen::Success || !X.allFinite()) return false;
+
+  relaxed->resize(n);
+  for (size_t k = 0; k < n; ++k) (*relaxed)[k] = X.block<3, 3>(3 * k, 0);
+  return true;
 }
 
 /* ************************************************************************* */
@@ -103,6 +220,11 @@ Values InitializePose3::computeOrientationsChordal(
     const NonlinearFactorGraph& pose3Graph) {
   gttic(InitializePose3_computeOrientationsChordal);
 
+  KeyVector keys;
+  std::vector<Matrix3> relaxed;
+  if (solveChordalRelaxation(pose3Graph, &keys, &relaxed))
+    return closestRotations(keys, relaxed);
+
   // regularize measurements and plug everything in a factor graph
   GaussianFactorGraph relaxedGraph = buildLinearOrientationGraph(pose3Graph);
 
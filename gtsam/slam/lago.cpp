@@ -26,9 +26,14 @@
 #include <gtsam/base/timing.h>
 #include <gtsam/base/kruskal.h>
 
+#include <Eigen/Sparse>
+#include <Eigen/SparseCholesky>
+
 #include <iostream>
+#include <limits>
 #include <stack>
 #include <cmath>
+#include <unordered_map>
 
 using namespace std;
 
@@ -138,9 +143,9 @@ void getSymbolicGraph(
 }
 
 /* ************************************************************************* */
-// Retrieve the deltaTheta and the corresponding noise model from a BetweenFactor<Pose2>
-static void getDeltaThetaAndNoise(NonlinearFactor::shared_ptr factor,
-    Vector& deltaTheta, noiseModel::Diagonal::shared_ptr& model_deltaTheta) {
+// Retrieve the deltaTheta and its standard deviation from a BetweenFactor<Pose2>
+static void getDeltaThetaAndSigma(const NonlinearFactor::shared_ptr& factor,
+    double& deltaTheta, double& sigma) {
 
   // Get the relative rotation measurement from the between factor
   std::shared_ptr<BetweenFactor<Pose2> > pose2Between =
@@ -148,7 +153,7 @@ static void getDeltaThetaAndNoise(NonlinearFactor::shared_ptr factor,
   if (!pose2Between)
     throw invalid_argument(
         "buildLinearOrientationGraph: invalid between factor!");
-  deltaTheta = (Vector(1) << pose2Between->measured().theta()).finished();
+  deltaTheta = pose2Between->measured().theta();
 
   // Retrieve the noise model for the relative rotation
   SharedNoiseModel model = pose2Between->noiseModel();
@@ -157,47 +162,124 @@ static void getDeltaThetaAndNoise(NonlinearFactor::shared_ptr factor,
   if (!diagonalModel)
     throw invalid_argument("buildLinearOrientationGraph: invalid noise model "
         "(current version assumes diagonal noise model)!");
-  Vector std_deltaTheta = (Vector(1) << diagonalModel->sigma(2)).finished(); // std on the angular measurement
-  model_deltaTheta = noiseModel::Diagonal::Sigmas(std_deltaTheta);
+  sigma = diagonalModel->sigma(2); // std on the angular measurement
 }
 
 /* ************************************************************************* */
-GaussianFactorGraph buildLinearOrientationGraph(
+// A relative orientation measurement, regularized along the cycle it closes
+// with the spanning tree if it is a chord
+struct OrientationMeasurement {
+  Key key1, key2;
+  double deltaTheta, sigma;
+};
+
+/* ************************************************************************* */
+static vector<OrientationMeasurement> regularizedMeasurements(
     const vector<size_t>& spanningTreeIds, const vector<size_t>& chordsIds,
-    const NonlinearFactorGraph& g, const key2doubleMap& orientationsToRoot,
-    const PredecessorMap& tree) {
+    const NonlinearFactorGraph& g, const key2doubleMap& orientationsToRoot) {
 
-  GaussianFactorGraph lagoGraph;
-  Vector deltaTheta;
-  noiseModel::Diagonal::shared_ptr model_deltaTheta;
+  vector<OrientationMeasurement> measurements;
+  measurements.reserve(spanningTreeIds.size() + chordsIds.size());
+  double deltaTheta, sigma;
 
   // put original measurements in the spanning tree
   for(const size_t& factorId: spanningTreeIds) {
     const KeyVector& keys = g[factorId]->keys();
-    Key key1 = keys[0], key2 = keys[1];
-    getDeltaThetaAndNoise(g[factorId], deltaTheta, model_deltaTheta);
-    lagoGraph.add(key1, -I, key2, I, deltaTheta, model_deltaTheta);
+    getDeltaThetaAndSigma(g[factorId], deltaTheta, sigma);
+    measurements.push_back({keys[0], keys[1], deltaTheta, sigma});
   }
   // put regularized measurements in the chords
   for(const size_t& factorId: chordsIds) {
     const KeyVector& keys = g[factorId]->keys();
     Key key1 = keys[0], key2 = keys[1];
-    getDeltaThetaAndNoise(g[factorId], deltaTheta, model_deltaTheta);
-    double key1_DeltaTheta_key2 = deltaTheta(0);
+    getDeltaThetaAndSigma(g[factorId], deltaTheta, sigma);
+    double key1_DeltaTheta_key2 = deltaTheta;
     ///cout << "REG: key1= " << DefaultKeyFormatter(key1) << " key2= " << DefaultKeyFormatter(key2) << endl;
     double k2pi_noise = key1_DeltaTheta_key2 + orientationsToRoot.at(key1)
         - orientationsToRoot.at(key2); // this coincides to summing up measurements along the cycle induced by the chord
     double k = std::round(k2pi_noise / (2 * M_PI));
     //if (k2pi_noise - 2*k*M_PI > 1e-5) cout << k2pi_noise - 2*k*M_PI << endl; // for debug
-    Vector deltaThetaRegularized = (Vector(1)
-        << key1_DeltaTheta_key2 - 2 * k * M_PI).finished();
-    lagoGraph.add(key1, -I, key2, I, deltaThetaRegularized, model_deltaTheta);
+    measurements.push_back(
+        {key1, key2, key1_DeltaTheta_key2 - 2 * k * M_PI, sigma});
+  }
+  return measurements;
+}
+
+/* ************************************************************************* */
+GaussianFactorGraph buildLinearOrientationGraph(
+    const vector<size_t>& spanningTreeIds, const vector<size_t>& chordsIds,
+    const NonlinearFactorGraph& g, const key2doubleMap& orientationsToRoot,
+    const PredecessorMap& tree) {
+
+  GaussianFactorGraph lagoGraph;
+  for (const OrientationMeasurement& m : regularizedMeasurements(
+           spanningTreeIds, chordsIds, g, orientationsToRoot)) {
+    lagoGraph.add(m.key1, -I, m.key2, I, Vector1(m.deltaTheta),
+                  noiseModel::Diagonal::Sigmas(Vector1(m.sigma)));
   }
   // prior on the anchor orientation
   lagoGraph.add(kAnchorKey, I, (Vector(1) << 0.0).finished(), priorOrientationNoise);
   return lagoGraph;
 }
 
+/* ************************************************************************* */
+/**
+ * The orientation problem is a weighted graph Laplacian, with the anchor fixed
+ * at zero by a hard prior. Its normal equations are assembled and factorized
+ * here with a sparse Cholesky, rather than eliminating a factor graph of
+ * scalars. Returns an empty VectorValues if a measurement is itself a hard
+ * constraint or the system is singular.
+ */
+static VectorValues solveOrientations(
+    const vector<OrientationMeasurement>& measurements) {
+  FastMap<Key, size_t> ids;
+  KeyVector keys;
+  const size_t anchor = std::numeric_limits<size_t>::max();
+  const auto id = [&](Key key) {
+    if (key == kAnchorKey) return anchor;
+    const auto it = ids.emplace(key, keys.size());
+    if (it.second) keys.push_back(key);
+    return it.first->second;
+  };
+
+  typedef Eigen::Triplet<double> Triplet;
+  vector<Triplet> triplets;
+  triplets.reserve(3 * measurements.size());
+  vector<double> rhs;
+  for (const OrientationMeasurement& m : measurements) {
+    if (!(m.sigma > 0.0)) return VectorValues();
+    const double w = 1.0 / (m.sigma * m.sigma);
+    // residual theta2 - theta1 - deltaTheta
+    const size_t i = id(m.key1), j = id(m.key2);
+    rhs.resize(keys.size(), 0.0);
+    if (i != anchor) {
+      triplets.emplace_back(i, i, w);
+      rhs[i] -= w * m.deltaTheta;
+    }
+    if (j != anchor) {
+      triplets.emplace_back(j, j, w);
+      rhs[j] += w * m.deltaTheta;
+    }
+    if (i != anchor && j != anchor)
+      triplets.emplace_back(std::max(i, j), std::min(i, j), -w);
+  }
+
+  const size_t n = keys.size();
+  Eigen::SparseMatrix<double> L(n, n);
+  L.setFromTriplets(triplets.begin(), triplets.end());
+  Eigen::SimplicialLDLT<Eigen::SparseMatrix<double>, Eigen::Lower> solver(L);
+  if (solver.info() != Eigen::Success) return VectorValues();
+  const Vector theta = solver.solve(Eigen::Map<const Vector>(rhs.data(), n));
+  if (solver.info() != Eigen::Success || !theta.allFinite())
+    return VectorValues();
+
+  VectorValues orientations;
+  orientations.emplace(kAnchorKey, Vector1(0.0));
+  for (size_t k = 0; k < n; ++k)
+    orientations.emplace(keys[k], Vector1(theta(k)));
+  return orientations;
+}
+
 /* ************************************************************************* */
 static PredecessorMap findOdometricPath(
     const NonlinearFactorGraph& pose2Graph) {
@@ -236,23 +318,25 @@ PredecessorMap findMinimumSpanningTree(
   // Create a PredecessorMap 'predecessorMap' such that:
   // predecessorMap[key2] = key1, where key1 is the 'parent' node for key2 in
   // the spanning tree
+  // Adjacency lists of the tree, so the traversal is linear in its size
+  std::unordered_map<Key, KeyVector> adjacency;
+  for (const auto& edgeIdx : mstEdgeIndices) {
+    const auto v = pose2Graph[edgeIdx]->front();
+    const auto w = pose2Graph[edgeIdx]->back();
+    adjacency[v].push_back(w);
+    adjacency[w].push_back(v);
+  }
+
   PredecessorMap predecessorMap;
-  std::map<Key, bool> visitationMap;
   std::stack<std::pair<Key, Key>> stack;
 
   stack.push({kAnchorKey, kAnchorKey});
   while (!stack.empty()) {
     auto [u, parent] = stack.top();
     stack.pop();
-    if (visitationMap[u]) continue;
-    visitationMap[u] = true;
-    predecessorMap[u] = parent;
-    for (const auto& edgeIdx : mstEdgeIndices) {
-      const auto v = pose2Graph[edgeIdx]->front();
-      const auto w = pose2Graph[edgeIdx]->back();
-      if ((v == u || w == u) && !visitationMap[v == u ? w : v]) {
-        stack.push({v == u ? w : v, u});
-      }
+    if (!predecessorMap.emplace(u, parent).second) continue;
+    for (const Key v : adjacency[u]) {
+      if (!predecessorMap.count(v)) stack.push({v, u});
     }
   }
 
@@ -283,14 +367,16 @@ static VectorValues computeOrientations(const NonlinearFactorGraph& pose2Graph,
   // temporary structure to correct wraparounds along loops
   key2doubleMap orientationsToRoot = computeThetasToRoot(deltaThetaMap, tree);
 
-  // regularize measurements and plug everything in a factor graph
+  // regularize measurements and solve the sparse linear system directly
+  const vector<OrientationMeasurement> measurements = regularizedMeasurements(
+      spanningTreeIds, chordsIds, pose2Graph, orientationsToRoot);
+  VectorValues orientationsLago = solveOrientations(measurements);
+  if (orientationsLago.size() > 0) return orientationsLago;
+
+  // otherwise plug everything in a factor graph and solve the LFG
   GaussianFactorGraph lagoGraph = buildLinearOrientationGraph(
       spanningTreeIds, chordsIds, pose2Graph, orientationsToRoot, tree);
-
-  // Solve the LFG
-  VectorValues orientationsLago = lagoGraph.optimize();
-
-  return orientationsLago;
+  return lagoGraph.optimize();
 }
 
 /* ************************************************************************* */
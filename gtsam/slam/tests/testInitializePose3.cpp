@@ -275,6 +275,22 @@ TEST(InitializePose3, initializePoses) {
                       0.1));  // TODO(frank): very loose !!
 }
 
+/* ************************************************************************* */
+TEST(InitializePose3, orientationsChordalSparse) {
+  const string g2oFile = findExampleDataFile("pose3example-grid");
+  const auto [inputGraph, posesInFile] = readG2o(g2oFile, true);
+  inputGraph->addPrior(0, Pose3(), noiseModel::Unit::Create(6));
+  const NonlinearFactorGraph pose3Graph =
+      InitializePose3::buildPose3graph(*inputGraph);
+
+  // The sparse path has to agree with eliminating the linear graph
+  const Values expected = InitializePose3::normalizeRelaxedRotations(
+      InitializePose3::buildLinearOrientationGraph(pose3Graph).optimize());
+  const Values actual = InitializePose3::computeOrientationsChordal(pose3Graph);
+  EXPECT_LONGS_EQUAL(posesInFile->size(), actual.size());
+  EXPECT(assert_equal(expected, actual, 1e-9));
+}
+
 /* ************************************************************************* */
 int main() {
   TestResult tr;
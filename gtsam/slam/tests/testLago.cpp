@@ -318,6 +318,34 @@ TEST( Lago, largeGraphNoisy_orientations ) {
   }
 }
 
+/* *************************************************************************** */
+TEST( Lago, sparseOrientations ) {
+
+  string inputFile = findExampleDataFile("noisyToyGraph");
+  const auto [g, initial] = readG2o(inputFile);
+  NonlinearFactorGraph graphWithPrior = *g;
+  graphWithPrior.addPrior(0, Pose2(),
+      noiseModel::Diagonal::Variances(Vector3(1e-2, 1e-2, 1e-4)));
+
+  // Eliminate the linear orientation graph, as the sparse path must agree
+  NonlinearFactorGraph pose2Graph =
+      initialize::buildPoseGraph<Pose2>(graphWithPrior);
+  lago::PredecessorMap tree = lago::findMinimumSpanningTree(pose2Graph);
+  vector<size_t> spanningTreeIds, chordsIds;
+  lago::key2doubleMap deltaThetaMap;
+  lago::getSymbolicGraph(spanningTreeIds, chordsIds, deltaThetaMap, tree,
+                         pose2Graph);
+  lago::key2doubleMap orientationsToRoot =
+      lago::computeThetasToRoot(deltaThetaMap, tree);
+  VectorValues expected =
+      lago::buildLinearOrientationGraph(spanningTreeIds, chordsIds, pose2Graph,
+                                        orientationsToRoot, tree)
+          .optimize();
+
+  VectorValues actual = lago::initializeOrientations(graphWithPrior, false);
+  EXPECT(assert_equal(expected, actual, 1e-9));
+}
+
 /* *************************************************************************** */
 TEST( Lago, largeGraphNoisy ) {
 
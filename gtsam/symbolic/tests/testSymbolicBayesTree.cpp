@@ -25,6 +25,7 @@
 #include <CppUnitLite/TestHarness.h>
 #include <gtsam/base/TestableAssertions.h>
 #include <iterator>
+#include <thread>
 #include <type_traits>
 
 using namespace std;
@@ -243,6 +244,38 @@ TEST(BayesTree, shortcutCheck) {
   //  }
 }
 
+/* ************************************************************************* */
+TEST(BayesTree, computeSeparatorMarginals) {
+  const Key _A_ = 6, _B_ = 5, _C_ = 4, _D_ = 3, _E_ = 2, _F_ = 1, _G_ = 0;
+  auto chain = SymbolicFactorGraph(SymbolicFactor(_A_))  //
+      (SymbolicFactor(_B_, _A_))                         //
+      (SymbolicFactor(_C_, _A_))                         //
+      (SymbolicFactor(_D_, _C_))                         //
+      (SymbolicFactor(_E_, _B_))                         //
+      (SymbolicFactor(_F_, _E_))                         //
+      (SymbolicFactor(_G_, _F_));
+  Ordering ordering{_G_, _F_, _E_, _D_, _C_, _B_, _A_};
+  SymbolicBayesTree bayesTree = *chain.eliminateMultifrontal(ordering);
+  const SymbolicBayesTree expected = *chain.eliminateMultifrontal(ordering);
+
+  // All cliques have a cached separator marginal afterwards
+  bayesTree.computeSeparatorMarginals();
+  SymbolicBayesTree::Cliques allCliques;
+  getAllCliques(bayesTree.roots().front(), allCliques);
+  EXPECT_LONGS_EQUAL(allCliques.size(), bayesTree.numCachedSeparatorMarginals());
+
+  // Concurrent queries only read the cache and agree with on-demand marginals
+  const KeyVector keys{_A_, _B_, _C_, _D_, _E_, _F_, _G_};
+  std::vector<SymbolicConditional::shared_ptr> marginals(keys.size());
+  std::vector<std::thread> threads;
+  for (size_t i = 0; i < keys.size(); ++i)
+    threads.emplace_back(
+        [&, i] { marginals[i] = bayesTree.marginalFactor(keys[i]); });
+  for (std::thread& thread : threads) thread.join();
+  for (size_t i = 0; i < keys.size(); ++i)
+    EXPECT(assert_equal(*expected.marginalFactor(keys[i]), *marginals[i]));
+}
+
 /* ************************************************************************* */
 TEST(BayesTree, removeTop) {
   SymbolicBayesTree bayesTree = asiaBayesTree;
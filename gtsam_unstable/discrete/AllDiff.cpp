@@ -18,6 +18,13 @@ AllDiff::AllDiff(const DiscreteKeys& dkeys) : Constraint(dkeys.indices()) {
   for (const DiscreteKey& dkey : dkeys) cardinalities_.insert(dkey);
 }
 
+/* ************************************************************************* */
+DiscreteKeys AllDiff::discreteKeys() const {
+  DiscreteKeys dkeys;
+  for (size_t i = 0; i < keys_.size(); i++) dkeys.push_back(discreteKey(i));
+  return dkeys;
+}
+
 /* ************************************************************************* */
 void AllDiff::print(const std::string& s, const KeyFormatter& formatter) const {
   std::cout << s << "AllDiff on ";
@@ -60,14 +67,19 @@ DecisionTreeFactor AllDiff::operator*(const DecisionTreeFactor& f) const {
 bool AllDiff::ensureArcConsistency(Key j, Domains* domains) const {
   Domain& Dj = domains->at(j);
 
-  // Though strictly not part of allDiff, we check for
-  // a value in domains->at(j) that does not occur in any other connected domain.
-  // If found, we make this a singleton...
-  // TODO: make a new constraint where this really is true
-  std::optional<Domain> maybeChanged = Dj.checkAllDiff(keys_, *domains);
-  if (maybeChanged) {
-    Dj = *maybeChanged;
-    return true;
+  // If the keys have to take on a permutation of all values, as in Sudoku, a
+  // value in domains->at(j) that does not occur in any other connected domain
+  // has to be taken by j, and we make this a singleton. Otherwise this would
+  // wrongly exclude valid assignments that leave that value unused.
+  bool isPermutation = true;
+  for (const auto& key_cardinality : cardinalities_)
+    if (key_cardinality.second != keys_.size()) isPermutation = false;
+  if (isPermutation) {
+    std::optional<Domain> maybeChanged = Dj.checkAllDiff(keys_, *domains);
+    if (maybeChanged) {
+      Dj = *maybeChanged;
+      return true;
+    }
   }
 
   // Check all other domains for singletons and erase corresponding values.
@@ -84,6 +96,7 @@ bool AllDiff::ensureArcConsistency(Key j, Domains* domains) const {
         }
       }
     }
+  if (Dj.nrValues() == 0) throw UnsatisfiableException();
   return changed;
 }
 
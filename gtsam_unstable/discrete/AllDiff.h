@@ -28,6 +28,9 @@ class GTSAM_UNSTABLE_EXPORT AllDiff : public Constraint {
   /// Construct from keys.
   AllDiff(const DiscreteKeys& dkeys);
 
+  /// Return the keys with their cardinalities
+  DiscreteKeys discreteKeys() const override;
+
   // print
   void print(const std::string& s = "", const KeyFormatter& formatter =
                                             DefaultKeyFormatter) const override;
@@ -27,6 +27,12 @@ class BinaryAllDiff : public Constraint {
         cardinality0_(key1.second),
         cardinality1_(key2.second) {}
 
+  /// Return the two keys with their cardinalities
+  DiscreteKeys discreteKeys() const override {
+    return {DiscreteKey(keys_[0], cardinality0_),
+            DiscreteKey(keys_[1], cardinality1_)};
+  }
+
   // print
   void print(
       const std::string& s = "",
@@ -70,26 +76,57 @@ class BinaryAllDiff : public Constraint {
   }
 
   /*
-   * Ensure Arc-consistency by checking every possible value of domain j.
+   * Ensure Arc-consistency: if the other domain is a singleton, its value is
+   * erased from domain j.
    * @param j domain to be checked
    * @param (in/out) domains all domains, but only domains->at(j) will be checked.
    * @return true if domains->at(j) was changed, false otherwise.
    */
   bool ensureArcConsistency(Key j, Domains* domains) const override {
-    throw std::runtime_error(
-        "BinaryAllDiff::ensureArcConsistency not implemented");
-    return false;
+    if (j != keys_[0] && j != keys_[1])
+      throw std::invalid_argument("BinaryAllDiff check on wrong domain");
+    const Domain& Dk = domains->at(j == keys_[0] ? keys_[1] : keys_[0]);
+    if (!Dk.isSingleton()) return false;
+    Domain& Dj = domains->at(j);
+    const size_t value = Dk.firstValue();
+    if (!Dj.contains(value)) return false;
+    Dj.erase(value);
+    if (Dj.nrValues() == 0) throw UnsatisfiableException();
+    return true;
   }
 
   /// Partially apply known values
-  Constraint::shared_ptr partiallyApply(const DiscreteValues&) const override {
-    throw std::runtime_error("BinaryAllDiff::partiallyApply not implemented");
+  Constraint::shared_ptr partiallyApply(
+      const DiscreteValues& values) const override {
+    const auto it0 = values.find(keys_[0]), it1 = values.find(keys_[1]);
+    if (it0 == values.end() && it1 == values.end())
+      return std::make_shared<BinaryAllDiff>(*this);
+    if (it0 != values.end() && it1 != values.end()) {
+      if (it0->second == it1->second)
+        throw UnsatisfiableException(
+            "BinaryAllDiff::partiallyApply: unsatisfiable");
+      return std::make_shared<Domain>(DiscreteKey(keys_[0], cardinality0_),
+                                      it0->second);
+    }
+    // Exactly one value is known: the other variable cannot take it on
+    const bool known0 = it0 != values.end();
+    const size_t value = known0 ? it0->second : it1->second;
+    auto domain = std::make_shared<Domain>(
+        known0 ? DiscreteKey(keys_[1], cardinality1_)
+               : DiscreteKey(keys_[0], cardinality0_));
+    if (value < domain->cardinality()) domain->erase(value);
+    return domain;
   }
 
   /// Partially apply known values, domain version
   Constraint::shared_ptr partiallyApply(
-      const Domains&) const override {
-    throw std::runtime_error("BinaryAllDiff::partiallyApply not implemented");
+      const Domains& domains) const override {
+    DiscreteValues known;
+    for (Key k : keys_) {
+      const Domain& Dk = domains.at(k);
+      if (Dk.isSingleton()) known[k] = Dk.firstValue();
+    }
+    return partiallyApply(known);
   }
 };
 
@@ -6,14 +6,308 @@
  */
 
 #include <gtsam/base/Testable.h>
+#include <gtsam/config.h>  // for GTSAM_USE_TBB
 #include <gtsam/discrete/DiscreteBayesNet.h>
 #include <gtsam_unstable/discrete/CSP.h>
 #include <gtsam_unstable/discrete/Domain.h>
 
+#ifdef GTSAM_USE_TBB
+#include <tbb/parallel_for.h>
+#endif
+
+#include <atomic>
+#include <deque>
+#include <random>
+
 using namespace std;
 
 namespace gtsam {
 
+namespace {
+
+/* ************************************************************************* */
+// Keys with cardinalities of a factor in a CSP
+DiscreteKeys discreteKeysOf(const DiscreteFactor& factor) {
+  if (auto constraint = dynamic_cast<const Constraint*>(&factor))
+    return constraint->discreteKeys();
+  if (auto decisionTree = dynamic_cast<const DecisionTreeFactor*>(&factor))
+    return decisionTree->discreteKeys();
+  throw invalid_argument("CSP: factor is neither a constraint nor a table");
+}
+
+/* ************************************************************************* */
+/*
+ * AC-3 propagation over the factors of a CSP. For the variables of factors
+ * that are not constraints, the last support found for every value is kept,
+ * so a revision only searches anew when that support was removed, as in
+ * AC-2001. Since these residues are mutable, every search has its own.
+ */
+class Propagator {
+ public:
+  Propagator(const CSP& csp, size_t maxTableEnumeration)
+      : csp_(csp),
+        maxTableEnumeration_(maxTableEnumeration),
+        index_(csp),
+        constraints_(csp.size()),
+        keys_(csp.size()),
+        residues_(csp.size()) {
+    for (size_t f = 0; f < csp.size(); ++f) {
+      if (!csp[f]) continue;
+      constraints_[f] = std::dynamic_pointer_cast<Constraint>(csp[f]);
+      keys_[f] = discreteKeysOf(*csp[f]);
+      residues_[f].resize(keys_[f].size());
+    }
+  }
+
+  /// Number of factors a variable is involved in
+  size_t degree(Key j) const { return index_[j].size(); }
+
+  /// Propagate after the domain of key changed, or all factors if none given
+  bool propagate(Domains* domains, std::optional<Key> changed = {}) {
+    for (const auto& key_domain : *domains)
+      if (key_domain.second.nrValues() == 0) return false;
+
+    deque<size_t> queue;
+    vector<bool> queued(csp_.size(), false);
+    const auto enqueue = [&](size_t f) {
+      if (!queued[f]) {
+        queued[f] = true;
+        queue.push_back(f);
+      }
+    };
+    if (changed) {
+      for (size_t f : index_[*changed]) enqueue(f);
+    } else {
+      for (size_t f = 0; f < csp_.size(); ++f)
+        if (csp_[f]) enqueue(f);
+    }
+
+    while (!queue.empty()) {
+      const size_t f = queue.front();
+      queue.pop_front();
+      queued[f] = false;
+      for (size_t i = 0; i < keys_[f].size(); ++i) {
+        const Key j = keys_[f][i].first;
+        const size_t before = domains->at(j).nrValues();
+        try {
+          if (constraints_[f])
+            constraints_[f]->ensureArcConsistency(j, domains);
+          else
+            revise(f, i, domains);
+        } catch (const UnsatisfiableException&) {
+          return false;  // constraint wiped out the domain
+        }
+        const size_t after = domains->at(j).nrValues();
+        if (after == 0) return false;
+        // We do not trust the returned flag, but check the domain shrunk
+        if (after < before)
+          for (size_t g : index_[j]) enqueue(g);
+      }
+    }
+    return true;
+  }
+
+ private:
+  // Erase the values of variable i of table factor f without support
+  void revise(size_t f, size_t i, Domains* domains) {
+    const DiscreteKeys& dkeys = keys_[f];
+    const size_t n = dkeys.size();
+    vector<const Domain*> D(n);
+    size_t count = 1;
+    for (size_t k = 0; k < n; ++k) {
+      D[k] = &domains->at(dkeys[k].first);
+      if (k != i) count *= D[k]->nrValues();
+      if (count > maxTableEnumeration_) return;  // too expensive, skip
+    }
+
+    vector<vector<size_t>>& residues = residues_[f][i];
+    if (residues.empty()) residues.resize(dkeys[i].second);
+    const auto supports = [&](const vector<size_t>& assignment) {
+      for (size_t k = 0; k < n; ++k)
+        if (!D[k]->contains(assignment[k])) return false;
+      return true;
+    };
+
+    Domain& Di = domains->at(dkeys[i].first);
+    DiscreteValues values;
+    vector<size_t> assignment(n);
+    for (size_t v = Di.firstValue(); v < Di.cardinality();
+         v = Di.nextValue(v + 1)) {
+      vector<size_t>& residue = residues[v];
+      if (!residue.empty() && supports(residue)) continue;
+
+      // Enumerate the joint values of the other variables in their domains
+      for (size_t k = 0; k < n; ++k)
+        assignment[k] = (k == i) ? v : D[k]->firstValue();
+      bool supported = false;
+      while (true) {
+        for (size_t k = 0; k < n; ++k) values[dkeys[k].first] = assignment[k];
+        if ((*csp_[f])(values) > 0) {
+          residue = assignment;
+          supported = true;
+          break;
+        }
+        size_t k = 0;
+        for (; k < n; ++k) {
+          if (k == i) continue;
+          assignment[k] = D[k]->nextValue(assignment[k] + 1);
+          if (assignment[k] < D[k]->cardinality()) break;
+          assignment[k] = D[k]->firstValue();
+        }
+        if (k == n) break;
+      }
+      if (!supported) Di.erase(v);
+    }
+  }
+
+  const CSP& csp_;
+  size_t maxTableEnumeration_;
+  VariableIndex index_;
+  vector<Constraint::shared_ptr> constraints_;  // null if not a constraint
+  vector<DiscreteKeys> keys_;
+  // residues_[f][i][v]: assignment of factor f supporting value v of key i
+  vector<vector<vector<vector<size_t>>>> residues_;
+};
+
+/* ************************************************************************* */
+/*
+ * Backtracking search maintaining arc consistency, branching on x == v versus
+ * x != v. Picks the variable with the smallest domain, then the one in most
+ * factors. Search 0 breaks remaining ties by key and tries the smallest value
+ * first, the others break ties and pick values at random.
+ */
+std::optional<DiscreteValues> search(const CSP& csp, Domains domains,
+                                     const CSPSearchParams& params,
+                                     size_t worker, const atomic<bool>& stop,
+                                     bool* exhausted) {
+  Propagator propagator(csp, params.maxTableEnumeration);
+  std::mt19937_64 rng(params.seed + worker);
+
+  const auto selectVariable = [&](Key* key) {
+    size_t bestSize = 0, bestDegree = 0, nrTies = 0;
+    for (const auto& key_domain : domains) {
+      const size_t size = key_domain.second.nrValues();
+      if (size < 2) continue;
+      const size_t degree = propagator.degree(key_domain.first);
+      if (bestSize == 0 || size < bestSize ||
+          (size == bestSize && degree > bestDegree)) {
+        bestSize = size;
+        bestDegree = degree;
+        nrTies = 1;
+        *key = key_domain.first;
+      } else if (size == bestSize && degree == bestDegree && worker > 0 &&
+                 rng() % ++nrTies == 0) {
+        *key = key_domain.first;
+      }
+    }
+    return bestSize > 0;
+  };
+
+  const auto selectValue = [&](const Domain& D) {
+    size_t value = D.firstValue();
+    if (worker > 0)
+      for (size_t r = rng() % D.nrValues(); r > 0; --r)
+        value = D.nextValue(value + 1);
+    return value;
+  };
+
+  struct Decision {
+    Domains saved;
+    Key key;
+    size_t value;
+  };
+  vector<Decision> trail;
+  size_t nrBacktracks = 0;
+
+  bool consistent = propagator.propagate(&domains);
+  while (!stop) {
+    if (consistent) {
+      Key key = 0;
+      if (selectVariable(&key)) {
+        Domain& D = domains.at(key);
+        const size_t value = selectValue(D);
+        trail.push_back({domains, key, value});
+        D = Domain(D.discreteKey(), value);
+        consistent = propagator.propagate(&domains, key);
+        continue;
+      }
+      // All domains are singletons: check, as tables may have been skipped
+      DiscreteValues values;
+      for (const auto& key_domain : domains)
+        values[key_domain.first] = key_domain.second.firstValue();
+      if (csp(values) > 0) return values;
+    }
+
+    // Conflict: undo the last decision x == v and continue with x != v
+    if (trail.empty()) {
+      *exhausted = true;
+      return {};
+    }
+    if (params.maxBacktracks > 0 && ++nrBacktracks > params.maxBacktracks)
+      return {};
+    const Key key = trail.back().key;
+    const size_t value = trail.back().value;
+    domains = std::move(trail.back().saved);
+    trail.pop_back();
+    domains.at(key).erase(value);
+    consistent = propagator.propagate(&domains, key);
+  }
+  return {};
+}
+
+}  // namespace
+
+/* ************************************************************************* */
+Domains CSP::domains() const {
+  Domains result;
+  for (const DiscreteFactor::shared_ptr& factor : factors_) {
+    if (!factor) continue;
+    for (const DiscreteKey& dkey : discreteKeysOf(*factor)) {
+      auto it = result.find(dkey.first);
+      if (it == result.end())
+        result.emplace(dkey.first, Domain(dkey));
+      else if (it->second.cardinality() != dkey.second)
+        throw invalid_argument("CSP::domains: inconsistent cardinalities");
+    }
+  }
+  return result;
+}
+
+/* ************************************************************************* */
+bool CSP::propagate(Domains* domains, size_t maxTableEnumeration) const {
+  return Propagator(*this, maxTableEnumeration).propagate(domains);
+}
+
+/* ************************************************************************* */
+std::optional<DiscreteValues> CSP::solve(const CSPSearchParams& params) const {
+  return solve(domains(), params);
+}
+
+/* ************************************************************************* */
+std::optional<DiscreteValues> CSP::solve(const Domains& domains,
+                                         const CSPSearchParams& params) const {
+  const size_t nrSearches = std::max<size_t>(params.nrPortfolio, 1);
+  vector<std::optional<DiscreteValues>> solutions(nrSearches);
+  atomic<bool> stop(false);
+  const auto run = [&](size_t worker) {
+    bool exhausted = false;
+    solutions[worker] =
+        search(*this, domains, params, worker, stop, &exhausted);
+    // Once one search succeeds or proves there is no solution, we are done
+    if (solutions[worker] || exhausted) stop = true;
+  };
+#ifdef GTSAM_USE_TBB
+  tbb::parallel_for(size_t(0), nrSearches, run);
+#else
+  for (size_t worker = 0; worker < nrSearches && !stop; ++worker) run(worker);
+#endif
+  for (const auto& solution : solutions)
+    if (solution) return solution;
+  return {};
+}
+
+/* ************************************************************************* */
+
 bool CSP::runArcConsistency(const VariableIndex& index,
                             Domains* domains) const {
   bool changed = false;
@@ -39,8 +333,8 @@ bool CSP::runArcConsistency(const VariableIndex& index,
   return changed;
 }
 
-// TODO(dellaert): This is AC1, which is inefficient as any change will cause
-// the algorithm to revisit *all* variables again. Implement AC3.
+// This is AC1, which is inefficient as any change will cause the algorithm to
+// revisit *all* variables again. See CSP::propagate for AC3.
 Domains CSP::runArcConsistency(size_t cardinality, size_t maxIterations) const {
   // Create VariableIndex
   VariableIndex index(*this);
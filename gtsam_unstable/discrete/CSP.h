@@ -11,8 +11,27 @@
 #include <gtsam_unstable/discrete/AllDiff.h>
 #include <gtsam_unstable/discrete/SingleValue.h>
 
+#include <optional>
+
 namespace gtsam {
 
+/// Parameters for CSP::solve, a backtracking search with arc consistency
+struct GTSAM_UNSTABLE_EXPORT CSPSearchParams {
+  /// Number of searches run in parallel, each with a different random variable
+  /// and value order. The first one is deterministic.
+  size_t nrPortfolio = 1;
+
+  /// Maximum number of backtracks per search, 0 means no limit
+  size_t maxBacktracks = 0;
+
+  /// Factors that are not constraints are revised by enumerating the joint
+  /// values of their other variables, if there are at most this many.
+  size_t maxTableEnumeration = 4096;
+
+  /// Seed for the randomized searches
+  size_t seed = 0;
+};
+
 /**
  * Constraint Satisfaction Problem class
  * A specialization of a DiscreteFactorGraph.
@@ -55,11 +74,41 @@ class GTSAM_UNSTABLE_EXPORT CSP : public DiscreteFactorGraph {
   //     */
   //     void applyBeliefPropagation(size_t maxIterations = 10) const;
 
+  /// Return the full domains of all variables, with their cardinalities
+  Domains domains() const;
+
+  /**
+   * Propagate with AC-3: every factor is revised until no domain changes,
+   * re-queueing the factors of a variable whenever its domain shrinks.
+   * Constraints are revised with their ensureArcConsistency method, other
+   * factors by searching a supporting assignment for each value, reusing the
+   * support found last time when it is still valid.
+   * @param (in/out) domains the domains of all variables
+   * @param maxTableEnumeration see CSPSearchParams
+   * @return false if a domain was wiped out, i.e., there is no solution.
+   */
+  bool propagate(Domains* domains, size_t maxTableEnumeration = 4096) const;
+
+  /**
+   * Find a satisfying assignment, i.e., one for which all factors are
+   * non-zero, by backtracking search that maintains arc consistency, without
+   * ever building a decision tree over more than one factor.
+   * @return the assignment, or nothing if there is no solution or the search
+   * gave up after params.maxBacktracks.
+   */
+  std::optional<DiscreteValues> solve(
+      const CSPSearchParams& params = CSPSearchParams()) const;
+
+  /// Find a satisfying assignment, starting from the given domains
+  std::optional<DiscreteValues> solve(
+      const Domains& domains,
+      const CSPSearchParams& params = CSPSearchParams()) const;
+
   /*
    * Apply arc-consistency ~ Approximate loopy belief propagation
    * We need to give the domains to a constraint, and it returns
    * a domain whose values don't conflict in the arc-consistency way.
-   * TODO: should get cardinality from DiscreteKeys
+   * See also propagate, which uses the actual cardinalities and runs AC-3.
    */
   Domains runArcConsistency(size_t cardinality,
                             size_t maxIterations = 10) const;
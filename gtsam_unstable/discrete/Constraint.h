@@ -18,16 +18,26 @@
 #pragma once
 
 #include <gtsam/discrete/DiscreteFactor.h>
+#include <gtsam/discrete/DiscreteKey.h>
 #include <gtsam/discrete/DiscreteValues.h>
 #include <gtsam_unstable/dllexport.h>
 
 #include <map>
+#include <stdexcept>
+#include <string>
 
 namespace gtsam {
 
 class Domain;
 using Domains = std::map<Key, Domain>;
 
+/// Thrown when a constraint removes every value from a domain
+class UnsatisfiableException : public std::runtime_error {
+ public:
+  explicit UnsatisfiableException(const std::string& what = "Unsatisfiable")
+      : std::runtime_error(what) {}
+};
+
 /**
  * Base class for constraint factors
  * Derived classes include SingleValue, BinaryAllDiff, and AllDiff.
@@ -65,11 +75,21 @@ class GTSAM_UNSTABLE_EXPORT Constraint : public DiscreteFactor {
   /// @name Standard Interface
   /// @{
 
+  /**
+   * Return the keys of the variables involved, with their cardinalities.
+   * Needed to use the constraint in a CSP search, the default throws.
+   */
+  virtual DiscreteKeys discreteKeys() const {
+    throw std::runtime_error(
+        "Constraint::discreteKeys: not implemented for this constraint");
+  }
+
   /*
    * Ensure Arc-consistency by checking every possible value of domain j.
    * @param j domain to be checked
    * @param (in/out) domains all domains, but only domains->at(j) will be checked.
    * @return true if domains->at(j) was changed, false otherwise.
+   * @throw UnsatisfiableException if domains->at(j) would become empty.
    */
   virtual bool ensureArcConsistency(Key j, Domains* domains) const = 0;
 
@@ -18,17 +18,51 @@ using namespace std;
 void Domain::print(const string& s, const KeyFormatter& formatter) const {
   cout << s << ": Domain on " << formatter(key()) << " (j=" << formatter(key())
        << ") with values";
-  for (size_t v : values_) cout << " " << v;
+  for (size_t v = firstValue(); v < cardinality_; v = nextValue(v + 1))
+    cout << " " << v;
   cout << endl;
 }
 
 /* ************************************************************************* */
 string Domain::base1Str() const {
   stringstream ss;
-  for (size_t v : values_) ss << v + 1;
+  for (size_t v = firstValue(); v < cardinality_; v = nextValue(v + 1))
+    ss << v + 1;
   return ss.str();
 }
 
+/* ************************************************************************* */
+size_t Domain::nextValue(size_t value) const {
+  for (size_t w = value / kWordSize; w < bits_.size(); ++w) {
+    uint64_t word = bits_[w];
+    if (w == value / kWordSize) word &= ~uint64_t(0) << (value % kWordSize);
+    if (!word) continue;
+    size_t v = w * kWordSize;
+    while (!(word & 1)) {
+      word >>= 1;
+      ++v;
+    }
+    return v;
+  }
+  return cardinality_;
+}
+
+/* ************************************************************************* */
+bool Domain::intersect(const Domain& other) {
+  if (other.cardinality_ != cardinality_)
+    throw invalid_argument("Domain::intersect: cardinality mismatch");
+  size_t nrValues = 0;
+  bool changed = false;
+  for (size_t w = 0; w < bits_.size(); ++w) {
+    const uint64_t word = bits_[w] & other.bits_[w];
+    changed = changed || (word != bits_[w]);
+    bits_[w] = word;
+    for (uint64_t rest = word; rest; rest &= rest - 1) ++nrValues;
+  }
+  nrValues_ = nrValues;
+  return changed;
+}
+
 /* ************************************************************************* */
 double Domain::operator()(const DiscreteValues& values) const {
   return contains(values.at(key()));
@@ -53,10 +87,9 @@ DecisionTreeFactor Domain::operator*(const DecisionTreeFactor& f) const {
 bool Domain::ensureArcConsistency(Key j, Domains* domains) const {
   if (j != key()) throw invalid_argument("Domain check on wrong domain");
   Domain& D = domains->at(j);
-  for (size_t value : values_)
-    if (!D.contains(value)) throw runtime_error("Unsatisfiable");
-  D = *this;
-  return true;
+  const bool changed = D.intersect(*this);
+  if (D.nrValues() == 0) throw UnsatisfiableException();
+  return changed;
 }
 
 /* ************************************************************************* */
@@ -64,7 +97,8 @@ std::optional<Domain> Domain::checkAllDiff(const KeyVector keys,
                                              const Domains& domains) const {
   Key j = key();
   // for all values in this domain
-  for (const size_t value : values_) {
+  for (size_t value = firstValue(); value < cardinality_;
+       value = nextValue(value + 1)) {
     // for all connected domains
     for (const Key k : keys)
       // if any domain contains the value we cannot make this domain singleton
@@ -80,15 +114,15 @@ std::optional<Domain> Domain::checkAllDiff(const KeyVector keys,
 Constraint::shared_ptr Domain::partiallyApply(const DiscreteValues& values) const {
   DiscreteValues::const_iterator it = values.find(key());
   if (it != values.end() && !contains(it->second))
-    throw runtime_error("Domain::partiallyApply: unsatisfiable");
+    throw UnsatisfiableException("Domain::partiallyApply: unsatisfiable");
   return std::make_shared<Domain>(*this);
 }
 
 /* ************************************************************************* */
 Constraint::shared_ptr Domain::partiallyApply(const Domains& domains) const {
   const Domain& Dk = domains.at(key());
-  if (Dk.isSingleton() && !contains(*Dk.begin()))
-    throw runtime_error("Domain::partiallyApply: unsatisfiable");
+  if (Dk.isSingleton() && !contains(Dk.firstValue()))
+    throw UnsatisfiableException("Domain::partiallyApply: unsatisfiable");
   return std::make_shared<Domain>(Dk);
 }
 
@@ -9,32 +9,43 @@
 
 #include <gtsam/discrete/DiscreteKey.h>
 #include <gtsam_unstable/discrete/Constraint.h>
+#include <cstdint>
 #include <optional>
+#include <stdexcept>
+#include <vector>
 
 namespace gtsam {
 
 /**
  * The Domain class represents a constraint that restricts the possible values a
- * particular variable, with given key, can take on.
+ * particular variable, with given key, can take on. The allowed values are
+ * stored as a bitset, so copying, testing and narrowing domains is cheap.
  */
 class GTSAM_UNSTABLE_EXPORT Domain : public Constraint {
-  size_t cardinality_;       /// Cardinality
-  std::set<size_t> values_;  /// allowed values
+  size_t cardinality_;          /// Cardinality
+  std::vector<uint64_t> bits_;  /// bitset of allowed values
+  size_t nrValues_ = 0;         /// number of allowed values
+
+  static constexpr size_t kWordSize = 64;
 
  public:
   typedef std::shared_ptr<Domain> shared_ptr;
 
   // Constructor on Discrete Key initializes an "all-allowed" domain
   Domain(const DiscreteKey& dkey)
-      : Constraint(dkey.first), cardinality_(dkey.second) {
-    for (size_t v = 0; v < cardinality_; v++) values_.insert(v);
+      : Constraint(dkey.first),
+        cardinality_(dkey.second),
+        bits_((dkey.second + kWordSize - 1) / kWordSize, 0) {
+    for (size_t v = 0; v < cardinality_; v++) insert(v);
   }
 
   // Constructor on Discrete Key with single allowed value
   // Consider SingleValue constraint
   Domain(const DiscreteKey& dkey, size_t v)
-      : Constraint(dkey.first), cardinality_(dkey.second) {
-    values_.insert(v);
+      : Constraint(dkey.first),
+        cardinality_(dkey.second),
+        bits_((dkey.second + kWordSize - 1) / kWordSize, 0) {
+    insert(v);
   }
 
   /// The one key
@@ -43,17 +54,42 @@ class GTSAM_UNSTABLE_EXPORT Domain : public Constraint {
   // The associated discrete key
   DiscreteKey discreteKey() const { return DiscreteKey(key(), cardinality_); }
 
+  /// Return the discrete key of this domain
+  DiscreteKeys discreteKeys() const override { return {discreteKey()}; }
+
+  /// Number of values the variable can take on, allowed or not
+  size_t cardinality() const { return cardinality_; }
+
   /// Insert a value, non const :-(
-  void insert(size_t value) { values_.insert(value); }
+  void insert(size_t value) {
+    if (value >= cardinality_) throw std::out_of_range("Domain::insert");
+    uint64_t& word = bits_[value / kWordSize];
+    const uint64_t bit = uint64_t(1) << (value % kWordSize);
+    if (!(word & bit)) {
+      word |= bit;
+      ++nrValues_;
+    }
+  }
 
   /// Erase a value, non const :-(
-  void erase(size_t value) { values_.erase(value); }
+  void erase(size_t value) {
+    if (!contains(value)) return;
+    bits_[value / kWordSize] &= ~(uint64_t(1) << (value % kWordSize));
+    --nrValues_;
+  }
+
+  /// Keep only the values also allowed by other, return true if any was erased
+  bool intersect(const Domain& other);
 
-  size_t nrValues() const { return values_.size(); }
+  size_t nrValues() const { return nrValues_; }
 
   bool isSingleton() const { return nrValues() == 1; }
 
-  size_t firstValue() const { return *values_.begin(); }
+  /// Smallest allowed value, or cardinality() if the domain is empty
+  size_t firstValue() const { return nextValue(0); }
+
+  /// Smallest allowed value >= value, or cardinality() if there is none
+  size_t nextValue(size_t value) const;
 
   // print
   void print(const std::string& s = "", const KeyFormatter& formatter =
@@ -65,7 +101,7 @@ class GTSAM_UNSTABLE_EXPORT Domain : public Constraint {
       return false;
     else {
       const Domain& f(static_cast<const Domain&>(other));
-      return (cardinality_ == f.cardinality_) && (values_ == f.values_);
+      return (cardinality_ == f.cardinality_) && (bits_ == f.bits_);
     }
   }
 
@@ -74,7 +110,10 @@ class GTSAM_UNSTABLE_EXPORT Domain : public Constraint {
   std::string base1Str() const;
 
   // Check whether domain cotains a specific value.
-  bool contains(size_t value) const { return values_.count(value) > 0; }
+  bool contains(size_t value) const {
+    return value < cardinality_ &&
+           (bits_[value / kWordSize] >> (value % kWordSize)) & 1;
+  }
 
   /// Calculate value
   double operator()(const DiscreteValues& values) const override;
@@ -86,7 +125,8 @@ class GTSAM_UNSTABLE_EXPORT Domain : public Constraint {
   DecisionTreeFactor operator*(const DecisionTreeFactor& f) const override;
 
   /*
-   * Ensure Arc-consistency by checking every possible value of domain j.
+   * Ensure Arc-consistency by removing the values not in this domain from
+   * domains->at(j).
    * @param j domain to be checked
    * @param (in/out) domains all domains, but only domains->at(j) will be
    * checked.
@@ -46,8 +46,8 @@ bool SingleValue::ensureArcConsistency(Key j, Domains* domains) const {
   if (j != keys_[0])
     throw invalid_argument("SingleValue check on wrong domain");
   Domain& D = domains->at(j);
+  if (!D.contains(value_)) throw UnsatisfiableException();
   if (D.isSingleton()) {
-    if (D.firstValue() != value_) throw runtime_error("Unsatisfiable");
     return false;
   }
   D = Domain(discreteKey(), value_);
@@ -58,7 +58,7 @@ bool SingleValue::ensureArcConsistency(Key j, Domains* domains) const {
 Constraint::shared_ptr SingleValue::partiallyApply(const DiscreteValues& values) const {
   DiscreteValues::const_iterator it = values.find(keys_[0]);
   if (it != values.end() && it->second != value_)
-    throw runtime_error("SingleValue::partiallyApply: unsatisfiable");
+    throw UnsatisfiableException("SingleValue::partiallyApply: unsatisfiable");
   return std::make_shared<SingleValue>(keys_[0], cardinality_, value_);
 }
 
@@ -67,7 +67,7 @@ Constraint::shared_ptr SingleValue::partiallyApply(
     const Domains& domains) const {
   const Domain& Dk = domains.at(keys_[0]);
   if (Dk.isSingleton() && !Dk.contains(value_))
-    throw runtime_error("SingleValue::partiallyApply: unsatisfiable");
+    throw UnsatisfiableException("SingleValue::partiallyApply: unsatisfiable");
   return std::make_shared<SingleValue>(discreteKey(), value_);
 }
 
@@ -35,6 +35,9 @@ class GTSAM_UNSTABLE_EXPORT SingleValue : public Constraint {
   SingleValue(const DiscreteKey& dkey, size_t value)
       : Constraint(dkey.first), cardinality_(dkey.second), value_(value) {}
 
+  /// Return the discrete key of the constrained variable
+  DiscreteKeys discreteKeys() const override { return {discreteKey()}; }
+
   // print
   void print(const std::string& s = "", const KeyFormatter& formatter =
                                             DefaultKeyFormatter) const override;
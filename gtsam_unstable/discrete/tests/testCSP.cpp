@@ -260,6 +260,147 @@ TEST(CSP, ArcConsistency) {
   // GTSAM_PRINT(csp);
 }
 
+/* ************************************************************************* */
+TEST(CSP, Propagate) {
+  // Create keys for Idaho, Arizona, and Utah, allowing three colors for each:
+  size_t nrColors = 3;
+  DiscreteKey ID(0, nrColors), AZ(1, nrColors), UT(2, nrColors);
+
+  CSP csp;
+  csp.addAllDiff(DiscreteKeys{ID, UT, AZ});
+  csp.addSingleValue(AZ, 2);
+
+  // Propagation removes the color of Arizona from the other domains
+  Domains domains = csp.domains();
+  LONGS_EQUAL(3, domains.size());
+  EXPECT(csp.propagate(&domains));
+  LONGS_EQUAL(2, domains.at(0).nrValues());
+  LONGS_EQUAL(1, domains.at(1).nrValues());
+  LONGS_EQUAL(2, domains.at(2).nrValues());
+
+  // A table factor that forbids Idaho to take color 0 fixes all colors
+  csp.add(ID, "0 1 1");
+  domains = csp.domains();
+  EXPECT(csp.propagate(&domains));
+  EXPECT(domains.at(0).isSingleton());
+  EXPECT(domains.at(2).isSingleton());
+  LONGS_EQUAL(1, domains.at(0).firstValue());
+  LONGS_EQUAL(0, domains.at(2).firstValue());
+
+  // Forbidding color 1 as well leaves no solution
+  csp.add(ID, "1 0 1");
+  domains = csp.domains();
+  EXPECT(!csp.propagate(&domains));
+}
+
+/* ************************************************************************* */
+TEST(CSP, Solve) {
+  // Color the Western US with 4 colors, as in the WesternUS test
+  size_t nrColors = 4;
+  DiscreteKey WA(0, nrColors), OR(3, nrColors), CA(1, nrColors),
+      NV(2, nrColors), ID(8, nrColors), UT(9, nrColors), AZ(10, nrColors),
+      MT(4, nrColors), WY(5, nrColors), CO(7, nrColors), NM(6, nrColors);
+  CSP csp;
+  const vector<pair<DiscreteKey, DiscreteKey>> borders{
+      {WA, ID}, {WA, OR}, {OR, ID}, {OR, CA}, {OR, NV}, {CA, NV},
+      {CA, AZ}, {ID, MT}, {ID, WY}, {ID, UT}, {ID, NV}, {NV, UT},
+      {NV, AZ}, {UT, WY}, {UT, CO}, {UT, NM}, {UT, AZ}, {AZ, CO},
+      {AZ, NM}, {MT, WY}, {WY, CO}, {CO, NM}};
+  for (const auto& border : borders)
+    csp.addAllDiff(border.first, border.second);
+  // Utah and Nevada do not like the first color
+  csp.add(UT & NV, "0 0 0 0  0 1 1 1  0 1 1 1  0 1 1 1");
+
+  auto solution = csp.solve();
+  CHECK(solution);
+  EXPECT_DOUBLES_EQUAL(1, csp(*solution), 1e-9);
+  EXPECT(solution->at(UT.first) != 0);
+
+  // Randomized searches in parallel find a valid solution, too
+  CSPSearchParams params;
+  params.nrPortfolio = 4;
+  params.seed = 42;
+  solution = csp.solve(params);
+  CHECK(solution);
+  EXPECT_DOUBLES_EQUAL(1, csp(*solution), 1e-9);
+
+  // Three mutually adjacent states cannot be colored with two colors
+  DiscreteKey A(0, 2), B(1, 2), C(2, 2);
+  CSP triangle;
+  triangle.addAllDiff(A, B);
+  triangle.addAllDiff(B, C);
+  triangle.addAllDiff(C, A);
+  EXPECT(!triangle.solve());
+}
+
+/* ************************************************************************* */
+// A constraint defined outside the library, which only implements the pure
+// virtual methods, and whose arc consistency check fails with another error
+class BrokenConstraint : public Constraint {
+ public:
+  explicit BrokenConstraint(Key j) : Constraint(j) {}
+  bool equals(const DiscreteFactor& other, double tol) const override {
+    return dynamic_cast<const BrokenConstraint*>(&other) != nullptr;
+  }
+  double operator()(const DiscreteValues& values) const override { return 1; }
+  DecisionTreeFactor toDecisionTreeFactor() const override {
+    throw std::logic_error("BrokenConstraint: no table");
+  }
+  DecisionTreeFactor operator*(const DecisionTreeFactor& f) const override {
+    return f;
+  }
+  bool ensureArcConsistency(Key j, Domains* domains) const override {
+    throw std::runtime_error("BrokenConstraint: bug");
+  }
+  Constraint::shared_ptr partiallyApply(
+      const DiscreteValues& values) const override {
+    return std::make_shared<BrokenConstraint>(*this);
+  }
+  Constraint::shared_ptr partiallyApply(
+      const Domains& domains) const override {
+    return std::make_shared<BrokenConstraint>(*this);
+  }
+};
+
+// The same constraint, now with the cardinalities needed in a search
+class BrokenKeyedConstraint : public BrokenConstraint {
+ public:
+  explicit BrokenKeyedConstraint(const DiscreteKey& key)
+      : BrokenConstraint(key.first), key_(key) {}
+  DiscreteKeys discreteKeys() const override { return {key_}; }
+
+ private:
+  DiscreteKey key_;
+};
+
+TEST(CSP, ErrorsInConstraints) {
+  DiscreteKey A(0, 2), B(1, 2);
+
+  // Without discreteKeys, a constraint can be built but not searched
+  BrokenConstraint broken(A.first);
+  CHECK_EXCEPTION(broken.discreteKeys(), std::runtime_error);
+
+  // Errors other than an emptied domain are not taken as unsatisfiable
+  CSP csp;
+  csp.addAllDiff(A, B);
+  csp.push_back(std::make_shared<BrokenKeyedConstraint>(A));
+  Domains domains = csp.domains();
+  CHECK_EXCEPTION(csp.propagate(&domains), std::runtime_error);
+  CHECK_EXCEPTION(csp.solve(), std::runtime_error);
+
+  // An emptied domain is, and does derive from std::runtime_error
+  CSP conflict;
+  conflict.addSingleValue(A, 0);
+  conflict.addSingleValue(B, 0);
+  conflict.addAllDiff(A, B);
+  domains = conflict.domains();
+  EXPECT(!conflict.propagate(&domains));
+  domains = conflict.domains();
+  domains.at(A.first) = Domain(A, 1);
+  CHECK_EXCEPTION(SingleValue(A, 0).ensureArcConsistency(A.first, &domains),
+                  UnsatisfiableException);
+}
+
 /* ************************************************************************* */
 int main() {
   TestResult tr;
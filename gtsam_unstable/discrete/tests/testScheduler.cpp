@@ -124,6 +124,11 @@ TEST(schedulingExample, test) {
   // print MPE, commented out as unit tests don't print
   //  s.printAssignment(MPE);
 
+  // Search with propagation finds a valid schedule without the product
+  auto schedule = s.solve();
+  CHECK(schedule);
+  EXPECT(s(*schedule) > 0);
+
   // Commented out as does not work yet
   // s.runArcConsistency(8,10,true);
 
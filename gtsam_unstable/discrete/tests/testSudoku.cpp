@@ -221,6 +221,12 @@ TEST(Sudoku, extreme) {
   EXPECT_LONGS_EQUAL(81 + 20, new_csp.size());
 
   // csp.printSolution(); // still don't do it ! :-(
+
+  // But search with propagation finds a solution easily
+  auto solution = csp.solve();
+  CHECK(solution);
+  EXPECT_LONGS_EQUAL(81, solution->size());
+  EXPECT_DOUBLES_EQUAL(1, csp(*solution), 1e-9);
 }
 
 /* ************************************************************************* */
@@ -254,6 +260,11 @@ TEST(Sudoku, AJC_3star_Feb8_2012) {
   auto solution = new_csp.optimize();
   // csp.printAssignment(solution);
   EXPECT_LONGS_EQUAL(6, solution.at(key99));
+
+  // The solution is unique, so search finds the same one
+  auto searched = csp.solve();
+  CHECK(searched);
+  EXPECT(assert_equal(solution, *searched));
 }
 
 /* ************************************************************************* */
@@ -19,8 +19,16 @@
 
 #pragma once
 
+#include <gtsam/config.h>  // for GTSAM_USE_TBB
+#include <gtsam/linear/linearExceptions.h>
 #include <gtsam_unstable/linear/InfeasibleInitialValues.h>
 
+#ifdef GTSAM_USE_TBB
+#include <tbb/parallel_for.h>
+#endif
+
+#include <stdexcept>
+
 /******************************************************************************/
 // Convenient macros to reduce syntactic noise. undef later.
 #define Template template <class PROBLEM, class POLICY, class INITSOLVER>
@@ -242,8 +250,12 @@ Template InequalityFactorGraph This::identifyActiveConstraints(
   for (const LinearInequality::shared_ptr& factor : inequalities) {
     LinearInequality::shared_ptr workingFactor(new LinearInequality(*factor));
     if (useWarmStart && duals.size() > 0) {
-      if (duals.exists(workingFactor->dualKey())) workingFactor->activate();
-      else workingFactor->inactivate();
+      // Keep the constraints that were active before, if still tight
+      if (duals.exists(workingFactor->dualKey()) &&
+          std::abs(workingFactor->error(initialValues)) < 1e-7)
+        workingFactor->activate();
+      else
+        workingFactor->inactivate();
     } else {
       double error = workingFactor->error(initialValues);
       // Safety guard. This should not happen unless users provide a bad init
@@ -258,14 +270,24 @@ Template InequalityFactorGraph This::identifyActiveConstraints(
   return workingSet;
 }
 
+//******************************************************************************
+Template bool This::isFeasible(const InequalityFactorGraph& workingSet,
+                               const VectorValues& x) const {
+  for (const LinearEquality::shared_ptr& factor : problem_.equalities) {
+    if (factor->error_vector(x).template lpNorm<Eigen::Infinity>() > 1e-7)
+      return false;
+  }
+  for (const LinearInequality::shared_ptr& factor : workingSet) {
+    const double error = factor->error(x);
+    if (error > 1e-7 || (factor->active() && error < -1e-7)) return false;
+  }
+  return true;
+}
+
 //******************************************************************************
 Template std::pair<VectorValues, VectorValues> This::optimize(
-    const VectorValues& initialValues, const VectorValues& duals,
-    bool useWarmStart) const {
-  // Initialize workingSet from the feasible initialValues
-  InequalityFactorGraph workingSet = identifyActiveConstraints(
-      problem_.inequalities, initialValues, duals, useWarmStart);
-  State state(initialValues, duals, workingSet, false, 0);
+    const State& initialState) const {
+  State state = initialState;
 
   /// main loop of the solver
   while (!state.converged) state = iterate(state);
@@ -273,6 +295,48 @@ Template std::pair<VectorValues, VectorValues> This::optimize(
   return std::make_pair(state.values, state.duals);
 }
 
+//******************************************************************************
+Template std::pair<VectorValues, VectorValues> This::optimize(
+    const VectorValues& initialValues, const VectorValues& duals,
+    bool useWarmStart) const {
+  if (!useWarmStart || duals.size() == 0) {
+    // Initialize workingSet from the feasible initialValues
+    InequalityFactorGraph workingSet = identifyActiveConstraints(
+        problem_.inequalities, initialValues, duals, false);
+    return optimize(State(initialValues, duals, workingSet, false, 0));
+  }
+
+  // Start from the initial values, with the previously active constraints
+  // that are still tight there
+  InequalityFactorGraph workingSet = identifyActiveConstraints(
+      problem_.inequalities, initialValues, duals, true);
+  if (isFeasible(workingSet, initialValues))
+    return optimize(State(initialValues, duals, workingSet, false, 0));
+
+  // Otherwise try the solution on all previously active constraints, which
+  // satisfies them by construction
+  workingSet = InequalityFactorGraph();
+  for (const LinearInequality::shared_ptr& factor : problem_.inequalities) {
+    LinearInequality::shared_ptr workingFactor(new LinearInequality(*factor));
+    if (duals.exists(workingFactor->dualKey()))
+      workingFactor->activate();
+    else
+      workingFactor->inactivate();
+    workingSet.push_back(workingFactor);
+  }
+  try {
+    const VectorValues values =
+        buildWorkingGraph(workingSet, initialValues).optimize();
+    if (isFeasible(workingSet, values))
+      return optimize(State(values, duals, workingSet, false, 0));
+  } catch (const IndeterminantLinearSystemException&) {
+    // too many constraints active for this problem
+  }
+
+  // Cold start
+  return optimize();
+}
+
 //******************************************************************************
 Template std::pair<VectorValues, VectorValues> This::optimize() const {
   INITSOLVER initSolver(problem_);
@@ -280,6 +344,31 @@ Template std::pair<VectorValues, VectorValues> This::optimize() const {
   return optimize(initValues);
 }
 
+//******************************************************************************
+Template std::vector<std::pair<VectorValues, VectorValues> > This::Optimize(
+    const std::vector<PROBLEM>& problems,
+    const std::vector<std::pair<VectorValues, VectorValues> >& warmStarts) {
+  if (!warmStarts.empty() && warmStarts.size() != problems.size())
+    throw std::invalid_argument(
+        "ActiveSetSolver::Optimize: need one warm start per problem");
+
+  std::vector<std::pair<VectorValues, VectorValues> > solutions(
+      problems.size());
+  const auto solve = [&](size_t i) {
+    const This solver(problems[i]);
+    solutions[i] = warmStarts.empty()
+                       ? solver.optimize()
+                       : solver.optimize(warmStarts[i].first,
+                                         warmStarts[i].second, true);
+  };
+#ifdef GTSAM_USE_TBB
+  tbb::parallel_for(size_t(0), problems.size(), solve);
+#else
+  for (size_t i = 0; i < problems.size(); ++i) solve(i);
+#endif
+  return solutions;
+}
+
 }
 
 #undef Template
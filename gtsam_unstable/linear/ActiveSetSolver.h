@@ -21,6 +21,9 @@
 #include <gtsam/linear/GaussianFactorGraph.h>
 #include <gtsam_unstable/linear/InequalityFactorGraph.h>
 
+#include <utility>
+#include <vector>
+
 namespace gtsam {
 
 /**
@@ -84,6 +87,14 @@ public:
    * Optimize with provided initial values
    * For this version, it is the responsibility of the caller to provide
    * a feasible initial value, otherwise, an exception will be thrown.
+   *
+   * With useWarmStart, the <primal, dual> solution of a similar problem, e.g.
+   * the previous one in model predictive control, is used instead. The working
+   * set starts with the inequalities that have a dual in @p duals and are tight
+   * at @p initialValues. If these values are infeasible for this problem, we
+   * try the solution on that working set, and if that is infeasible as well
+   * we fall back to a cold start from INITSOLVER. In all cases,
+   * @p initialValues have to contain all variables of the problem.
    * @return a pair of <primal, dual> solutions
    */
   std::pair<VectorValues, VectorValues> optimize(
@@ -97,7 +108,30 @@ public:
    */
   std::pair<VectorValues, VectorValues> optimize() const;
 
+  /**
+   * Solve many independent problems, in parallel if TBB is available, e.g.
+   * the small programs of a batch of model predictive controllers.
+   * @param problems the problems to solve
+   * @param warmStarts optional <primal, dual> solutions of similar problems,
+   *        one per problem, to warm start from as in optimize()
+   * @return a pair of <primal, dual> solutions per problem
+   */
+  static std::vector<std::pair<VectorValues, VectorValues> > Optimize(
+      const std::vector<PROBLEM>& problems,
+      const std::vector<std::pair<VectorValues, VectorValues> >& warmStarts =
+          {});
+
 protected:
+  /// Iterate from the given state until convergence
+  std::pair<VectorValues, VectorValues> optimize(const State& state) const;
+
+  /**
+   * Check that @p x satisfies all equalities, is on the active inequalities of
+   * @p workingSet, and satisfies the inactive ones.
+   */
+  bool isFeasible(const InequalityFactorGraph& workingSet,
+                  const VectorValues& x) const;
+
   /**
    * Compute minimum step size alpha to move from the current point @p xk to the
    * next feasible point along a direction @p p:  x' = xk + alpha*p,
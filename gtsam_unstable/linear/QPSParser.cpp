@@ -15,511 +15,402 @@
  * @date     3/5/16
  */
 
-#define BOOST_SPIRIT_USE_PHOENIX_V3 1
-
 #include <gtsam/base/Matrix.h>
+#include <gtsam/base/SymmetricBlockMatrix.h>
 #include <gtsam/inference/Key.h>
 #include <gtsam/inference/Symbol.h>
 #include <gtsam_unstable/linear/QP.h>
 #include <gtsam_unstable/linear/QPSParser.h>
 #include <gtsam_unstable/linear/QPSParserException.h>
 
-#include <boost/fusion/include/vector.hpp>
-#include <boost/fusion/sequence.hpp>
-#include <boost/lambda/lambda.hpp>
-#include <boost/phoenix/bind.hpp>
-#include <boost/spirit/include/classic.hpp>
-#include <boost/spirit/include/qi.hpp>
-
 #include <algorithm>
-#include <iostream>
-#include <map>
+#include <cmath>
+#include <cstdlib>
+#include <limits>
 #include <string>
+#include <string_view>
 #include <unordered_map>
+#include <utility>
 #include <vector>
 
-using boost::fusion::at_c;
-using namespace std::placeholders;
 using namespace std;
 
-namespace bf = boost::fusion;
-namespace qi = boost::spirit::qi;
-
-using Chars = std::vector<char>;
+namespace gtsam {
 
-// Get a string from a fusion vector of Chars
-template <size_t I, class FusionVector>
-static string fromChars(const FusionVector &vars) {
-  const Chars &chars = at_c<I>(vars);
-  return string(chars.begin(), chars.end());
+namespace {
+
+// Bounds with a magnitude of at least 1e30 mean infinity in MPS files
+constexpr double kInfinity = std::numeric_limits<double>::infinity();
+bool isInfinite(double value) { return std::abs(value) >= 1e30; }
+
+// Split a line into its whitespace separated fields
+void tokenize(const string& line, vector<string_view>* tokens) {
+  tokens->clear();
+  const size_t n = line.size();
+  size_t i = 0;
+  while (i < n) {
+    while (i < n && isspace(static_cast<unsigned char>(line[i]))) ++i;
+    const size_t start = i;
+    while (i < n && !isspace(static_cast<unsigned char>(line[i]))) ++i;
+    if (i > start) tokens->emplace_back(line.data() + start, i - start);
+  }
 }
 
-namespace gtsam {
+}  // namespace
 
 /**
- * As the parser reads a file, it call functions in this visitor. This visitor
- * in turn stores what the parser has read in a way that can be later used to
- * build the full QP problem in the file.
+ * The rows, coefficients and bounds of a QPS file. Everything is stored
+ * sparsely while the file is read, and assembled into the factors of a QP or
+ * LP afterwards.
  */
-class QPSVisitor {
- private:
-  typedef std::unordered_map<Key, Matrix11> coefficient_v;
-  typedef std::unordered_map<std::string, coefficient_v> constraint_v;
-
-  std::unordered_map<std::string, constraint_v *>
-      row_to_constraint_v;  // Maps QPS ROWS to Variable-Matrix pairs
-  constraint_v E;           // Equalities
-  constraint_v IG;          // Inequalities >=
-  constraint_v IL;          // Inequalities <=
-  unsigned int numVariables;
-  std::unordered_map<std::string, double>
-      b;  // maps from constraint name to b value for Ax = b equality
-          // constraints
-  std::unordered_map<std::string, double>
-      ranges;  // Inequalities can be specified as ranges on a variable
-  std::unordered_map<Key, Vector1> g;  // linear term of quadratic cost
-  std::unordered_map<std::string, Key>
-      varname_to_key;  // Variable QPS string name to key
-  std::unordered_map<Key, std::unordered_map<Key, Matrix11>>
-      H;                 // H from hessian
-  double f = 0;          // Constant term of quadratic cost
-  std::string obj_name;  // the objective function has a name in the QPS
-  std::string name_;     // the quadratic program has a name in the QPS
-  std::unordered_map<Key, double>
-      up;  // Upper Bound constraints on variable where X < MAX
-  std::unordered_map<Key, double>
-      lo;  // Lower Bound constraints on variable where MIN < X
-  std::unordered_map<Key, double>
-      fx;          // Equalities specified as FX in BOUNDS part of QPS
-  KeyVector free;  // Variables can be specified as free (to which no
-                   // constraints apply)
-  const bool debug = false;
-
+class QPSParser::Data {
  public:
-  QPSVisitor() : numVariables(1) {}
+  /// Read the file, throws QPSParserException on malformed input
+  explicit Data(const string& fileName) : fileName_(fileName) {
+    ifstream stream(fileName);
+    if (!stream) throw QPSParserException("Cannot open QPS file " + fileName);
+    read(stream);
+  }
 
-  void setName(boost::fusion::vector<Chars, Chars, Chars> const &name) {
-    name_ = fromChars<1>(name);
-    if (debug) {
-      cout << "Parsing file: " << name_ << endl;
-    }
+  bool hasQuadraticTerms() const {
+    return std::any_of(quadratic_.begin(), quadratic_.end(),
+                       [](const Entry& entry) { return entry.value != 0.0; });
   }
 
-  void addColumn(boost::fusion::vector<Chars, Chars, Chars, Chars, Chars,
-                                       double, Chars> const &vars) {
-    string var_ = fromChars<1>(vars);
-    string row_ = fromChars<3>(vars);
-    Matrix11 coefficient = at_c<5>(vars) * I_1x1;
-    if (debug) {
-      cout << "Added Column for Var: " << var_ << " Row: " << row_
-           << " Coefficient: " << coefficient << endl;
-    }
-    if (!varname_to_key.count(var_))
-      varname_to_key[var_] = Symbol('X', numVariables++);
-    if (row_ == obj_name) {
-      g[varname_to_key[var_]] = coefficient;
-      return;
+  /// Quadratic cost 0.5 x'Qx + c'x + f as a HessianFactor
+  HessianFactor quadraticCost() const {
+    const size_t n = numVariables();
+    SymmetricBlockMatrix info(vector<size_t>(n, 1), true);
+    info.setZero();
+    for (const Entry& entry : quadratic_) {
+      if (entry.i == entry.j)
+        info.setDiagonalBlock(entry.i, Matrix11(entry.value));
+      else
+        info.setOffDiagonalBlock(entry.i, entry.j, Matrix11(entry.value));
     }
-    (*row_to_constraint_v[row_])[row_][varname_to_key[var_]] = coefficient;
+    for (size_t i = 0; i < n; ++i)
+      info.setOffDiagonalBlock(i, n, Matrix11(-objective_[i]));
+    info.setDiagonalBlock(n, Matrix11(2 * f_));
+    return HessianFactor(keys(), info);
   }
 
-  void addColumnDouble(
-      boost::fusion::vector<Chars, Chars, Chars, Chars, double, Chars, Chars,
-                            Chars, double> const &vars) {
-    string var_ = fromChars<0>(vars);
-    string row1_ = fromChars<2>(vars);
-    string row2_ = fromChars<6>(vars);
-    Matrix11 coefficient1 = at_c<4>(vars) * I_1x1;
-    Matrix11 coefficient2 = at_c<8>(vars) * I_1x1;
-    if (!varname_to_key.count(var_))
-      varname_to_key.insert({var_, Symbol('X', numVariables++)});
-    if (row1_ == obj_name)
-      g[varname_to_key[var_]] = coefficient1;
-    else
-      (*row_to_constraint_v[row1_])[row1_][varname_to_key[var_]] = coefficient1;
-    if (row2_ == obj_name)
-      g[varname_to_key[var_]] = coefficient2;
-    else
-      (*row_to_constraint_v[row2_])[row2_][varname_to_key[var_]] = coefficient2;
+  /// Linear cost c'x, with a (possibly zero) coefficient for every variable
+  LinearCost linearCost() const {
+    vector<pair<Key, Matrix>> terms;
+    terms.reserve(numVariables());
+    for (size_t i = 0; i < numVariables(); ++i)
+      terms.emplace_back(key(i), Matrix11(objective_[i]));
+    return LinearCost(terms);
   }
 
-  void addRangeSingle(boost::fusion::vector<Chars, Chars, Chars, Chars, Chars,
-                                            double, Chars> const &vars) {
-    string var_ = fromChars<1>(vars);
-    string row_ = fromChars<3>(vars);
-    double range = at_c<5>(vars);
-    ranges[row_] = range;
-    if (debug) {
-      cout << "SINGLE RANGE ADDED" << endl;
-      cout << "VAR:" << var_ << " ROW: " << row_ << " RANGE: " << range << endl;
-    }
-  }
-  void addRangeDouble(
-      boost::fusion::vector<Chars, Chars, Chars, Chars, Chars, double, Chars,
-                            Chars, Chars, double> const &vars) {
-    string var_ = fromChars<1>(vars);
-    string row1_ = fromChars<3>(vars);
-    string row2_ = fromChars<7>(vars);
-    double range1 = at_c<5>(vars);
-    double range2 = at_c<9>(vars);
-    ranges[row1_] = range1;
-    ranges[row2_] = range2;
-    if (debug) {
-      cout << "DOUBLE RANGE ADDED" << endl;
-      cout << "VAR: " << var_ << " ROW1: " << row1_ << " RANGE1: " << range1
-           << " ROW2: " << row2_ << " RANGE2: " << range2 << endl;
+  /**
+   * Add the rows and variable bounds as constraints. Equality rows come
+   * first, then >= rows, <= rows and finally the bounds of each variable.
+   */
+  template <class PROBLEM>
+  void addConstraints(PROBLEM* problem) const {
+    size_t dualKey = numVariables() + 1;
+    const auto add = [&](const Row& row) {
+      auto [lower, upper] = interval(row);
+      vector<pair<Key, Matrix>> terms = sortedTerms(row);
+      if (lower == upper) {
+        problem->equalities.push_back(
+            LinearEquality(terms, Vector1(upper), dualKey++));
+        return;
+      }
+      // a'x <= upper and -a'x <= -lower, the bound given by the rhs first
+      const bool upperFirst = row.type == 'L' || (row.type == 'E' &&
+                                                  row.range < 0);
+      for (bool isUpper : {upperFirst, !upperFirst}) {
+        const double bound = isUpper ? upper : -lower;
+        if (std::isinf(bound)) continue;
+        if (!isUpper)
+          for (auto& term : terms) term.second = -term.second;
+        problem->inequalities.push_back(
+            LinearInequality(terms, bound, dualKey++));
+        if (!isUpper)
+          for (auto& term : terms) term.second = -term.second;
+      }
+    };
+    for (char type : {'E', 'G', 'L'})
+      for (const Row& row : rows_)
+        if (row.type == type) add(row);
+
+    for (size_t i = 0; i < numVariables(); ++i) {
+      const Bounds& b = bounds_[i];
+      if (b.free) continue;
+      if (b.lower == b.upper) {
+        problem->equalities.push_back(
+            LinearEquality(key(i), I_1x1, Vector1(b.upper), dualKey++));
+        continue;
+      }
+      if (!std::isinf(b.upper))
+        problem->inequalities.push_back(
+            LinearInequality(key(i), I_1x1, b.upper, dualKey++));
+      if (!std::isinf(b.lower))
+        problem->inequalities.push_back(
+            LinearInequality(key(i), -I_1x1, -b.lower, dualKey++));
     }
   }
 
-  void addRHS(boost::fusion::vector<Chars, Chars, Chars, Chars, Chars, double,
-                                    Chars> const &vars) {
-    string var_ = fromChars<1>(vars);
-    string row_ = fromChars<3>(vars);
-    double coefficient = at_c<5>(vars);
-    if (row_ == obj_name) {
-      f = -coefficient;
-    } else {
-      b[row_] = coefficient;
-    }
-
-    if (debug) {
-      cout << "Added RHS for Var: " << var_ << " Row: " << row_
-           << " Coefficient: " << coefficient << endl;
-    }
+ private:
+  /// A constraint row, with its coefficients in the order they were read
+  struct Row {
+    char type;  // 'E', 'G' or 'L'
+    vector<pair<size_t, double>> coefficients;
+    double rhs = 0.0, range = 0.0;
+    bool hasRange = false;
+  };
+
+  /// Bounds on a variable, by default 0 <= x < infinity
+  struct Bounds {
+    double lower = 0.0, upper = kInfinity;
+    bool free = false;
+  };
+
+  /// An entry of the Hessian, the last one read for (i, j) wins
+  struct Entry {
+    size_t i, j;
+    double value;
+  };
+
+  enum Section { NONE, ROWS, COLUMNS, RHS, RANGES, BOUNDS, QUADOBJ };
+
+  string fileName_;
+  size_t lineNumber_ = 0;
+  string objectiveRow_;
+  unordered_map<string, size_t> rowIndex_;
+  vector<string> freeRows_;  // extra objective rows, which are ignored
+  vector<Row> rows_;
+  unordered_map<string, size_t> variableIndex_;
+  vector<double> objective_;  // linear cost per variable
+  vector<Bounds> bounds_;
+  vector<Entry> quadratic_;
+  double f_ = 0.0;  // constant term of the cost
+
+  size_t numVariables() const { return objective_.size(); }
+  static Key key(size_t i) { return Symbol('X', i + 1); }
+
+  KeyVector keys() const {
+    KeyVector result(numVariables());
+    for (size_t i = 0; i < result.size(); ++i) result[i] = key(i);
+    return result;
   }
 
-  void addRHSDouble(
-      boost::fusion::vector<Chars, Chars, Chars, Chars, Chars, double, Chars,
-                            Chars, Chars, double> const &vars) {
-    string var_ = fromChars<1>(vars);
-    string row1_ = fromChars<3>(vars);
-    string row2_ = fromChars<7>(vars);
-    double coefficient1 = at_c<5>(vars);
-    double coefficient2 = at_c<9>(vars);
-    if (row1_ == obj_name) {
-      f = -coefficient1;
-    } else {
-      b[row1_] = coefficient1;
-    }
-
-    if (row2_ == obj_name) {
-      f = -coefficient2;
-    } else {
-      b[row2_] = coefficient2;
-    }
+  [[noreturn]] void error(const string& what) const {
+    throw QPSParserException(fileName_ + ":" + to_string(lineNumber_) + ": " +
+                             what);
+  }
 
-    if (debug) {
-      cout << "Added RHS for Var: " << var_ << " Row: " << row1_
-           << " Coefficient: " << coefficient1 << endl;
-      cout << "                      "
-           << "Row: " << row2_ << " Coefficient: " << coefficient2 << endl;
-    }
+  double number(string_view token) const {
+    const string text(token);
+    char* end = nullptr;
+    const double value = std::strtod(text.c_str(), &end);
+    if (text.empty() || end != text.c_str() + text.size())
+      error("expected a number, got '" + text + "'");
+    return value;
   }
 
-  void addRow(
-      boost::fusion::vector<Chars, char, Chars, Chars, Chars> const &vars) {
-    string name_ = fromChars<3>(vars);
-    char type = at_c<1>(vars);
-    switch (type) {
-      case 'N':
-        obj_name = name_;
-        break;
-      case 'L':
-        row_to_constraint_v[name_] = &IL;
-        break;
-      case 'G':
-        row_to_constraint_v[name_] = &IG;
-        break;
-      case 'E':
-        row_to_constraint_v[name_] = &E;
-        break;
-      default:
-        cout << "invalid type: " << type << endl;
-        break;
-    }
-    if (debug) {
-      cout << "Added Row Type: " << type << " Name: " << name_ << endl;
+  size_t variable(string_view name) {
+    const auto it = variableIndex_.emplace(string(name), numVariables());
+    if (it.second) {
+      objective_.push_back(0.0);
+      bounds_.emplace_back();
     }
+    return it.first->second;
   }
 
-  void addBound(boost::fusion::vector<Chars, Chars, Chars, Chars, Chars, Chars,
-                                      Chars, double> const &vars) {
-    string type_ = fromChars<1>(vars);
-    string var_ = fromChars<5>(vars);
-    double number = at_c<7>(vars);
-    if (type_.compare(string("UP")) == 0)
-      up[varname_to_key[var_]] = number;
-    else if (type_.compare(string("LO")) == 0)
-      lo[varname_to_key[var_]] = number;
-    else if (type_.compare(string("FX")) == 0)
-      fx[varname_to_key[var_]] = number;
-    else
-      cout << "Invalid Bound Type: " << type_ << endl;
-
-    if (debug) {
-      cout << "Added Bound Type: " << type_ << " Var: " << var_
-           << " Amount: " << number << endl;
-    }
+  // Returns the index of a constraint row, or -1 for objective or free rows
+  long row(string_view name) const {
+    const auto it = rowIndex_.find(string(name));
+    if (it != rowIndex_.end()) return static_cast<long>(it->second);
+    if (name == objectiveRow_ ||
+        std::find(freeRows_.begin(), freeRows_.end(), name) != freeRows_.end())
+      return -1;
+    error("unknown row '" + string(name) + "'");
   }
 
-  void addFreeBound(boost::fusion::vector<Chars, Chars, Chars, Chars, Chars,
-                                          Chars, Chars> const &vars) {
-    string type_ = fromChars<1>(vars);
-    string var_ = fromChars<5>(vars);
-    free.push_back(varname_to_key[var_]);
-    if (debug) {
-      cout << "Added Free Bound Type: " << type_ << " Var: " << var_
-           << " Amount: " << endl;
+  void read(istream& stream) {
+    Section section = NONE;
+    bool ended = false;
+    string line;
+    vector<string_view> tokens;
+    while (!ended && getline(stream, line)) {
+      ++lineNumber_;
+      if (!line.empty() && line.back() == '\r') line.pop_back();
+      if (line.empty() || line[0] == '*') continue;
+      tokenize(line, &tokens);
+      if (tokens.empty()) continue;
+
+      // Section headers start in the first column
+      if (!isspace(static_cast<unsigned char>(line[0]))) {
+        const string_view header = tokens[0];
+        if (header == "NAME") section = NONE;
+        else if (header == "ROWS") section = ROWS;
+        else if (header == "COLUMNS") section = COLUMNS;
+        else if (header == "RHS") section = RHS;
+        else if (header == "RANGES") section = RANGES;
+        else if (header == "BOUNDS") section = BOUNDS;
+        else if (header == "QUADOBJ" || header == "QMATRIX") section = QUADOBJ;
+        else if (header == "ENDATA") ended = true;
+        else error("unknown section '" + string(header) + "'");
+        continue;
+      }
+
+      switch (section) {
+        case ROWS: readRow(tokens); break;
+        case COLUMNS: readColumn(tokens); break;
+        case RHS: readRhs(tokens, false); break;
+        case RANGES: readRhs(tokens, true); break;
+        case BOUNDS: readBound(tokens); break;
+        case QUADOBJ: readQuadratic(tokens); break;
+        default: error("data outside of a section");
+      }
     }
+    if (!ended) error("missing ENDATA");
+    if (objectiveRow_.empty()) error("no objective row");
   }
 
-  void addQuadTerm(boost::fusion::vector<Chars, Chars, Chars, Chars, Chars,
-                                         double, Chars> const &vars) {
-    string var1_ = fromChars<1>(vars);
-    string var2_ = fromChars<3>(vars);
-    Matrix11 coefficient = at_c<5>(vars) * I_1x1;
-
-    H[varname_to_key[var1_]][varname_to_key[var2_]] = coefficient;
-    H[varname_to_key[var2_]][varname_to_key[var1_]] = coefficient;
-    if (debug) {
-      cout << "Added QuadTerm for Var: " << var1_ << " Row: " << var2_
-           << " Coefficient: " << coefficient << endl;
+  void readRow(const vector<string_view>& tokens) {
+    if (tokens.size() != 2 || tokens[0].size() != 1) error("invalid row");
+    const string name(tokens[1]);
+    const char type = tokens[0][0];
+    if (type == 'N') {
+      if (objectiveRow_.empty())
+        objectiveRow_ = name;
+      else
+        freeRows_.push_back(name);
+    } else if (type == 'E' || type == 'G' || type == 'L') {
+      if (!rowIndex_.emplace(name, rows_.size()).second)
+        error("duplicate row '" + name + "'");
+      rows_.push_back(Row{type, {}});
+    } else {
+      error("invalid row type '" + string(tokens[0]) + "'");
     }
   }
 
-  QP makeQP() {
-    // Create the keys from the variable names
-    KeyVector keys;
-    for (auto kv : varname_to_key) {
-      keys.push_back(kv.second);
+  // var row value [row value]
+  void readColumn(const vector<string_view>& tokens) {
+    if (tokens.size() == 3 && tokens[1] == "'MARKER'")
+      error("integer variables are not supported");
+    if (tokens.size() != 3 && tokens.size() != 5) error("invalid column");
+    const size_t j = variable(tokens[0]);
+    for (size_t t = 1; t < tokens.size(); t += 2) {
+      const double value = number(tokens[t + 1]);
+      if (tokens[t] == objectiveRow_)
+        objective_[j] = value;
+      else if (const long i = row(tokens[t]); i >= 0)
+        rows_[i].coefficients.emplace_back(j, value);
     }
+  }
 
-    // Fill the G matrices and g vectors from
-    vector<Matrix> Gs;
-    vector<Vector> gs;
-    sort(keys.begin(), keys.end());
-    for (size_t i = 0; i < keys.size(); ++i) {
-      for (size_t j = i; j < keys.size(); ++j) {
-        if (H.count(keys[i]) > 0 && H[keys[i]].count(keys[j]) > 0) {
-          Gs.emplace_back(H[keys[i]][keys[j]]);
+  // [set] row value [row value], for both the RHS and RANGES sections
+  void readRhs(const vector<string_view>& tokens, bool isRange) {
+    if (tokens.size() < 2 || tokens.size() > 5) error("invalid rhs or range");
+    for (size_t t = tokens.size() % 2; t < tokens.size(); t += 2) {
+      const double value = number(tokens[t + 1]);
+      if (tokens[t] == objectiveRow_) {
+        if (isRange) error("range on the objective row");
+        f_ = -value;
+      } else if (const long i = row(tokens[t]); i >= 0) {
+        if (isRange) {
+          rows_[i].range = value;
+          rows_[i].hasRange = true;
         } else {
-          Gs.emplace_back(Z_1x1);
+          rows_[i].rhs = value;
         }
       }
     }
-    for (Key key1 : keys) {
-      if (g.count(key1) > 0) {
-        gs.emplace_back(-g[key1]);
-      } else {
-        gs.emplace_back(Z_1x1);
-      }
-    }
+  }
 
-    // Construct the quadratic program
-    QP madeQP;
-    auto obj = HessianFactor(keys, Gs, gs, 2 * f);
-    madeQP.cost.push_back(obj);
-
-    // Add equality and inequality constraints into the QP
-    size_t dual_key_num = keys.size() + 1;
-    for (auto kv : E) {
-      map<Key, Matrix11> keyMatrixMapPos;
-      map<Key, Matrix11> keyMatrixMapNeg;
-      if (ranges.count(kv.first) == 1) {
-        for (auto km : kv.second) {
-          keyMatrixMapPos.insert(km);
-          km.second = -km.second;
-          keyMatrixMapNeg.insert(km);
-        }
-        if (ranges[kv.first] > 0) {
-          madeQP.inequalities.push_back(
-              LinearInequality(keyMatrixMapNeg, -b[kv.first], dual_key_num++));
-          madeQP.inequalities.push_back(LinearInequality(
-              keyMatrixMapPos, b[kv.first] + ranges[kv.first], dual_key_num++));
-        } else if (ranges[kv.first] < 0) {
-          madeQP.inequalities.push_back(
-              LinearInequality(keyMatrixMapPos, b[kv.first], dual_key_num++));
-          madeQP.inequalities.push_back(LinearInequality(
-              keyMatrixMapNeg, ranges[kv.first] - b[kv.first], dual_key_num++));
-        } else {
-          cerr << "ERROR: CANNOT ADD A RANGE OF ZERO" << endl;
-          throw;
-        }
-        continue;
-      }
-      map<Key, Matrix11> keyMatrixMap;
-      for (auto km : kv.second) {
-        keyMatrixMap.insert(km);
-      }
-      madeQP.equalities.push_back(
-          LinearEquality(keyMatrixMap, b[kv.first] * I_1x1, dual_key_num++));
-    }
+  // type [set] var [value]
+  void readBound(const vector<string_view>& tokens) {
+    if (tokens.empty()) error("invalid bound");
+    const string_view type = tokens[0];
+    const bool hasValue = type == "UP" || type == "LO" || type == "FX";
+    const size_t size = hasValue ? 4 : 3;
+    if (tokens.size() != size && tokens.size() != size - 1)
+      error("invalid bound");
+    const size_t j = variable(tokens[tokens.size() == size ? 2 : 1]);
+    const double value = hasValue ? number(tokens.back()) : 0.0;
+    Bounds& b = bounds_[j];
+    if (type == "UP") b.upper = isInfinite(value) ? kInfinity : value;
+    else if (type == "LO") b.lower = isInfinite(value) ? -kInfinity : value;
+    else if (type == "FX") b.lower = b.upper = value;
+    else if (type == "FR") b.free = true;
+    else if (type == "MI") b.lower = -kInfinity;
+    else if (type == "PL") b.upper = kInfinity;
+    else error("unsupported bound type '" + string(type) + "'");
+  }
 
-    for (auto kv : IG) {
-      map<Key, Matrix11> keyMatrixMapNeg;
-      map<Key, Matrix11> keyMatrixMapPos;
-      for (auto km : kv.second) {
-        keyMatrixMapPos.insert(km);
-        km.second = -km.second;
-        keyMatrixMapNeg.insert(km);
-      }
-      madeQP.inequalities.push_back(
-          LinearInequality(keyMatrixMapNeg, -b[kv.first], dual_key_num++));
-      if (ranges.count(kv.first) == 1) {
-        madeQP.inequalities.push_back(LinearInequality(
-            keyMatrixMapPos, b[kv.first] + ranges[kv.first], dual_key_num++));
-      }
-    }
+  // var1 var2 value, an entry of the lower triangle of Q
+  void readQuadratic(const vector<string_view>& tokens) {
+    if (tokens.size() != 3) error("invalid quadratic term");
+    const size_t i = variable(tokens[0]), j = variable(tokens[1]);
+    quadratic_.push_back({i, j, number(tokens[2])});
+  }
 
-    for (auto kv : IL) {
-      map<Key, Matrix11> keyMatrixMapPos;
-      map<Key, Matrix11> keyMatrixMapNeg;
-      for (auto km : kv.second) {
-        keyMatrixMapPos.insert(km);
-        km.second = -km.second;
-        keyMatrixMapNeg.insert(km);
-      }
-      madeQP.inequalities.push_back(
-          LinearInequality(keyMatrixMapPos, b[kv.first], dual_key_num++));
-      if (ranges.count(kv.first) == 1) {
-        madeQP.inequalities.push_back(LinearInequality(
-            keyMatrixMapNeg, ranges[kv.first] - b[kv.first], dual_key_num++));
-      }
+  // The interval [lower, upper] that a'x has to lie in, as in the MPS format
+  static pair<double, double> interval(const Row& row) {
+    const double b = row.rhs, r = std::abs(row.range);
+    switch (row.type) {
+      case 'G':
+        return {b, row.hasRange ? b + r : kInfinity};
+      case 'L':
+        return {row.hasRange ? b - r : -kInfinity, b};
+      default:  // 'E'
+        if (row.range > 0) return {b, b + r};
+        if (row.range < 0) return {b - r, b};
+        return {b, b};
     }
+  }
 
-    for (Key k : keys) {
-      if (find(free.begin(), free.end(), k) != free.end()) continue;
-      if (fx.count(k) == 1)
-        madeQP.equalities.push_back(
-            LinearEquality(k, I_1x1, fx[k] * I_1x1, dual_key_num++));
-      if (up.count(k) == 1)
-        madeQP.inequalities.push_back(
-            LinearInequality(k, I_1x1, up[k], dual_key_num++));
-      if (lo.count(k) == 1)
-        madeQP.inequalities.push_back(
-            LinearInequality(k, -I_1x1, -lo[k], dual_key_num++));
-      else
-        madeQP.inequalities.push_back(
-            LinearInequality(k, -I_1x1, 0, dual_key_num++));
-    }
-    return madeQP;
+  // Terms sorted by key, where the last coefficient read for a variable wins
+  static vector<pair<Key, Matrix>> sortedTerms(const Row& row) {
+    vector<pair<size_t, double>> coefficients = row.coefficients;
+    std::reverse(coefficients.begin(), coefficients.end());
+    std::stable_sort(coefficients.begin(), coefficients.end(),
+                     [](const pair<size_t, double>& a,
+                        const pair<size_t, double>& b) {
+                       return a.first < b.first;
+                     });
+    vector<pair<Key, Matrix>> terms;
+    terms.reserve(coefficients.size());
+    for (const auto& [j, value] : coefficients)
+      if (terms.empty() || terms.back().first != key(j))
+        terms.emplace_back(key(j), Matrix11(value));
+    return terms;
   }
 };
 
-typedef qi::grammar<boost::spirit::basic_istream_iterator<char>> base_grammar;
-
-struct QPSParser::MPSGrammar : base_grammar {
-  typedef std::vector<char> Chars;
-  QPSVisitor *rqp_;
-  std::function<void(bf::vector<Chars, Chars, Chars> const &)> setName;
-  std::function<void(bf::vector<Chars, char, Chars, Chars, Chars> const &)>
-      addRow;
-  std::function<void(
-      bf::vector<Chars, Chars, Chars, Chars, Chars, double, Chars> const &)>
-      rhsSingle;
-  std::function<void(bf::vector<Chars, Chars, Chars, Chars, Chars, double,
-                                  Chars, Chars, Chars, double>)>
-      rhsDouble;
-  std::function<void(
-      bf::vector<Chars, Chars, Chars, Chars, Chars, double, Chars> const &)>
-      rangeSingle;
-  std::function<void(bf::vector<Chars, Chars, Chars, Chars, Chars, double,
-                                  Chars, Chars, Chars, double>)>
-      rangeDouble;
-  std::function<void(
-      bf::vector<Chars, Chars, Chars, Chars, Chars, double, Chars>)>
-      colSingle;
-  std::function<void(bf::vector<Chars, Chars, Chars, Chars, double, Chars,
-                                  Chars, Chars, double> const &)>
-      colDouble;
-  std::function<void(
-      bf::vector<Chars, Chars, Chars, Chars, Chars, double, Chars> const &)>
-      addQuadTerm;
-  std::function<void(bf::vector<Chars, Chars, Chars, Chars, Chars, Chars,
-                                  Chars, double> const &)>
-      addBound;
-  std::function<void(
-      bf::vector<Chars, Chars, Chars, Chars, Chars, Chars, Chars> const &)>
-      addFreeBound;
-  MPSGrammar(QPSVisitor *rqp)
-      : base_grammar(start),
-        rqp_(rqp),
-        setName(std::bind(&QPSVisitor::setName, rqp, std::placeholders::_1)),
-        addRow(std::bind(&QPSVisitor::addRow, rqp, std::placeholders::_1)),
-        rhsSingle(std::bind(&QPSVisitor::addRHS, rqp, std::placeholders::_1)),
-        rhsDouble(std::bind(&QPSVisitor::addRHSDouble, rqp, std::placeholders::_1)),
-        rangeSingle(std::bind(&QPSVisitor::addRangeSingle, rqp, std::placeholders::_1)),
-        rangeDouble(std::bind(&QPSVisitor::addRangeDouble, rqp, std::placeholders::_1)),
-        colSingle(std::bind(&QPSVisitor::addColumn, rqp, std::placeholders::_1)),
-        colDouble(std::bind(&QPSVisitor::addColumnDouble, rqp, std::placeholders::_1)),
-        addQuadTerm(std::bind(&QPSVisitor::addQuadTerm, rqp, std::placeholders::_1)),
-        addBound(std::bind(&QPSVisitor::addBound, rqp, std::placeholders::_1)),
-        addFreeBound(std::bind(&QPSVisitor::addFreeBound, rqp, std::placeholders::_1)) {
-    using namespace boost::spirit;
-    using namespace boost::spirit::qi;
-    character = lexeme[alnum | '_' | '-' | '.'];
-    title = lexeme[character >> *(blank | character)];
-    word = lexeme[+character];
-    name = lexeme[lit("NAME") >> *blank >> title >> +space][setName];
-    row = lexeme[*blank >> character >> +blank >> word >> *blank][addRow];
-    rhs_single = lexeme[*blank >> word >> +blank >> word >> +blank >> double_ >>
-                        *blank][rhsSingle];
-    rhs_double =
-        lexeme[(*blank >> word >> +blank >> word >> +blank >> double_ >>
-                +blank >> word >> +blank >> double_)[rhsDouble] >>
-               *blank];
-    range_single = lexeme[*blank >> word >> +blank >> word >> +blank >>
-                          double_ >> *blank][rangeSingle];
-    range_double =
-        lexeme[(*blank >> word >> +blank >> word >> +blank >> double_ >>
-                +blank >> word >> +blank >> double_)[rangeDouble] >>
-               *blank];
-    col_single = lexeme[*blank >> word >> +blank >> word >> +blank >> double_ >>
-                        *blank][colSingle];
-    col_double =
-        lexeme[*blank >> (word >> +blank >> word >> +blank >> double_ >>
-                          +blank >> word >> +blank >> double_)[colDouble] >>
-               *blank];
-    quad_l = lexeme[*blank >> word >> +blank >> word >> +blank >> double_ >>
-                    *blank][addQuadTerm];
-    bound = lexeme[(*blank >> word >> +blank >> word >> +blank >> word >>
-                    +blank >> double_)[addBound] >>
-                   *blank];
-    bound_fr = lexeme[*blank >> word >> +blank >> word >> +blank >> word >>
-                      *blank][addFreeBound];
-    rows = lexeme[lit("ROWS") >> *blank >> eol >> +(row >> eol)];
-    rhs = lexeme[lit("RHS") >> *blank >> eol >>
-                 +((rhs_double | rhs_single) >> eol)];
-    cols = lexeme[lit("COLUMNS") >> *blank >> eol >>
-                  +((col_double | col_single) >> eol)];
-    quad = lexeme[lit("QUADOBJ") >> *blank >> eol >> +(quad_l >> eol)];
-    bounds = lexeme[lit("BOUNDS") >> +space >> *((bound | bound_fr) >> eol)];
-    ranges = lexeme[lit("RANGES") >> +space >>
-                    *((range_double | range_single) >> eol)];
-    end = lexeme[lit("ENDATA") >> *space];
-    start =
-        lexeme[name >> rows >> cols >> rhs >> -ranges >> bounds >> quad >> end];
-  }
+/* ************************************************************************* */
+const QPSParser::Data& QPSParser::data() {
+  if (!data_) data_ = std::make_shared<const Data>(fileName_);
+  return *data_;
+}
 
-  qi::rule<boost::spirit::basic_istream_iterator<char>, char()> character;
-  qi::rule<boost::spirit::basic_istream_iterator<char>, Chars()> word, title;
-  qi::rule<boost::spirit::basic_istream_iterator<char>> row, end, col_single,
-      col_double, rhs_single, rhs_double, range_single, range_double, ranges,
-      bound, bound_fr, bounds, quad, quad_l, rows, cols, rhs, name, start;
-};
+/* ************************************************************************* */
+bool QPSParser::hasQuadraticTerms() { return data().hasQuadraticTerms(); }
 
+/* ************************************************************************* */
 QP QPSParser::Parse() {
-  QPSVisitor rawData;
-  std::fstream stream(fileName_.c_str());
-  stream.unsetf(std::ios::skipws);
-  boost::spirit::basic_istream_iterator<char> begin(stream);
-  boost::spirit::basic_istream_iterator<char> last;
-
-  if (!parse(begin, last, MPSGrammar(&rawData)) || begin != last) {
-    throw QPSParserException();
-  }
+  const Data& data = this->data();
+  QP qp;
+  qp.cost.push_back(data.quadraticCost());
+  data.addConstraints(&qp);
+  return qp;
+}
 
-  return rawData.makeQP();
+/* ************************************************************************* */
+LP QPSParser::ParseLP() {
+  const Data& data = this->data();
+  if (data.hasQuadraticTerms())
+    throw QPSParserException(fileName_ +
+                             " has quadratic terms, use Parse() instead");
+  LP lp;
+  lp.cost = data.linearCost();
+  data.addConstraints(&lp);
+  return lp;
 }
 
 }  // namespace gtsam
@@ -18,23 +18,52 @@
 
 #pragma once
 
+#include <gtsam_unstable/linear/LP.h>
 #include <gtsam_unstable/linear/QP.h>
 #include <fstream>
+#include <memory>
 
 namespace gtsam {
 
+/**
+ * Reads quadratic and linear programs in the (free) QPS/MPS format, e.g. the
+ * Maros-Meszaros test set. The file is streamed line by line and only the
+ * non-zero coefficients are kept until the problem is assembled.
+ * Variables become keys X(1), X(2), ... in the order they first appear.
+ * The file is read once, on first use, and shared by all queries.
+ */
 class QPSParser {
 
 private:
   std::string fileName_;
-  struct MPSGrammar;
+  class Data;
+  std::shared_ptr<const Data> data_;
+
+  /// Read the file if not done yet
+  const Data& data();
+
 public:
 
   QPSParser(const std::string& fileName) :
       fileName_(findExampleDataFile(fileName)) {
   }
 
+  /// Parse a quadratic program, throws QPSParserException on malformed input
   QP Parse();
+
+  /**
+   * Whether the file has a QUADOBJ section with non-zero entries, i.e. needs
+   * Parse() rather than ParseLP(). Throws QPSParserException on malformed
+   * input.
+   */
+  bool hasQuadraticTerms();
+
+  /**
+   * Parse a linear program, which avoids the dense Hessian that a QP with
+   * many variables would need. Throws QPSParserException if the file has a
+   * QUADOBJ section with non-zero entries.
+   */
+  LP ParseLP();
 };
 }
 
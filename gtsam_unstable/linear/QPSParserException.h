@@ -18,6 +18,10 @@
 
 #pragma once
 
+#include <gtsam/base/ThreadsafeException.h>
+
+#include <string>
+
 namespace gtsam {
 
 class QPSParserException: public ThreadsafeException<QPSParserException> {
@@ -25,6 +29,10 @@ public:
   QPSParserException() {
   }
 
+  /// Construct with a description of what went wrong, e.g. the offending line
+  explicit QPSParserException(const std::string& description)
+      : description_(description) {}
+
   ~QPSParserException() noexcept override {
   }
 
@@ -18,6 +18,7 @@
 
 #include <gtsam_unstable/linear/LPInitSolver.h>
 #include <gtsam_unstable/linear/LPSolver.h>
+#include <gtsam_unstable/linear/QPSParser.h>
 
 #include <gtsam/base/Testable.h>
 #include <gtsam/inference/FactorGraph-inst.h>
@@ -211,6 +212,36 @@ TEST(LPSolver, TestWithoutInitialValues) {
   CHECK(assert_equal(expectedResult, result));
 }
 
+/* ************************************************************************* */
+// simpleLP1 in QPS format, with one of the rows given as a range
+TEST(LPSolver, ParseLP) {
+  QPSParser parser("LPExample.QPS");
+  EXPECT(!parser.hasQuadraticTerms());
+  LP lp = parser.ParseLP();
+  EXPECT_LONGS_EQUAL(0, lp.equalities.size());
+  EXPECT_LONGS_EQUAL(6, lp.inequalities.size());
+  const auto [result, duals] = LPSolver(lp).optimize();
+  VectorValues expected;
+  expected.insert(Symbol('X', 1), Vector1(8. / 3.));
+  expected.insert(Symbol('X', 2), Vector1(2. / 3.));
+  CHECK(assert_equal(expected, result, 1e-9));
+  DOUBLES_EQUAL(-10. / 3., lp.cost.error(result), 1e-9);
+}
+
+/* ************************************************************************* */
+// A variable fixed to a negative value only gets an equality, no bound x >= 0
+TEST(LPSolver, ParseFixedBound) {
+  LP lp = QPSParser("LPFixedBound.QPS").ParseLP();
+  EXPECT_LONGS_EQUAL(1, lp.equalities.size());
+  EXPECT_LONGS_EQUAL(2, lp.inequalities.size());
+  const auto [result, duals] = LPSolver(lp).optimize();
+  VectorValues expected;
+  expected.insert(Symbol('X', 1), Vector1(-2.0));
+  expected.insert(Symbol('X', 2), Vector1(3.0));
+  CHECK(assert_equal(expected, result, 1e-9));
+  DOUBLES_EQUAL(-5.0, lp.cost.error(result), 1e-9);
+}
+
 /**
  * TODO: More TEST cases:
  * - Infeasible
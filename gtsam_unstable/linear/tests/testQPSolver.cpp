@@ -18,6 +18,7 @@
  */
 
 #include <gtsam_unstable/linear/QPSParser.h>
+#include <gtsam_unstable/linear/QPSParserException.h>
 #include <gtsam_unstable/linear/QPSolver.h>
 
 #include <gtsam/base/Testable.h>
@@ -310,6 +311,17 @@ TEST(QPSolver, QPTEST) { // REQUIRES Jacobian Fix
   CHECK(assert_equal(0.437187500e01, error_actual, 1e-7))
 }
 
+TEST(QPSolver, ParserErrors) {
+  // QPs are rejected as LPs, as are files that cannot be parsed
+  QPSParser parser("QPExample.QPS");
+  EXPECT(parser.hasQuadraticTerms());
+  CHECK_EXCEPTION(parser.ParseLP(), QPSParserException);
+  EXPECT_LONGS_EQUAL(2, parser.Parse().cost.keys().size());
+  CHECK_EXCEPTION(QPSParser("pose2example.txt").Parse(), QPSParserException);
+  CHECK_EXCEPTION(QPSParser("pose2example.txt").hasQuadraticTerms(),
+                  QPSParserException);
+}
+
 /* ************************************************************************* */
 // Create Matlab's test graph as in
 // http://www.mathworks.com/help/optim/ug/quadprog.html
@@ -430,6 +442,75 @@ TEST(QPSolver, infeasibleInitial) {
   CHECK_EXCEPTION(solver.optimize(initialValues), InfeasibleInitialValues);
 }
 
+/* ************************************************************************* */
+// min (x1-a)^2 + (x2-b)^2  s.t.  x1 + x2 <= sum, x1 >= 0, x2 >= 0, x1 <= upper
+QP createTargetQP(double a, double b, double sum = 2.0, double upper = 10.0) {
+  QP qp;
+  qp.cost.add(X(1), I_1x1, a * kOne);
+  qp.cost.add(X(2), I_1x1, b * kOne);
+  qp.inequalities.add(X(1), I_1x1, X(2), I_1x1, sum, 0);
+  qp.inequalities.add(X(1), -I_1x1, 0, 1);
+  qp.inequalities.add(X(2), -I_1x1, 0, 2);
+  qp.inequalities.add(X(1), I_1x1, upper, 3);
+  return qp;
+}
+
+VectorValues createValues(double x1, double x2) {
+  VectorValues values;
+  values.insert(X(1), x1 * kOne);
+  values.insert(X(2), x2 * kOne);
+  return values;
+}
+
+/* ************************************************************************* */
+TEST(QPSolver, warmStart) {
+  const QP first = createTargetQP(2.0, 1.0);
+  const auto [x0, duals0] = QPSolver(first).optimize();
+  CHECK(assert_equal(createValues(1.5, 0.5), x0, 1e-9));
+  CHECK(duals0.exists(0));
+
+  // The previous solution is feasible and x1 + x2 <= 2 stays active
+  const QP second = createTargetQP(2.2, 1.0);
+  VectorValues actual = QPSolver(second).optimize(x0, duals0, true).first;
+  CHECK(assert_equal(createValues(1.6, 0.4), actual, 1e-9));
+
+  // The previous solution violates the shifted constraint, but the solution
+  // on the previous working set is feasible
+  const QP shifted = createTargetQP(2.0, 1.0, 1.8);
+  actual = QPSolver(shifted).optimize(x0, duals0, true).first;
+  CHECK(assert_equal(createValues(1.4, 0.4), actual, 1e-9));
+
+  // Neither is feasible, so we fall back to a cold start
+  const QP bounded = createTargetQP(2.2, 1.0, 2.0, 1.2);
+  actual = QPSolver(bounded).optimize(x0, duals0, true).first;
+  CHECK(assert_equal(createValues(1.2, 0.8), actual, 1e-9));
+}
+
+/* ************************************************************************* */
+TEST(QPSolver, batch) {
+  vector<QP> problems;
+  for (size_t i = 0; i < 8; ++i)
+    problems.push_back(createTargetQP(0.5 * i, 2.0 - 0.2 * i));
+
+  const auto solutions = QPSolver::Optimize(problems);
+  LONGS_EQUAL(problems.size(), solutions.size());
+  for (size_t i = 0; i < problems.size(); ++i) {
+    const VectorValues expected = QPSolver(problems[i]).optimize().first;
+    CHECK(assert_equal(expected, solutions[i].first, 1e-9));
+  }
+
+  // Warm start each problem from the solution of its neighbor
+  vector<pair<VectorValues, VectorValues>> warmStarts(solutions.begin() + 1,
+                                                      solutions.end());
+  warmStarts.push_back(solutions.front());
+  const auto warmSolutions = QPSolver::Optimize(problems, warmStarts);
+  for (size_t i = 0; i < problems.size(); ++i)
+    CHECK(assert_equal(solutions[i].first, warmSolutions[i].first, 1e-9));
+
+  CHECK_EXCEPTION(QPSolver::Optimize(problems, {solutions.front()}),
+                  std::invalid_argument);
+}
+
 /* ************************************************************************* */
 int main() {
   TestResult tr;
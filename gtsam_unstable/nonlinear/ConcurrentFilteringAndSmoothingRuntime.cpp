@@ -0,0 +1,202 @@
+/* ----------------------------------------------------------------------------
+
+ * GTSAM Copyright 2010, Georgia Tech Research Corporation,
+ * Atlanta, Georgia 30332-0415
+ * All Rights Reserved
+ * Authors: Frank Dellaert, et al. (see THANKS for the full author list)
+
+ * See LICENSE for the license information
+
+ * -------------------------------------------------------------------------- */
+
+/**
+ * @file    ConcurrentFilteringAndSmoothingRuntime.cpp
+ * @brief   Runs a ConcurrentIncrementalFilter and a ConcurrentBatchSmoother on
+ *          dedicated threads, synchronizing them whenever the smoother is idle.
+ */
+
+#include <gtsam_unstable/nonlinear/ConcurrentFilteringAndSmoothingRuntime.h>
+
+namespace gtsam {
+
+namespace {
+double secondsSince(std::chrono::steady_clock::time_point start) {
+  return std::chrono::duration<double>(std::chrono::steady_clock::now() - start)
+      .count();
+}
+}  // namespace
+
+/* ************************************************************************* */
+ConcurrentFilteringAndSmoothingRuntime::ConcurrentFilteringAndSmoothingRuntime(
+    const ISAM2Params& filterParameters,
+    const LevenbergMarquardtParams& smootherParameters)
+    : filter_(filterParameters),
+      smoother_(smootherParameters),
+      filterEstimate_(std::make_shared<const Values>()),
+      smootherEstimate_(std::make_shared<const Values>()) {
+  filterThread_ = std::thread([this] { filterLoop(); });
+  smootherThread_ = std::thread([this] { smootherLoop(); });
+}
+
+/* ************************************************************************* */
+ConcurrentFilteringAndSmoothingRuntime::~ConcurrentFilteringAndSmoothingRuntime() {
+  // Stop the filter first: it is the only thread that hands work to the
+  // smoother, so once it is joined no new smoother update can appear.
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stopFilter_ = true;
+  }
+  filterCondition_.notify_one();
+  filterThread_.join();
+
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stopSmoother_ = true;
+  }
+  smootherCondition_.notify_one();
+  smootherThread_.join();
+}
+
+/* ************************************************************************* */
+void ConcurrentFilteringAndSmoothingRuntime::update(
+    const NonlinearFactorGraph& newFactors, const Values& newTheta,
+    const std::optional<FastList<Key> >& keysToMove) {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    rethrowIfFailed();
+    queue_.push_back(Update{newFactors, newTheta, keysToMove, Clock::now()});
+  }
+  filterCondition_.notify_one();
+}
+
+/* ************************************************************************* */
+void ConcurrentFilteringAndSmoothingRuntime::waitUntilIdle() {
+  std::unique_lock<std::mutex> lock(mutex_);
+  idleCondition_.wait(lock, [this] {
+    return error_ ||
+           (queue_.empty() && !filterBusy_ && !smootherBusy_ && !smootherWork_);
+  });
+  rethrowIfFailed();
+}
+
+/* ************************************************************************* */
+std::shared_ptr<const Values>
+ConcurrentFilteringAndSmoothingRuntime::filterEstimate() const {
+  return std::atomic_load(&filterEstimate_);
+}
+
+/* ************************************************************************* */
+std::shared_ptr<const Values>
+ConcurrentFilteringAndSmoothingRuntime::smootherEstimate() const {
+  return std::atomic_load(&smootherEstimate_);
+}
+
+/* ************************************************************************* */
+ConcurrentFilteringAndSmoothingRuntime::Statistics
+ConcurrentFilteringAndSmoothingRuntime::statistics() const {
+  std::lock_guard<std::mutex> lock(statisticsMutex_);
+  return statistics_;
+}
+
+/* ************************************************************************* */
+void ConcurrentFilteringAndSmoothingRuntime::rethrowIfFailed() const {
+  if (error_) std::rethrow_exception(error_);
+}
+
+/* ************************************************************************* */
+void ConcurrentFilteringAndSmoothingRuntime::filterLoop() {
+  while (true) {
+    Update update;
+    {
+      std::unique_lock<std::mutex> lock(mutex_);
+      filterCondition_.wait(
+          lock, [this] { return stopFilter_ || (!queue_.empty() && !error_); });
+      if (queue_.empty() || error_) return;
+      update = std::move(queue_.front());
+      queue_.pop_front();
+      filterBusy_ = true;
+    }
+
+    try {
+      const double waited = secondsSince(update.queued);
+      const Clock::time_point start = Clock::now();
+      filter_.update(update.newFactors, update.newTheta, update.keysToMove);
+      std::atomic_store(&filterEstimate_, std::shared_ptr<const Values>(
+                                              std::make_shared<const Values>(
+                                                  filter_.calculateEstimate())));
+      const double updated = secondsSince(start);
+      {
+        std::lock_guard<std::mutex> lock(statisticsMutex_);
+        statistics_.queueWait.add(waited);
+        statistics_.filterUpdate.add(updated);
+      }
+
+      // Synchronize only if the smoother is not running. Setting smootherBusy_
+      // first keeps the smoother thread away from smoother_ until we are done.
+      bool synchronizeNow = false;
+      {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (!smootherBusy_) smootherBusy_ = synchronizeNow = true;
+      }
+      if (synchronizeNow) {
+        const Clock::time_point syncStart = Clock::now();
+        synchronize(filter_, smoother_);
+        const double synchronized = secondsSince(syncStart);
+        {
+          std::lock_guard<std::mutex> lock(statisticsMutex_);
+          statistics_.synchronization.add(synchronized);
+        }
+        {
+          std::lock_guard<std::mutex> lock(mutex_);
+          smootherWork_ = true;
+        }
+        smootherCondition_.notify_one();
+      }
+
+      std::lock_guard<std::mutex> lock(mutex_);
+      filterBusy_ = false;
+    } catch (...) {
+      std::lock_guard<std::mutex> lock(mutex_);
+      error_ = std::current_exception();
+      filterBusy_ = false;
+      queue_.clear();
+    }
+    idleCondition_.notify_all();
+  }
+}
+
+/* ************************************************************************* */
+void ConcurrentFilteringAndSmoothingRuntime::smootherLoop() {
+  while (true) {
+    {
+      std::unique_lock<std::mutex> lock(mutex_);
+      smootherCondition_.wait(lock,
+                              [this] { return stopSmoother_ || smootherWork_; });
+      // Finish a pending update before honoring a stop request
+      if (!smootherWork_) return;
+      smootherWork_ = false;
+    }
+
+    try {
+      const Clock::time_point start = Clock::now();
+      smoother_.update();
+      std::atomic_store(&smootherEstimate_,
+                        std::shared_ptr<const Values>(std::make_shared<const Values>(
+                            smoother_.calculateEstimate())));
+      const double updated = secondsSince(start);
+      {
+        std::lock_guard<std::mutex> lock(statisticsMutex_);
+        statistics_.smootherUpdate.add(updated);
+      }
+      std::lock_guard<std::mutex> lock(mutex_);
+      smootherBusy_ = false;
+    } catch (...) {
+      std::lock_guard<std::mutex> lock(mutex_);
+      error_ = std::current_exception();
+      // Leave smootherBusy_ set so the filter no longer synchronizes with it
+    }
+    idleCondition_.notify_all();
+  }
+}
+
+}  // namespace gtsam
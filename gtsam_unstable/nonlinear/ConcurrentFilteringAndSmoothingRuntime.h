@@ -0,0 +1,161 @@
+/* ----------------------------------------------------------------------------
+
+ * GTSAM Copyright 2010, Georgia Tech Research Corporation,
+ * Atlanta, Georgia 30332-0415
+ * All Rights Reserved
+ * Authors: Frank Dellaert, et al. (see THANKS for the full author list)
+
+ * See LICENSE for the license information
+
+ * -------------------------------------------------------------------------- */
+
+/**
+ * @file    ConcurrentFilteringAndSmoothingRuntime.h
+ * @brief   Runs a ConcurrentIncrementalFilter and a ConcurrentBatchSmoother on
+ *          dedicated threads, synchronizing them whenever the smoother is idle.
+ */
+
+// \callgraph
+#pragma once
+
+#include <gtsam_unstable/nonlinear/ConcurrentIncrementalFilter.h>
+#include <gtsam_unstable/nonlinear/ConcurrentBatchSmoother.h>
+
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <mutex>
+#include <optional>
+#include <thread>
+
+namespace gtsam {
+
+/**
+ * Threaded runtime for the Concurrent Filtering and Smoothing architecture.
+ *
+ * Measurements passed to update() are queued and applied by a filter thread,
+ * so the caller never blocks on optimization. A second thread runs the batch
+ * smoother. Each time the filter finishes an update and the smoother is idle,
+ * the filter thread calls gtsam::synchronize and hands the smoother a new
+ * update to run; while the smoother is busy the filter keeps running on its
+ * own. The filter and smoother objects are therefore never accessed from two
+ * threads at once, and no locks are taken around the optimizers themselves.
+ *
+ * The latest estimates are published as immutable snapshots that readers
+ * obtain without blocking either thread.
+ */
+class GTSAM_UNSTABLE_EXPORT ConcurrentFilteringAndSmoothingRuntime {
+public:
+  typedef std::shared_ptr<ConcurrentFilteringAndSmoothingRuntime> shared_ptr;
+
+  /** Running latency statistics of one kind of operation, in seconds */
+  struct LatencyStatistics {
+    size_t count = 0;  ///< Number of timed operations
+    double total = 0.0;  ///< Sum of all latencies
+    double max = 0.0;  ///< Largest latency
+
+    /** Average latency, or zero if nothing was timed yet */
+    double mean() const { return count > 0 ? total / count : 0.0; }
+
+    /** Record one latency */
+    void add(double seconds) {
+      ++count;
+      total += seconds;
+      if (seconds > max) max = seconds;
+    }
+  };
+
+  /** Latencies measured by the runtime */
+  struct Statistics {
+    LatencyStatistics filterUpdate;  ///< ConcurrentIncrementalFilter::update
+    LatencyStatistics synchronization;  ///< gtsam::synchronize
+    LatencyStatistics smootherUpdate;  ///< ConcurrentBatchSmoother::update
+    LatencyStatistics queueWait;  ///< From update() until the filter starts on it
+  };
+
+  /** Start the filter and smoother threads */
+  ConcurrentFilteringAndSmoothingRuntime(
+      const ISAM2Params& filterParameters = ISAM2Params(),
+      const LevenbergMarquardtParams& smootherParameters =
+          LevenbergMarquardtParams());
+
+  /** Stop both threads after processing all queued updates */
+  ~ConcurrentFilteringAndSmoothingRuntime();
+
+  ConcurrentFilteringAndSmoothingRuntime(
+      const ConcurrentFilteringAndSmoothingRuntime&) = delete;
+  ConcurrentFilteringAndSmoothingRuntime& operator=(
+      const ConcurrentFilteringAndSmoothingRuntime&) = delete;
+
+  /**
+   * Queue new factors and variables for the filter, see
+   * ConcurrentIncrementalFilter::update. Returns immediately. Rethrows any
+   * exception raised by an earlier filter or smoother update.
+   *
+   * @param newFactors The new factors to be added to the filter
+   * @param newTheta Initialization points for new variables
+   * @param keysToMove An optional set of keys to move from the filter to the smoother
+   */
+  void update(const NonlinearFactorGraph& newFactors,
+              const Values& newTheta = Values(),
+              const std::optional<FastList<Key> >& keysToMove = {});
+
+  /**
+   * Block until all queued updates have been applied by the filter and the
+   * smoother has finished its current update. Rethrows any exception raised
+   * by the worker threads.
+   */
+  void waitUntilIdle();
+
+  /** The filter estimate after the most recently applied update */
+  std::shared_ptr<const Values> filterEstimate() const;
+
+  /** The smoother estimate after its most recent update */
+  std::shared_ptr<const Values> smootherEstimate() const;
+
+  /** A copy of the latency statistics gathered so far */
+  Statistics statistics() const;
+
+private:
+  using Clock = std::chrono::steady_clock;
+
+  struct Update {
+    NonlinearFactorGraph newFactors;
+    Values newTheta;
+    std::optional<FastList<Key> > keysToMove;
+    Clock::time_point queued;
+  };
+
+  void filterLoop();
+  void smootherLoop();
+  void rethrowIfFailed() const;
+
+  ConcurrentIncrementalFilter filter_;
+  ConcurrentBatchSmoother smoother_;
+
+  // Protects the queue, the flags below and error_
+  mutable std::mutex mutex_;
+  std::condition_variable filterCondition_;  ///< Wakes the filter thread
+  std::condition_variable smootherCondition_;  ///< Wakes the smoother thread
+  std::condition_variable idleCondition_;  ///< Wakes waitUntilIdle
+  std::deque<Update> queue_;
+  bool filterBusy_ = false;
+  bool smootherBusy_ = false;  ///< Synchronizing or updating the smoother
+  bool smootherWork_ = false;  ///< Synchronized, smoother update pending
+  bool stopFilter_ = false;
+  bool stopSmoother_ = false;
+  std::exception_ptr error_;
+
+  mutable std::mutex statisticsMutex_;
+  Statistics statistics_;
+
+  // Estimates, swapped atomically so readers never wait for an optimizer
+  std::shared_ptr<const Values> filterEstimate_;
+  std::shared_ptr<const Values> smootherEstimate_;
+
+  std::thread filterThread_;
+  std::thread smootherThread_;
+};
+
+}  // namespace gtsam
@@ -0,0 +1,91 @@
+/* ----------------------------------------------------------------------------
+
+ * GTSAM Copyright 2010, Georgia Tech Research Corporation,
+ * Atlanta, Georgia 30332-0415
+ * All Rights Reserved
+ * Authors: Frank Dellaert, et al. (see THANKS for the full author list)
+
+ * See LICENSE for the license information
+
+ * -------------------------------------------------------------------------- */
+
+/**
+ * @file    testConcurrentFilteringAndSmoothingRuntime.cpp
+ * @brief   Unit tests for the threaded Concurrent Filtering and Smoothing runtime
+ */
+
+#include <gtsam_unstable/nonlinear/ConcurrentFilteringAndSmoothingRuntime.h>
+#include <gtsam/nonlinear/PriorFactor.h>
+#include <gtsam/slam/BetweenFactor.h>
+#include <gtsam/geometry/Pose3.h>
+#include <gtsam/base/TestableAssertions.h>
+#include <CppUnitLite/TestHarness.h>
+
+using namespace std;
+using namespace gtsam;
+
+namespace {
+
+const Pose3 poseInitial;
+const Pose3 poseOdometry( Rot3::RzRyRx(Vector3(0.05, 0.10, -0.75)), Point3(1.0, -0.25, 0.10) );
+
+const SharedDiagonal noisePrior = noiseModel::Isotropic::Sigma(6, 0.10);
+const SharedDiagonal noiseOdometery = noiseModel::Diagonal::Sigmas((Vector(6) << 0.1, 0.1, 0.1, 0.5, 0.5, 0.5).finished());
+
+} // end namespace
+
+/* ************************************************************************* */
+TEST( ConcurrentFilteringAndSmoothingRuntime, odometryChain )
+{
+  ConcurrentFilteringAndSmoothingRuntime runtime;
+
+  // Noise-free odometry, so every consistent estimate equals the ground truth
+  const size_t nrPoses = 20, lag = 4;
+  Values groundTruth;
+  groundTruth.insert(0, poseInitial);
+  for (size_t i = 1; i < nrPoses; ++i)
+    groundTruth.insert(i, groundTruth.at<Pose3>(i - 1).compose(poseOdometry));
+
+  NonlinearFactorGraph prior;
+  prior.addPrior(0, poseInitial, noisePrior);
+  Values initial;
+  initial.insert(0, poseInitial);
+  runtime.update(prior, initial);
+
+  for (size_t i = 1; i < nrPoses; ++i) {
+    NonlinearFactorGraph newFactors;
+    newFactors.emplace_shared<BetweenFactor<Pose3> >(i - 1, i, poseOdometry, noiseOdometery);
+    Values newTheta;
+    newTheta.insert(i, groundTruth.at<Pose3>(i));
+    std::optional<FastList<Key> > keysToMove;
+    if (i > lag) keysToMove = FastList<Key>{i - lag - 1};
+    runtime.update(newFactors, newTheta, keysToMove);
+  }
+  runtime.waitUntilIdle();
+
+  // The filter holds the most recent poses
+  const std::shared_ptr<const Values> filterEstimate = runtime.filterEstimate();
+  LONGS_EQUAL(lag + 1, filterEstimate->size());
+  for (const auto& key_value : *filterEstimate)
+    EXPECT(assert_equal(groundTruth.at<Pose3>(key_value.key),
+                        filterEstimate->at<Pose3>(key_value.key), 1e-6));
+
+  // The smoother holds older poses it has received from the filter so far
+  const std::shared_ptr<const Values> smootherEstimate = runtime.smootherEstimate();
+  CHECK(!smootherEstimate->empty());
+  for (const auto& key_value : *smootherEstimate)
+    EXPECT(assert_equal(groundTruth.at<Pose3>(key_value.key),
+                        smootherEstimate->at<Pose3>(key_value.key), 1e-6));
+
+  const ConcurrentFilteringAndSmoothingRuntime::Statistics statistics =
+      runtime.statistics();
+  LONGS_EQUAL(nrPoses, statistics.filterUpdate.count);
+  LONGS_EQUAL(nrPoses, statistics.queueWait.count);
+  CHECK(statistics.synchronization.count >= 1);
+  LONGS_EQUAL(statistics.synchronization.count, statistics.smootherUpdate.count);
+  CHECK(statistics.filterUpdate.max >= statistics.filterUpdate.mean());
+}
+
+/* ************************************************************************* */
+int main() { TestResult tr; return TestRegistry::runAllTests(tr);}
+/* ************************************************************************* */
@@ -0,0 +1,263 @@
+/* ----------------------------------------------------------------------------
+
+ * GTSAM Copyright 2010, Georgia Tech Research Corporation,
+ * Atlanta, Georgia 30332-0415
+ * All Rights Reserved
+ * Authors: Frank Dellaert, et al. (see THANKS for the full author list)
+
+ * See LICENSE for the license information
+
+ * -------------------------------------------------------------------------- */
+
+/**
+ * @file    PartitionedOptimizer.cpp
+ * @brief   Gauss-Newton optimization that solves METIS submaps independently
+ *          and couples them through a separator system.
+ */
+
+#include <gtsam_unstable/partition/PartitionedOptimizer.h>
+
+#include <gtsam/base/timing.h>
+#include <gtsam/config.h>  // for GTSAM_USE_TBB
+#include <gtsam/inference/MetisIndex.h>
+#include <gtsam/inference/Ordering.h>
+#include <gtsam/linear/GaussianBayesTree.h>
+#include <gtsam/linear/VectorValues.h>
+#include <gtsam/nonlinear/internal/NonlinearOptimizerState.h>
+
+#include <metis.h>
+
+#ifdef GTSAM_USE_TBB
+#include <tbb/blocked_range.h>
+#include <tbb/parallel_for.h>
+#endif
+
+#include <algorithm>
+#include <stdexcept>
+#include <tuple>
+
+namespace gtsam {
+
+typedef internal::NonlinearOptimizerState State;
+
+namespace {
+
+/// Call f(i) for i in [0, n), in parallel with TBB
+template <class FUNC>
+void forEachSubmap(size_t n, const FUNC& f) {
+#ifdef GTSAM_USE_TBB
+  tbb::parallel_for(tbb::blocked_range<size_t>(0, n),
+                    [&](const tbb::blocked_range<size_t>& range) {
+                      for (size_t i = range.begin(); i != range.end(); ++i)
+                        f(i);
+                    });
+#else
+  for (size_t i = 0; i < n; ++i) f(i);
+#endif
+}
+
+/**
+ * Split \c vertices of the METIS graph into two parts without edges between
+ * them and a separator. \c local has to hold -1 for all vertices and is
+ * restored before returning. Returns false if no split was found.
+ */
+bool bisect(const MetisIndex& index, const std::vector<int32_t>& vertices,
+            std::vector<idx_t>* local, std::vector<int32_t> parts[2],
+            std::vector<int32_t>* separator) {
+  for (size_t i = 0; i < vertices.size(); ++i) (*local)[vertices[i]] = i;
+
+  // Induced subgraph in CSR format
+  std::vector<idx_t> xadj, adjncy;
+  xadj.reserve(vertices.size() + 1);
+  xadj.push_back(0);
+  for (int32_t v : vertices) {
+    for (int32_t k = index.xadj()[v]; k < index.xadj()[v + 1]; ++k) {
+      const idx_t u = (*local)[index.adj()[k]];
+      if (u >= 0) adjncy.push_back(u);
+    }
+    xadj.push_back(adjncy.size());
+  }
+  for (int32_t v : vertices) (*local)[v] = -1;
+
+  idx_t nvtxs = vertices.size();
+  std::vector<idx_t> where(nvtxs);
+  if (adjncy.empty()) {
+    // No edges, any split works
+    for (idx_t i = 0; i < nvtxs; ++i) where[i] = 2 * i < nvtxs ? 0 : 1;
+  } else {
+    std::vector<idx_t> vwgt(nvtxs, 1);
+    idx_t options[METIS_NOPTIONS];
+    METIS_SetDefaultOptions(options);
+    idx_t sepsize;
+    if (METIS_ComputeVertexSeparator(&nvtxs, xadj.data(), adjncy.data(),
+                                     vwgt.data(), options, &sepsize,
+                                     where.data()) != METIS_OK)
+      throw std::runtime_error(
+          "PartitionedOptimizer: METIS could not compute a separator");
+  }
+
+  for (idx_t i = 0; i < nvtxs; ++i) {
+    if (where[i] == 2)
+      separator->push_back(vertices[i]);
+    else
+      parts[where[i]].push_back(vertices[i]);
+  }
+  return !parts[0].empty() && !parts[1].empty();
+}
+
+/**
+ * Solve for the frontal variables of all cliques of a Bayes tree, top-down,
+ * given the values of the variables that its roots are conditioned on in
+ * \c x. The solution is added to \c x.
+ */
+void backSubstitute(const GaussianBayesTree& bayesTree, VectorValues* x) {
+  std::vector<GaussianBayesTree::sharedClique> stack(bayesTree.roots().begin(),
+                                                     bayesTree.roots().end());
+  while (!stack.empty()) {
+    const GaussianBayesTree::sharedClique clique = stack.back();
+    stack.pop_back();
+    x->insert(clique->conditional()->solve(*x));
+    stack.insert(stack.end(), clique->children.begin(), clique->children.end());
+  }
+}
+
+}  // namespace
+
+/* ************************************************************************* */
+PartitionedOptimizer::PartitionedOptimizer(
+    const NonlinearFactorGraph& graph, const Values& initialValues,
+    const PartitionedOptimizerParams& params)
+    : NonlinearOptimizer(graph, std::unique_ptr<State>(new State(
+                                    initialValues, graph.error(initialValues)))),
+      params_(params),
+      partition_(PartitionGraph(graph, params.maxSubmapSize)) {}
+
+/* ************************************************************************* */
+PartitionedOptimizer::Partition PartitionedOptimizer::PartitionGraph(
+    const NonlinearFactorGraph& graph, size_t maxSubmapSize) {
+  gttic(PartitionedOptimizer_PartitionGraph);
+  const MetisIndex index(graph);
+  std::vector<idx_t> local(index.nValues(), -1);
+
+  std::vector<std::vector<int32_t>> pending(1), submaps;
+  for (size_t v = 0; v < index.nValues(); ++v) pending[0].push_back(v);
+  std::vector<int32_t> separator;
+  while (!pending.empty()) {
+    std::vector<int32_t> vertices = std::move(pending.back());
+    pending.pop_back();
+    if (vertices.empty()) continue;
+    if (vertices.size() > std::max<size_t>(maxSubmapSize, 1)) {
+      std::vector<int32_t> parts[2], partSeparator;
+      if (bisect(index, vertices, &local, parts, &partSeparator)) {
+        separator.insert(separator.end(), partSeparator.begin(),
+                         partSeparator.end());
+        pending.push_back(std::move(parts[1]));
+        pending.push_back(std::move(parts[0]));
+        continue;
+      }
+    }
+    submaps.push_back(std::move(vertices));
+  }
+
+  auto toKeys = [&index](const std::vector<int32_t>& vertices) {
+    KeyVector keys;
+    keys.reserve(vertices.size());
+    for (int32_t v : vertices) keys.push_back(index.intToKey(v));
+    std::sort(keys.begin(), keys.end());
+    return keys;
+  };
+  Partition result;
+  for (const auto& vertices : submaps) result.submaps.push_back(toKeys(vertices));
+  result.separator = toKeys(separator);
+  return result;
+}
+
+/* ************************************************************************* */
+VectorValues PartitionedOptimizer::Solve(const GaussianFactorGraph& linear,
+                                         const Partition& partition) {
+  gttic(PartitionedOptimizer_Solve);
+  const size_t n = partition.submaps.size();
+
+  // Factors with an interior variable belong to its submap, all others only
+  // involve separator variables
+  FastMap<Key, size_t> submapOf;
+  for (size_t i = 0; i < n; ++i)
+    for (Key key : partition.submaps[i]) submapOf.emplace(key, i);
+  std::vector<GaussianFactorGraph> submapGraphs(n);
+  GaussianFactorGraph separatorGraph;
+  for (const auto& factor : linear) {
+    if (!factor) continue;
+    size_t submap = n;
+    for (Key key : *factor) {
+      const auto it = submapOf.find(key);
+      if (it != submapOf.end()) {
+        submap = it->second;
+        break;
+      }
+    }
+    (submap < n ? submapGraphs[submap] : separatorGraph).push_back(factor);
+  }
+
+  // Eliminate the interior of every submap multifrontally, in a COLAMD
+  // ordering of the submap with its separator variables constrained last
+  std::vector<KeyVector> submapSeparators(n);
+  std::vector<GaussianBayesTree::shared_ptr> bayesTrees(n);
+  std::vector<GaussianFactorGraph::shared_ptr> marginals(n);
+  forEachSubmap(n, [&](size_t i) {
+    const VariableIndex variableIndex(submapGraphs[i]);
+    for (const auto& [key, factors] : variableIndex)
+      if (!submapOf.count(key)) submapSeparators[i].push_back(key);
+    Ordering ordering =
+        Ordering::ColamdConstrainedLast(variableIndex, submapSeparators[i]);
+    ordering.resize(ordering.size() - submapSeparators[i].size());
+    std::tie(bayesTrees[i], marginals[i]) =
+        submapGraphs[i].eliminatePartialMultifrontal(
+            ordering, EliminationTraits<GaussianFactorGraph>::DefaultEliminate,
+            std::cref(variableIndex));
+  });
+
+  // Solve the separator system, submaps that are not connected to it leave
+  // factors without variables
+  for (const auto& marginal : marginals)
+    for (const auto& factor : *marginal)
+      if (factor && !factor->empty()) separatorGraph.push_back(factor);
+  VectorValues delta =
+      separatorGraph.empty() ? VectorValues() : separatorGraph.optimize();
+
+  // Back-substitute into every submap, starting from the separator variables
+  // it is conditioned on
+  std::vector<VectorValues> solutions(n);
+  forEachSubmap(n, [&](size_t i) {
+    for (Key key : submapSeparators[i]) solutions[i].insert(key, delta.at(key));
+    backSubstitute(*bayesTrees[i], &solutions[i]);
+  });
+  for (size_t i = 0; i < n; ++i)
+    for (Key key : partition.submaps[i]) delta.insert(key, solutions[i].at(key));
+  return delta;
+}
+
+/* ************************************************************************* */
+GaussianFactorGraph::shared_ptr PartitionedOptimizer::iterate() {
+  gttic(PartitionedOptimizer_Iterate);
+
+  // Linearize graph
+  gttic(PartitionedOptimizer_Linearize);
+  GaussianFactorGraph::shared_ptr linear = graph_.linearize(state_->values);
+  gttoc(PartitionedOptimizer_Linearize);
+
+  // Solve submaps and separator
+  const VectorValues delta = Solve(*linear, partition_);
+
+  // Maybe show output
+  if (params_.verbosity >= NonlinearOptimizerParams::DELTA)
+    delta.print("delta");
+
+  // Create new state with new values and new error
+  Values newValues = state_->values.retract(delta);
+  state_.reset(new State(std::move(newValues), graph_.error(newValues),
+                         state_->iterations + 1));
+
+  return linear;
+}
+
+}  // namespace gtsam
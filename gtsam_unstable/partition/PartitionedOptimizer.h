@@ -0,0 +1,121 @@
+/* ----------------------------------------------------------------------------
+
+ * GTSAM Copyright 2010, Georgia Tech Research Corporation,
+ * Atlanta, Georgia 30332-0415
+ * All Rights Reserved
+ * Authors: Frank Dellaert, et al. (see THANKS for the full author list)
+
+ * See LICENSE for the license information
+
+ * -------------------------------------------------------------------------- */
+
+/**
+ * @file    PartitionedOptimizer.h
+ * @brief   Gauss-Newton optimization that solves METIS submaps independently
+ *          and couples them through a separator system.
+ */
+
+#pragma once
+
+#include <gtsam_unstable/dllexport.h>
+#include <gtsam/linear/GaussianFactorGraph.h>
+#include <gtsam/nonlinear/NonlinearOptimizer.h>
+
+#include <vector>
+
+namespace gtsam {
+
+class PartitionedOptimizer;
+
+/** Parameters for PartitionedOptimizer, inherits from
+ * NonlinearOptimizerParams.
+ */
+class GTSAM_UNSTABLE_EXPORT PartitionedOptimizerParams
+    : public NonlinearOptimizerParams {
+ public:
+  using OptimizerType = PartitionedOptimizer;
+
+  /// Submaps with more variables than this are bisected further
+  size_t maxSubmapSize = 1000;
+};
+
+/**
+ * Gauss-Newton optimization of a factor graph that is cut into submaps.
+ *
+ * The variables are recursively bisected with METIS vertex separators until
+ * every submap has at most PartitionedOptimizerParams::maxSubmapSize
+ * variables. No factor involves the interior variables of two submaps, so in
+ * every iteration the interior of each submap is eliminated independently,
+ * multifrontally in a COLAMD ordering with the separator constrained last,
+ * leaving a Bayes tree conditioned on the separator and a marginal on the
+ * separator. The separator system, made of these marginals and the factors
+ * between separator variables only, is solved, and each submap is then
+ * back-substituted independently. The submap steps run in parallel when TBB
+ * is enabled.
+ *
+ * Everything exchanged between a submap and the separator solve is a
+ * GaussianFactorGraph, a GaussianBayesTree or a VectorValues.
+ */
+class GTSAM_UNSTABLE_EXPORT PartitionedOptimizer : public NonlinearOptimizer {
+ public:
+  /// Variables of the submaps and of the separator between them
+  struct Partition {
+    std::vector<KeyVector> submaps;  ///< Interior variables of each submap
+    KeyVector separator;             ///< Variables shared between submaps
+  };
+
+ protected:
+  PartitionedOptimizerParams params_;
+  Partition partition_;
+
+ public:
+  /// @name Standard interface
+  /// @{
+
+  /** Standard constructor, partitions the graph.
+   * @param graph The nonlinear factor graph to optimize
+   * @param initialValues The initial variable assignments
+   * @param params The optimization parameters
+   */
+  PartitionedOptimizer(
+      const NonlinearFactorGraph& graph, const Values& initialValues,
+      const PartitionedOptimizerParams& params = PartitionedOptimizerParams());
+
+  /// Cut the variables of \c graph into submaps of at most \c maxSubmapSize
+  /// variables, unless METIS finds no further separator
+  static Partition PartitionGraph(const NonlinearFactorGraph& graph,
+                                  size_t maxSubmapSize);
+
+  /// Solve a linear system with the structure of \c partition, submap by
+  /// submap and then the separator
+  static VectorValues Solve(const GaussianFactorGraph& linear,
+                            const Partition& partition);
+
+  /// @}
+
+  /// @name Advanced interface
+  /// @{
+
+  /** Virtual destructor */
+  ~PartitionedOptimizer() override {}
+
+  /**
+   * Perform a single iteration, returning GaussianFactorGraph corresponding to
+   * the linearized factor graph.
+   */
+  GaussianFactorGraph::shared_ptr iterate() override;
+
+  /** Read-only access the parameters */
+  const PartitionedOptimizerParams& params() const { return params_; }
+
+  /** The submaps and separator used in every iteration */
+  const Partition& partition() const { return partition_; }
+
+  /// @}
+
+ protected:
+  /** Access the parameters (base class version) */
+  const NonlinearOptimizerParams& _params() const override { return params_; }
+};
+
+}  // namespace gtsam
@@ -0,0 +1,119 @@
+/* ----------------------------------------------------------------------------
+
+ * GTSAM Copyright 2010, Georgia Tech Research Corporation,
+ * Atlanta, Georgia 30332-0415
+ * All Rights Reserved
+ * Authors: Frank Dellaert, et al. (see THANKS for the full author list)
+
+ * See LICENSE for the license information
+
+ * -------------------------------------------------------------------------- */
+
+/**
+ * @file    testPartitionedOptimizer.cpp
+ * @brief   Unit tests for PartitionedOptimizer
+ */
+
+#include <gtsam_unstable/partition/PartitionedOptimizer.h>
+#include <gtsam/geometry/Pose2.h>
+#include <gtsam/nonlinear/GaussNewtonOptimizer.h>
+#include <gtsam/slam/BetweenFactor.h>
+#include <gtsam/base/TestableAssertions.h>
+
+#include <CppUnitLite/TestHarness.h>
+
+#include <set>
+
+using namespace std;
+using namespace gtsam;
+
+namespace {
+
+const auto noise = noiseModel::Isotropic::Sigma(3, 0.1);
+
+// Pose2 grid with a prior on the first pose and perturbed initial values
+void createGrid(size_t n, NonlinearFactorGraph* graph, Values* initial) {
+  graph->addPrior(0, Pose2(), noise);
+  for (size_t i = 0; i < n; ++i) {
+    for (size_t j = 0; j < n; ++j) {
+      const Key key = i * n + j;
+      if (j + 1 < n)
+        graph->emplace_shared<BetweenFactor<Pose2>>(key, key + 1,
+                                                    Pose2(0, 1, 0), noise);
+      if (i + 1 < n)
+        graph->emplace_shared<BetweenFactor<Pose2>>(key, key + n,
+                                                    Pose2(1, 0, 0), noise);
+      initial->insert(key, Pose2(i + 0.1 * std::sin(key), j - 0.1 * std::cos(key),
+                                 0.05 * std::sin(3.0 * key)));
+    }
+  }
+}
+
+}  // namespace
+
+/* ************************************************************************* */
+TEST(PartitionedOptimizer, PartitionGraph) {
+  NonlinearFactorGraph graph;
+  Values initial;
+  createGrid(8, &graph, &initial);
+
+  const PartitionedOptimizer::Partition partition =
+      PartitionedOptimizer::PartitionGraph(graph, 10);
+  CHECK(partition.submaps.size() > 2);
+  CHECK(!partition.separator.empty());
+
+  // Every variable is in exactly one submap or in the separator
+  FastMap<Key, size_t> submapOf;
+  size_t count = partition.separator.size();
+  for (size_t i = 0; i < partition.submaps.size(); ++i) {
+    CHECK(!partition.submaps[i].empty());
+    EXPECT(partition.submaps[i].size() <= 10);
+    count += partition.submaps[i].size();
+    for (Key key : partition.submaps[i]) submapOf[key] = i;
+  }
+  EXPECT_LONGS_EQUAL(64, count);
+  for (Key key : partition.separator) EXPECT(!submapOf.count(key));
+
+  // No factor connects the interiors of two submaps
+  for (const auto& factor : graph) {
+    std::set<size_t> submaps;
+    for (Key key : *factor)
+      if (submapOf.count(key)) submaps.insert(submapOf[key]);
+    EXPECT(submaps.size() <= 1);
+  }
+}
+
+/* ************************************************************************* */
+TEST(PartitionedOptimizer, Solve) {
+  NonlinearFactorGraph graph;
+  Values initial;
+  createGrid(8, &graph, &initial);
+  const GaussianFactorGraph linear = *graph.linearize(initial);
+
+  const VectorValues expected = linear.optimize();
+  for (size_t maxSubmapSize : {1, 10, 1000}) {
+    const auto partition = PartitionedOptimizer::PartitionGraph(graph, maxSubmapSize);
+    EXPECT(assert_equal(expected, PartitionedOptimizer::Solve(linear, partition),
+                        1e-8));
+  }
+}
+
+/* ************************************************************************* */
+TEST(PartitionedOptimizer, optimize) {
+  NonlinearFactorGraph graph;
+  Values initial;
+  createGrid(8, &graph, &initial);
+
+  const Values expected = GaussNewtonOptimizer(graph, initial).optimize();
+
+  PartitionedOptimizerParams params;
+  params.maxSubmapSize = 10;
+  PartitionedOptimizer optimizer(graph, initial, params);
+  CHECK(optimizer.partition().submaps.size() > 2);
+  EXPECT(assert_equal(expected, optimizer.optimize(), 1e-6));
+  EXPECT_DOUBLES_EQUAL(0.0, optimizer.error(), 1e-9);
+}
+
+/* ************************************************************************* */
+int main() { TestResult tr; return TestRegistry::runAllTests(tr); }
+/* ************************************************************************* */
@@ -0,0 +1,146 @@
+/* ----------------------------------------------------------------------------
+
+ * GTSAM Copyright 2010, Georgia Tech Research Corporation,
+ * Atlanta, Georgia 30332-0415
+ * All Rights Reserved
+ * Authors: Frank Dellaert, et al. (see THANKS for the full author list)
+
+ * See LICENSE for the license information
+
+ * -------------------------------------------------------------------------- */
+
+/**
+ * @file   timeActiveSetSolvers.cpp
+ * @brief  Runs the active-set QP and LP solvers over a set of QPS problems,
+ *         e.g. the Maros-Meszaros test set, and reports parse and solve
+ *         times, iterations and peak memory as CSV
+ */
+
+#include <gtsam_unstable/linear/LPSolver.h>
+#include <gtsam_unstable/linear/QPSParser.h>
+#include <gtsam_unstable/linear/QPSolver.h>
+
+#include <chrono>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#ifndef _WIN32
+#include <sys/resource.h>
+#endif
+
+using namespace std;
+using namespace gtsam;
+
+using Clock = chrono::steady_clock;
+
+namespace {
+
+double secondsSince(const Clock::time_point& start) {
+  return chrono::duration<double>(Clock::now() - start).count();
+}
+
+// Peak resident set size of the process so far, in MB
+double peakMemoryMB() {
+#ifndef _WIN32
+  struct rusage usage;
+  if (getrusage(RUSAGE_SELF, &usage) == 0) {
+#ifdef __APPLE__
+    return usage.ru_maxrss / (1024.0 * 1024.0);  // bytes
+#else
+    return usage.ru_maxrss / 1024.0;  // kilobytes
+#endif
+  }
+#endif
+  return 0.0;
+}
+
+struct Result {
+  VectorValues x;
+  size_t iterations;
+  double initTime, solveTime;
+};
+
+// Run the active-set iterations as optimize() does, counting them
+template <class SOLVER, class INITSOLVER, class PROBLEM>
+Result solve(const PROBLEM& problem) {
+  Result result;
+  Clock::time_point start = Clock::now();
+  const VectorValues init = INITSOLVER(problem).solve();
+  result.initTime = secondsSince(start);
+
+  start = Clock::now();
+  const SOLVER solver(problem);
+  typename SOLVER::State state(
+      init, VectorValues(),
+      solver.identifyActiveConstraints(problem.inequalities, init,
+                                       VectorValues(), false),
+      false, 0);
+  while (!state.converged) state = solver.iterate(state);
+  result.solveTime = secondsSince(start);
+  result.x = state.values;
+  result.iterations = state.iterations;
+  return result;
+}
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+  if (argc > 1 && string(argv[1]) == "--help") {
+    cout << "Usage: timeActiveSetSolvers [file.QPS ...]\n"
+            "Without arguments, the QPS examples in the data folder are used."
+         << endl;
+    return 0;
+  }
+  vector<string> files(argv + 1, argv + argc);
+  if (files.empty())
+    files = {"QPExample.QPS", "HS21.QPS", "HS35.QPS", "HS35MOD.QPS",
+             "HS51.QPS",      "HS52.QPS", "HS268.QPS", "QPTEST.QPS"};
+
+  cout << "problem,type,variables,equalities,inequalities,parse [s],"
+          "init [s],solve [s],iterations,cost,peak memory [MB]"
+       << endl;
+  for (const string& file : files) {
+    try {
+      QPSParser parser(file);
+
+      // Problems without quadratic terms are solved as LPs, which need no
+      // dense Hessian
+      const Clock::time_point start = Clock::now();
+      const bool isLP = !parser.hasQuadraticTerms();
+      LP lp;
+      QP qp;
+      if (isLP)
+        lp = parser.ParseLP();
+      else
+        qp = parser.Parse();
+      const double parseTime = secondsSince(start);
+
+      Result result;
+      double cost;
+      size_t nrVariables, nrEqualities, nrInequalities;
+      if (isLP) {
+        result = solve<LPSolver, LPInitSolver>(lp);
+        cost = lp.cost.error(result.x);
+        nrVariables = lp.cost.size();
+        nrEqualities = lp.equalities.size();
+        nrInequalities = lp.inequalities.size();
+      } else {
+        result = solve<QPSolver, QPInitSolver>(qp);
+        cost = qp.cost.error(result.x);
+        nrVariables = qp.cost.keys().size();
+        nrEqualities = qp.equalities.size();
+        nrInequalities = qp.inequalities.size();
+      }
+
+      cout << file << "," << (isLP ? "LP" : "QP") << "," << nrVariables << ","
+           << nrEqualities << "," << nrInequalities << "," << parseTime << ","
+           << result.initTime << "," << result.solveTime << ","
+           << result.iterations << "," << cost << "," << peakMemoryMB()
+           << endl;
+    } catch (const exception& e) {
+      cerr << file << ": " << e.what() << endl;
+    }
+  }
+  return 0;
+}
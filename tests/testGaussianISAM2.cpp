@@ -24,6 +24,8 @@
 
 #include <CppUnitLite/TestHarness.h>
 
+#include <atomic>
+#include <thread>
 
 using namespace std;
 using namespace gtsam;
@@ -611,6 +613,28 @@ TEST(ISAM2, slamlike_solution_partial_relinearization_check)
   CHECK(isam_check(fullgraph, fullinit, isam, *this, result_));
 }
 
+/* ************************************************************************* */
+TEST(ISAM2, slamlike_solution_incremental_ordering)
+{
+  ISAM2Params params(ISAM2GaussNewtonParams(0.001), 0.0, 0, false);
+  params.incrementalOrdering = true;
+  {
+    Values fullinit;
+    NonlinearFactorGraph fullgraph;
+    ISAM2 isam = createSlamlikeISAM2(&fullinit, &fullgraph, params);
+    CHECK(isam_check(fullgraph, fullinit, isam, *this, result_));
+  }
+
+  // Never reorder, only reuse the previous elimination order
+  params.reorderFillFactor = std::numeric_limits<double>::infinity();
+  {
+    Values fullinit;
+    NonlinearFactorGraph fullgraph;
+    ISAM2 isam = createSlamlikeISAM2(&fullinit, &fullgraph, params);
+    CHECK(isam_check(fullgraph, fullinit, isam, *this, result_));
+  }
+}
+
 namespace {
   bool checkMarginalizeLeaves(ISAM2& isam, const FastList<Key>& leafKeys) {
     Matrix expectedAugmentedHessian, expected3AugmentedHessian;
@@ -802,6 +826,70 @@ TEST(ISAM2, marginalCovariance)
   EXPECT(assert_equal(expected, actual));
 }
 
+/* ************************************************************************* */
+namespace {
+  bool checkSnapshot(const ISAM2& isam, const ISAM2Snapshot& snapshot) {
+    const Values estimate = isam.calculateEstimate();
+    bool ok = assert_equal(estimate, snapshot.calculateEstimate());
+    for (Key key : estimate.keys())
+      ok = assert_equal(isam.marginalCovariance(key),
+                        snapshot.marginalCovariance(key), 1e-8) && ok;
+    return ok;
+  }
+}
+
+/* ************************************************************************* */
+TEST(ISAM2, snapshots)
+{
+  ISAM2Params params(ISAM2GaussNewtonParams(0.001), 0.0, 0, false, true);
+  params.enableSnapshots = true;
+  ISAM2 isam = createSlamlikeISAM2(nullptr, nullptr, params);
+
+  const ISAM2Snapshot::shared_ptr first = isam.snapshot();
+  CHECK(first);
+  EXPECT(checkSnapshot(isam, *first));
+  const Values firstEstimate = first->calculateEstimate();
+
+  // Marginalizing publishes a new version and leaves the old one untouched
+  isam.marginalizeLeaves(FastList<Key>{0});
+  const ISAM2Snapshot::shared_ptr second = isam.snapshot();
+  EXPECT_LONGS_EQUAL(first->version() + 1, second->version());
+  EXPECT(!second->exists(0));
+  EXPECT(checkSnapshot(isam, *second));
+  EXPECT(assert_equal(firstEstimate, first->calculateEstimate()));
+  const Values secondEstimate = second->calculateEstimate();
+
+  // A reader polls snapshots while the next updates run
+  std::atomic<bool> done(false);
+  bool versionsIncrease = true;
+  std::thread reader([&] {
+    size_t version = 0;
+    while (!done) {
+      const ISAM2Snapshot::shared_ptr snapshot = isam.snapshot();
+      if (snapshot->version() < version) versionsIncrease = false;
+      version = snapshot->version();
+      snapshot->calculateEstimate();
+    }
+  });
+  for (size_t i = 11; i < 20; ++i) {
+    NonlinearFactorGraph newfactors;
+    newfactors.emplace_shared<BetweenFactor<Pose2>>(i, i + 1, Pose2(1.0, 0.0, 0.0), odoNoise);
+    Values init;
+    init.insert(i + 1, Pose2(double(i + 1) + 0.1, -0.1, 0.01));
+    isam.update(newfactors, init);
+  }
+  done = true;
+  reader.join();
+  EXPECT(versionsIncrease);
+
+  const ISAM2Snapshot::shared_ptr last = isam.snapshot();
+  EXPECT_LONGS_EQUAL(second->version() + 9, last->version());
+  EXPECT(checkSnapshot(isam, *last));
+  EXPECT(assert_equal(secondEstimate, second->calculateEstimate()));
+  EXPECT(assert_equal(isam.calculateEstimate<Pose2>(20),
+                      last->calculateEstimate<Pose2>(20)));
+}
+
 /* ************************************************************************* */
 TEST(ISAM2, calculate_nnz)
 {
@@ -36,6 +36,9 @@
 #include <gtsam/sam/BearingFactor.h>
 #include <gtsam/geometry/Pose2.h>
 
+#include <atomic>
+#include <thread>
+
 using namespace std;
 using namespace gtsam;
 
@@ -508,6 +511,30 @@ TEST(GncOptimizer, makeWeightedGraph) {
   CHECK(assert_equal(expected, actual));
 }
 
+/* ************************************************************************* */
+TEST(GncOptimizer, updateWeightedGraph) {
+  NonlinearFactorGraph nfg = example::nonlinearFactorGraphWithGivenSigma(0.1);
+  Values initial;
+  initial.insert(X(1), Point2(3, 3));
+
+  GncParams<LevenbergMarquardtParams> gncParams;
+  auto gnc = GncOptimizer<GncParams<LevenbergMarquardtParams>>(nfg, initial,
+                                                               gncParams);
+
+  Vector previousWeights = Vector::Ones(1), weights = Vector::Ones(1);
+  weights[0] = 1e-4;
+  NonlinearFactorGraph actual = gnc.makeWeightedGraph(previousWeights);
+  const auto unchanged = actual[0];
+
+  // Same weights: the factor is kept as is
+  gnc.updateWeightedGraph(previousWeights, previousWeights, actual);
+  CHECK(actual[0] == unchanged);
+
+  // Changed weights: same result as re-creating the weighted graph
+  gnc.updateWeightedGraph(previousWeights, weights, actual);
+  CHECK(assert_equal(gnc.makeWeightedGraph(weights), actual));
+}
+
 /* ************************************************************************* */
 TEST(GncOptimizer, optimizeSimple) {
   auto fg = example::createReallyNonlinearFactorGraph();
@@ -771,6 +798,52 @@ TEST(GncOptimizer, optimizeSmallPoseGraph) {
   CHECK(assert_equal(expected, actual, 1e-3));  // yay! we are robust to outliers!
 }
 
+/* ************************************************************************* */
+// A prior that, like a Python CustomFactor, may only be evaluated on the thread
+// that created it.
+class NonSendablePrior : public PriorFactor<Point2> {
+  std::thread::id owner_ = std::this_thread::get_id();
+  std::shared_ptr<std::atomic<bool>> wrongThread_ =
+      std::make_shared<std::atomic<bool>>(false);
+
+ public:
+  using PriorFactor<Point2>::PriorFactor;
+
+  bool sendable() const override { return false; }
+
+  NonlinearFactor::shared_ptr clone() const override {
+    return std::make_shared<NonSendablePrior>(*this);
+  }
+
+  double error(const Values& values) const override {
+    if (std::this_thread::get_id() != owner_) *wrongThread_ = true;
+    return PriorFactor<Point2>::error(values);
+  }
+
+  bool evaluatedOnWrongThread() const { return *wrongThread_; }
+};
+
+TEST(GncOptimizer, nonSendableFactors) {
+  auto model = noiseModel::Isotropic::Sigma(2, 0.1);
+  NonlinearFactorGraph fg;
+  for (size_t i = 0; i < 100; i++)
+    fg.emplace_shared<NonSendablePrior>(X(1), Point2(0, 0), model);
+  fg.emplace_shared<NonSendablePrior>(X(1), Point2(1, 0), model);
+
+  Values initial;
+  initial.insert(X(1), Point2(1, 0));
+  GncParams<GaussNewtonParams> gncParams;
+  auto gnc = GncOptimizer<GncParams<GaussNewtonParams>>(fg, initial, gncParams);
+  Values result = gnc.optimize();
+  CHECK(assert_equal(Point2(0, 0), result.at<Point2>(X(1)), 1e-3));
+  DOUBLES_EQUAL(0.0, gnc.getWeights()[100], 1e-6);
+
+  // Residuals of non-sendable factors are not computed in worker threads
+  for (const auto& factor : fg)
+    EXPECT(!std::static_pointer_cast<NonSendablePrior>(factor)
+                ->evaluatedOnWrongThread());
+}
+
 /* ************************************************************************* */
 TEST(GncOptimizer, knownInliersAndOutliers) {
   auto fg = example::sharedNonRobustFactorGraphWithOutliers();
@@ -191,6 +191,43 @@ TEST(Marginals, planarSLAMmarginals) {
   testJointMarginals(marginals);
 }
 
+/* ************************************************************************* */
+TEST(Marginals, marginalCovariances) {
+  // Odometry chain with loop closures and landmarks, so that the Bayes tree
+  // has cliques with several frontals and non-trivial separators.
+  NonlinearFactorGraph fg;
+  Values vals;
+  fg.addPrior(0, Pose2(), noiseModel::Diagonal::Sigmas(Vector3(0.3, 0.3, 0.1)));
+  auto odometryNoise = noiseModel::Diagonal::Sigmas(Vector3(0.2, 0.2, 0.1));
+  for (size_t i = 0; i < 10; ++i) {
+    vals.insert(i, Pose2(i, 0.1 * i, 0.05 * i));
+    if (i > 0)
+      fg.emplace_shared<BetweenFactor<Pose2>>(i - 1, i, Pose2(1, 0.1, 0.05),
+                                              odometryNoise);
+  }
+  fg.emplace_shared<BetweenFactor<Pose2>>(0, 5, Pose2(5, 0.5, 0.25), odometryNoise);
+  fg.emplace_shared<BetweenFactor<Pose2>>(3, 9, Pose2(6, 0.6, 0.3), odometryNoise);
+  auto measurementNoise = noiseModel::Diagonal::Sigmas(Vector2(0.1, 0.2));
+  for (size_t j = 100; j < 103; ++j) {
+    vals.insert(j, Point2(3.0 * (j - 100), 2.0));
+    for (size_t i = 3 * (j - 100); i < 3 * (j - 100) + 3; ++i) {
+      const Pose2 pose = vals.at<Pose2>(i);
+      const Point2 point = vals.at<Point2>(j);
+      fg.emplace_shared<BearingRangeFactor<Pose2, Point2>>(
+          i, j, pose.bearing(point), pose.range(point), measurementNoise);
+    }
+  }
+
+  for (auto factorization : {Marginals::CHOLESKY, Marginals::QR}) {
+    Marginals marginals(fg, vals, factorization);
+    const FastMap<Key, Matrix> covariances = marginals.marginalCovariances();
+    LONGS_EQUAL(vals.size(), covariances.size());
+    for (const Key key : vals.keys())
+      EXPECT(assert_equal(marginals.marginalCovariance(key),
+                          covariances.at(key), 1e-8));
+  }
+}
+
 /* ************************************************************************* */
 TEST(Marginals, order) {
   NonlinearFactorGraph fg;
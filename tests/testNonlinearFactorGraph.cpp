@@ -63,6 +63,42 @@ TEST( NonlinearFactorGraph, error )
   DOUBLES_EQUAL( 5.625, actual2, 1e-9 );
 }
 
+/* ************************************************************************* */
+TEST(NonlinearFactorGraph, errorSummationOrder) {
+  // A chain large enough to be split across threads
+  NonlinearFactorGraph fg;
+  Values values;
+  const auto model = noiseModel::Isotropic::Sigma(3, 0.1);
+  fg.addPrior(X(0), Pose2(), model);
+  values.insert(X(0), Pose2(0.01, -0.02, 0.003));
+  for (size_t i = 1; i < 2000; ++i) {
+    fg.emplace_shared<BetweenFactor<Pose2>>(X(i - 1), X(i), Pose2(1, 0, 0.01),
+                                            model);
+    values.insert(X(i), Pose2(i + 0.01 * std::sin(i), 0.02 * std::cos(i),
+                              0.01 * i));
+  }
+  fg.push_back(NonlinearFactor::shared_ptr());
+
+  // The total is summed in factor order, so it is reproducible and exactly
+  // equal to the serial sum
+  double expected = 0.0;
+  for (const auto& factor : fg)
+    if (factor) expected += factor->error(values);
+  const double actual = fg.error(values);
+  EXPECT(expected == actual);
+  EXPECT(actual == fg.error(values));
+
+  // Same for the linearized graph
+  const GaussianFactorGraph::shared_ptr linear = fg.linearize(values);
+  const VectorValues delta = linear->gradientAtZero();
+  double expectedLinear = 0.0;
+  for (const auto& factor : *linear)
+    if (factor) expectedLinear += factor->error(delta);
+  EXPECT(expectedLinear == linear->error(delta));
+  EXPECT(assert_equal(linear->gradientAtZero(),
+                      linear->gradient(VectorValues::Zero(delta)), 1e-9));
+}
+
 /* ************************************************************************* */
 TEST( NonlinearFactorGraph, keys )
 {
@@ -131,6 +167,92 @@ TEST( NonlinearFactorGraph, linearize )
   CHECK(assert_equal(expected,linearFG)); // Needs correct linearizations
 }
 
+/* ************************************************************************* */
+TEST(NonlinearFactorGraph, linearizeRobust)
+{
+  // Robust factors sharing m-estimators are reweighted together, check that
+  // this gives the same result as linearizing each factor by itself
+  using namespace noiseModel;
+  const auto sigmas = Diagonal::Sigmas(Vector3(0.1, 0.2, 0.05));
+  const auto huber =
+      Robust::Create(mEstimator::Huber::Create(1.345), sigmas);
+  const auto tukey = Robust::Create(
+      mEstimator::Tukey::Create(4.0, mEstimator::Base::Scalar), sigmas);
+  const auto cauchy = Robust::Create(mEstimator::Cauchy::Create(0.5), sigmas);
+
+  NonlinearFactorGraph graph;
+  Values values;
+  graph.addPrior(X(0), Pose2(), Isotropic::Sigma(3, 0.01));
+  for (size_t i = 0; i < 20; ++i) {
+    values.insert(X(i), Pose2(i + 0.3 * sin(i), 0.2 * cos(i), 0.1 * i));
+    const SharedNoiseModel model = i % 3 == 0 ? huber
+                                   : i % 3 == 1 ? tukey
+                                   : cauchy;
+    if (i > 0)
+      graph.emplace_shared<BetweenFactor<Pose2>>(X(i - 1), X(i),
+                                                 Pose2(1, 0, 0), model);
+    if (i > 1)  // some outliers
+      graph.emplace_shared<BetweenFactor<Pose2>>(
+          X(i - 2), X(i), Pose2(i % 4 ? 2 : 7, 0, 0), model);
+  }
+
+  const GaussianFactorGraph actual = *graph.linearize(values);
+  LONGS_EQUAL(graph.size(), actual.size());
+  for (size_t i = 0; i < graph.size(); ++i)
+    EXPECT(assert_equal(*graph[i]->linearize(values), *actual[i], 1e-9));
+}
+
+/* ************************************************************************* */
+namespace {
+// A robust factor with its own linearize(), which does not opt in to being
+// reweighted by the graph
+class DoubledPrior : public NoiseModelFactorN<Pose2> {
+  Pose2 prior_;
+
+ public:
+  DoubledPrior(Key key, const Pose2& prior, const SharedNoiseModel& model)
+      : NoiseModelFactorN<Pose2>(model, key), prior_(prior) {}
+
+  Vector evaluateError(const Pose2& x, OptionalMatrixType H) const override {
+    if (H) *H = I_3x3;
+    return -traits<Pose2>::Local(x, prior_);
+  }
+
+  std::shared_ptr<GaussianFactor> linearize(const Values& x) const override {
+    auto factor = std::static_pointer_cast<JacobianFactor>(
+        NoiseModelFactor::linearize(x));
+    factor->matrixObject().full() *= 2.0;
+    return factor;
+  }
+};
+}  // namespace
+
+TEST(NonlinearFactorGraph, linearizeRobustExpression)
+{
+  // Robust expression factors are reweighted together too, and factors that
+  // override linearize() without opting in are linearized by themselves
+  using namespace noiseModel;
+  const auto huber =
+      Robust::Create(mEstimator::Huber::Create(0.5), Isotropic::Sigma(1, 0.1));
+  const auto cauchy =
+      Robust::Create(mEstimator::Cauchy::Create(0.5), Isotropic::Sigma(3, 0.1));
+
+  NonlinearFactorGraph graph;
+  Values values;
+  for (size_t i = 0; i < 10; ++i) {
+    values.insert(X(i), Pose2(i, 0.1 * i, 0.2));
+    values.insert(L(i), Point2(i + 0.5, 2.0));
+    const double range = i % 3 ? 2.0 : 5.0;  // some outliers
+    graph.emplace_shared<RangeFactor<Pose2, Point2>>(X(i), L(i), range, huber);
+    graph.emplace_shared<DoubledPrior>(X(i), Pose2(i, 0, 0), cauchy);
+  }
+
+  const GaussianFactorGraph actual = *graph.linearize(values);
+  LONGS_EQUAL(graph.size(), actual.size());
+  for (size_t i = 0; i < graph.size(); ++i)
+    EXPECT(assert_equal(*graph[i]->linearize(values), *actual[i], 1e-9));
+}
+
 /* ************************************************************************* */
 TEST( NonlinearFactorGraph, clone )
 {
@@ -31,6 +31,10 @@
 
 #include <CppUnitLite/TestHarness.h>
 
+#ifdef GTSAM_USE_TBB
+#include <tbb/global_control.h>
+#include <tbb/task_arena.h>
+#endif
 
 #include <iostream>
 #include <fstream>
@@ -647,6 +651,55 @@ struct traits<MyType> {
 };
 }
 
+/* ************************************************************************* */
+#ifdef GTSAM_USE_TBB
+TEST(NonlinearOptimizer, ReproducibleAcrossThreadCounts) {
+  // Pose2 grid with loop closures, large enough for parallel linearization,
+  // elimination and error evaluation
+  const size_t n = 15;
+  auto key = [n](size_t i, size_t j) { return Symbol('x', i * n + j); };
+  const auto model = noiseModel::Isotropic::Sigma(3, 0.1);
+  NonlinearFactorGraph graph;
+  Values initial;
+  graph.addPrior(key(0, 0), Pose2(), model);
+  for (size_t i = 0; i < n; ++i) {
+    for (size_t j = 0; j < n; ++j) {
+      const double t = 0.1 * (i * n + j);
+      initial.insert(key(i, j), Pose2(i + 0.05 * sin(t), j + 0.05 * cos(t),
+                                      0.02 * sin(3 * t)));
+      if (i > 0)
+        graph.emplace_shared<BetweenFactor<Pose2>>(key(i - 1, j), key(i, j),
+                                                   Pose2(1, 0, 0), model);
+      if (j > 0)
+        graph.emplace_shared<BetweenFactor<Pose2>>(key(i, j - 1), key(i, j),
+                                                   Pose2(0, 1, 0), model);
+    }
+  }
+
+  LevenbergMarquardtParams params;
+  params.maxIterations = 5;
+  auto optimize = [&](int nrThreads) {
+    tbb::global_control control(
+        tbb::global_control::max_allowed_parallelism, nrThreads);
+    tbb::task_arena arena(nrThreads);
+    Values result;
+    arena.execute([&] {
+      result = LevenbergMarquardtOptimizer(graph, initial, params).optimize();
+    });
+    return result;
+  };
+
+  // Results are bitwise identical regardless of the number of threads
+  const Values expected = optimize(1);
+  for (int nrThreads : {2, 4}) {
+    const Values actual = optimize(nrThreads);
+    EXPECT(assert_equal(expected, actual, 0.0));
+    EXPECT(graph.error(expected) == graph.error(actual));
+  }
+}
+#endif
+
+/* ************************************************************************* */
 TEST(NonlinearOptimizer, Traits) {
   NonlinearFactorGraph fg;
   fg.addPrior(0, MyType(0, 0, 0), noiseModel::Isotropic::Sigma(3, 1));
@@ -19,6 +19,7 @@
 #include <tests/smallExample.h>
 #include <gtsam/nonlinear/LevenbergMarquardtOptimizer.h>
 #include <gtsam/linear/GaussianFactorGraph.h>
+#include <gtsam/linear/HessianFactor.h>
 #include <gtsam/linear/PCGSolver.h>
 #include <gtsam/linear/SubgraphPreconditioner.h>
 #include <gtsam/inference/Symbol.h>
@@ -120,6 +121,40 @@ TEST( GaussianFactorGraphSystem, multiply_getb)
   EXPECT(assert_equal(expectedb, actualb, 1e-3));
 }
 
+/* ************************************************************************* */
+// multiply works on the contiguous vector in keyInfo order, for any ordering
+// and for factors other than JacobianFactor
+TEST(GaussianFactorGraphSystem, multiplyOrdering) {
+  GaussianFactorGraph gfg = example::createGaussianFactorGraph();
+  gfg.emplace_shared<JacobianFactor>(
+      X(2), I_2x2, L(1), -I_2x2, Vector2(0.1, 0.2),
+      noiseModel::Diagonal::Sigmas(Vector2(0.5, 2.0)));
+  gfg.push_back(HessianFactor(JacobianFactor(
+      X(2), (Matrix(2, 2) << 1, 2, 3, 4).finished(), L(1),
+      (Matrix(2, 2) << 0, 1, -1, 2).finished(), Vector2(1, 1))));
+
+  DummyPreconditioner preconditioner;
+  const KeyInfo keyInfo(gfg, Ordering{L(1), X(1), X(2)});
+  const std::map<Key, Vector> lambda;
+  preconditioner.build(gfg, keyInfo, lambda);
+  const GaussianFactorGraphSystem system(gfg, preconditioner, keyInfo, lambda);
+
+  VectorValues x;
+  x.insert(X(1), Vector2(1, -2));
+  x.insert(X(2), Vector2(0.5, 3));
+  x.insert(L(1), Vector2(-1, 4));
+  VectorValues expected = keyInfo.x0();
+  gfg.multiplyHessianAdd(1.0, x, expected);
+
+  Vector actual;
+  system.multiply(x.vector(keyInfo.ordering()), actual);
+  EXPECT(assert_equal(expected.vector(keyInfo.ordering()), actual, 1e-9));
+  EXPECT(assert_equal(expected,
+                      ContiguousVectorValues(system.layout(), actual)
+                          .vectorValues(),
+                      1e-9));
+}
+
 /* ************************************************************************* */
 // Test Dummy Preconditioner
 TEST(PCGSolver, dummy) {
@@ -119,6 +119,63 @@ TEST( SubgraphSolver, constructor3 )
   DOUBLES_EQUAL(0.0, error(Ab, optimized), 1e-5);
 }
 
+/* ************************************************************************* */
+TEST( SubgraphSolver, shortestPathTree )
+{
+  // Build a planar graph
+  const auto [Ab, xtrue] = example::planarGraph(N); // A*x-b
+
+  SubgraphSolverParameters parameters;
+  parameters.builderParams.skeletonType =
+      SubgraphBuilderParameters::skeletonTranslator("SHORTEST_PATH");
+  parameters.builderParams.augmentationFactor = 0.0;
+  const auto subgraph = SubgraphBuilder(parameters.builderParams)(Ab);
+  EXPECT_LONGS_EQUAL(9, subgraph.size());
+
+  SubgraphSolver solver(Ab, parameters, kOrdering);
+  VectorValues optimized = solver.optimize();
+  DOUBLES_EQUAL(0.0, error(Ab, optimized), 1e-5);
+}
+
+/* ************************************************************************* */
+TEST( SubgraphSolver, subgraphCache )
+{
+  // Build a planar graph
+  const auto [Ab, xtrue] = example::planarGraph(N); // A*x-b
+
+  SubgraphBuilderParameters params;
+  params.skeletonWeight = SubgraphBuilderParameters::RHS_2NORM;
+  const SubgraphBuilder builder(params);
+  SubgraphCache cache;
+  EXPECT(cache.empty());
+  const auto subgraph = cache(Ab, builder);
+  EXPECT(!cache.empty());
+
+  // Same structure, different weights: the cached subgraph is returned
+  GaussianFactorGraph scaled;
+  size_t i = 0;
+  for (const auto& factor : Ab) {
+    auto jf = std::dynamic_pointer_cast<JacobianFactor>(factor->clone());
+    jf->getb() *= (i++ % 3) + 1.0;
+    scaled.push_back(jf);
+  }
+  EXPECT(subgraph.edgeIndices() == cache(scaled, builder).edgeIndices());
+
+  // A different structure invalidates the cache
+  const GaussianFactorGraph fewer(Ab.begin(), Ab.end() - 1);
+  EXPECT(builder(fewer).edgeIndices() == cache(fewer, builder).edgeIndices());
+
+  // The solver reuses the split when given a cache
+  SubgraphSolverParameters parameters(params);
+  parameters.subgraphCache = std::make_shared<SubgraphCache>();
+  for (size_t k = 0; k < 2; ++k) {
+    SubgraphSolver solver(Ab, parameters, kOrdering);
+    VectorValues optimized = solver.optimize();
+    DOUBLES_EQUAL(0.0, error(Ab, optimized), 1e-5);
+  }
+  EXPECT(!parameters.subgraphCache->empty());
+}
+
 /* ************************************************************************* */
 int main() { TestResult tr; return TestRegistry::runAllTests(tr); }
 /* ************************************************************************* */
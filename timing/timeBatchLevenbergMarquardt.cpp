@@ -0,0 +1,72 @@
+/* ----------------------------------------------------------------------------
+
+ * GTSAM Copyright 2010, Georgia Tech Research Corporation,
+ * Atlanta, Georgia 30332-0415
+ * All Rights Reserved
+ * Authors: Frank Dellaert, et al. (see THANKS for the full author list)
+
+ * See LICENSE for the license information
+
+ * -------------------------------------------------------------------------- */
+
+/**
+ * @file    timeBatchLevenbergMarquardt.cpp
+ * @brief   time BatchLevenbergMarquardtOptimizer against one
+ *          LevenbergMarquardtOptimizer per problem
+ * @date    October 2026
+ */
+
+#include <gtsam/base/timing.h>
+#include <gtsam/geometry/Pose2.h>
+#include <gtsam/inference/Symbol.h>
+#include <gtsam/nonlinear/BatchLevenbergMarquardtOptimizer.h>
+#include <gtsam/nonlinear/LevenbergMarquardtOptimizer.h>
+#include <gtsam/slam/BetweenFactor.h>
+
+#include <iostream>
+#include <vector>
+
+using namespace std;
+using namespace gtsam;
+using symbol_shorthand::X;
+
+int main() {
+  const size_t N = 2000;
+  cout << "NOTE:  Times are reported for " << N
+       << " pose graphs with 3 poses each" << endl;
+
+  auto noise = noiseModel::Diagonal::Sigmas(Vector3(0.1, 0.1, 0.05));
+  vector<NonlinearFactorGraph> graphs(N);
+  vector<Values> initials(N);
+  for (size_t i = 0; i < N; ++i) {
+    const double s = 1e-4 * i;
+    graphs[i].addPrior(X(0), Pose2(s, 0, 0), noise);
+    graphs[i].emplace_shared<BetweenFactor<Pose2>>(X(0), X(1),
+                                                   Pose2(1 + s, 0, 0.1), noise);
+    graphs[i].emplace_shared<BetweenFactor<Pose2>>(X(1), X(2),
+                                                   Pose2(1, s, 0.2), noise);
+    graphs[i].emplace_shared<BetweenFactor<Pose2>>(
+        X(0), X(2), Pose2(2, 0.3, 0.3 - s), noise);
+    initials[i].insert(X(0), Pose2(0.1, -0.1, 0.05));
+    initials[i].insert(X(1), Pose2(1.2, 0.1, 0.0));
+    initials[i].insert(X(2), Pose2(1.9, 0.5, 0.4));
+  }
+
+  LevenbergMarquardtParams params;
+  vector<Values> results(N);
+
+  gttic_(individual);
+  for (size_t i = 0; i < N; ++i)
+    results[i] =
+        LevenbergMarquardtOptimizer(graphs[i], initials[i], params).optimize();
+  gttoc_(individual);
+
+  gttic_(batch);
+  results = BatchLevenbergMarquardtOptimizer(params).optimize(graphs, initials);
+  gttoc_(batch);
+
+  // Print timings
+  tictoc_print_();
+
+  return 0;
+}
@@ -0,0 +1,81 @@
+/* ----------------------------------------------------------------------------
+
+ * GTSAM Copyright 2010, Georgia Tech Research Corporation,
+ * Atlanta, Georgia 30332-0415
+ * All Rights Reserved
+ * Authors: Frank Dellaert, et al. (see THANKS for the full author list)
+
+ * See LICENSE for the license information
+
+ * -------------------------------------------------------------------------- */
+
+/**
+ * @file    timeLieBatch.cpp
+ * @brief   time the batched SO(3)/SE(3) kernels against the scalar functions
+ * @date    October 2026
+ */
+
+#include <gtsam/base/timing.h>
+#include <gtsam/geometry/LieBatch.h>
+#include <gtsam/geometry/Pose3.h>
+
+#include <iostream>
+#include <vector>
+
+using namespace std;
+using namespace gtsam;
+
+/* ************************************************************************* */
+#define TEST(TITLE,STATEMENT) \
+  gttic_(TITLE); \
+  for(int i = 0; i < n; i++) \
+  STATEMENT; \
+  gttoc_(TITLE);
+
+int main()
+{
+  const int N = 1000, n = 2000;
+  cout << "NOTE:  Times are reported for " << n << " calls on " << N
+       << " poses" << endl;
+
+  vector<Pose3> poses;
+  vector<Vector6> twists;
+  batch::Vectors6 xi(N, 6);
+  batch::Matrices3 R0(N, 9), dR, R;
+  batch::Vectors3 t0(N, 3), dt, t;
+  for (int k = 0; k < N; ++k) {
+    Vector6 v;
+    v << 0.001 * k, 0.3, -0.002 * k, 1.0, 0.01 * k, -2.0;
+    poses.push_back(Pose3::Expmap(v));
+    twists.push_back(0.1 * v.reverse());
+    xi.row(k) = twists.back().transpose();
+    batch::SetMatrix3(&R0, k, poses.back().rotation().matrix());
+    t0.row(k) = poses.back().translation().transpose();
+  }
+
+  // Retraction with the exponential map, for all poses
+  vector<Pose3> results(N);
+  auto scalarRetract = [&]() {
+    for (int k = 0; k < N; ++k)
+      results[k] = poses[k].compose(Pose3::Expmap(twists[k]));
+  };
+  auto batchRetract = [&]() {
+    batch::ExpmapPose3(xi, &dR, &dt);
+    batch::ComposePose3(R0, t0, dR, dt, &R, &t);
+  };
+  TEST(scalar_retract, scalarRetract())
+  TEST(batch_retract, batchRetract())
+
+  // Logarithm map of all poses
+  batch::Vectors6 logs(N, 6);
+  auto scalarLogmap = [&]() {
+    for (int k = 0; k < N; ++k) logs.row(k) = Pose3::Logmap(poses[k]).transpose();
+  };
+  TEST(scalar_Logmap, scalarLogmap())
+  TEST(batch_Logmap, batch::LogmapPose3(R0, t0, &logs))
+
+  // Print timings
+  tictoc_print_();
+
+  return 0;
+}
@@ -0,0 +1,67 @@
+/* ----------------------------------------------------------------------------
+
+ * GTSAM Copyright 2010, Georgia Tech Research Corporation,
+ * Atlanta, Georgia 30332-0415
+ * All Rights Reserved
+ * Authors: Frank Dellaert, et al. (see THANKS for the full author list)
+
+ * See LICENSE for the license information
+
+ * -------------------------------------------------------------------------- */
+
+/**
+ * @file    timePCGSolver.cpp
+ * @brief   time the A'Ax product of PCG on contiguous vectors against the
+ *          product through VectorValues
+ * @date    October 2026
+ */
+
+#include <gtsam/base/timing.h>
+#include <gtsam/linear/PCGSolver.h>
+#include <gtsam/linear/Preconditioner.h>
+#include <tests/smallExample.h>
+
+#include <iostream>
+
+using namespace std;
+using namespace gtsam;
+
+/* ************************************************************************* */
+#define TEST(TITLE,STATEMENT) \
+  gttic_(TITLE); \
+  for(int i = 0; i < n; i++) \
+  STATEMENT; \
+  gttoc_(TITLE);
+
+int main()
+{
+  const size_t N = 100;
+  const int n = 50;
+  cout << "NOTE:  Times are reported for " << n << " products on a " << N
+       << "x" << N << " planar graph" << endl;
+
+  const GaussianFactorGraph gfg = example::planarGraph(N).first;
+  const KeyInfo keyInfo(gfg);
+  const std::map<Key, Vector> lambda;
+  DummyPreconditioner preconditioner;
+  preconditioner.build(gfg, keyInfo, lambda);
+  const GaussianFactorGraphSystem system(gfg, preconditioner, keyInfo, lambda);
+
+  const Vector x = Vector::Random(keyInfo.x0vector().size());
+  Vector AtAx;
+
+  // A'Ax through VectorValues, as multiply did before
+  auto vectorValuesMultiply = [&]() {
+    const VectorValues vvX = buildVectorValues(x, keyInfo);
+    VectorValues vvAtAx = keyInfo.x0();
+    gfg.multiplyHessianAdd(1.0, vvX, vvAtAx);
+    AtAx = vvAtAx.vector(keyInfo.ordering());
+  };
+  TEST(VectorValues_multiply, vectorValuesMultiply())
+  TEST(contiguous_multiply, system.multiply(x, AtAx))
+
+  // Print timings
+  tictoc_print_();
+
+  return 0;
+}